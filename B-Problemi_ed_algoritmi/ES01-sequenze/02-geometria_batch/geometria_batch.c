@@ -0,0 +1,240 @@
+/**
+ * @file geometria_batch.c
+ * @brief Calcolo con SSE/AVX e lettura dei file di figure con mmap
+ */
+#define _DEFAULT_SOURCE
+#include "geometria_batch.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// SSE c'e' su tutti i processori x86 a 64 bit; AVX viene scelto a runtime
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define GEOMETRIA_X86 1
+#endif
+
+static const char MAGIA[4] = {'G', 'E', 'O', '1'};
+
+/**
+ * Intestazione del file: 16 byte, cosi' i vettori che seguono sono allineati a 16.
+ */
+typedef struct {
+    char magia[4];
+    uint32_t tipo;
+    uint64_t n;
+} IntestazioneGeometria;
+
+//----------------------------------------------------------------------
+// Calcolo
+//----------------------------------------------------------------------
+
+// Le formule di rettangolo.c e const.c, nello stesso ordine di operazioni delle versioni SIMD
+static void rettangoliScalare(const float basi[], const float altezze[], float perimetri[], float aree[],
+                              size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (perimetri != NULL) {
+            perimetri[i] = basi[i] * 2 + altezze[i] * 2;
+        }
+        if (aree != NULL) {
+            aree[i] = basi[i] * altezze[i];
+        }
+    }
+}
+
+// Come in const.c il calcolo e' in double (PI e' un double) e solo il risultato torna float
+static void cerchiScalare(const float raggi[], float circonferenze[], float aree[], size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (circonferenze != NULL) {
+            circonferenze[i] = (float)(2 * GEOMETRIA_PI * raggi[i]);
+        }
+        if (aree != NULL) {
+            aree[i] = (float)(GEOMETRIA_PI * raggi[i] * raggi[i]);
+        }
+    }
+}
+
+#ifdef GEOMETRIA_X86
+
+static void rettangoliSse(const float basi[], const float altezze[], float perimetri[], float aree[], size_t n) {
+    __m128 due = _mm_set1_ps(2);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 b = _mm_loadu_ps(&basi[i]);
+        __m128 h = _mm_loadu_ps(&altezze[i]);
+        if (perimetri != NULL) {
+            _mm_storeu_ps(&perimetri[i], _mm_add_ps(_mm_mul_ps(b, due), _mm_mul_ps(h, due)));
+        }
+        if (aree != NULL) {
+            _mm_storeu_ps(&aree[i], _mm_mul_ps(b, h));
+        }
+    }
+    rettangoliScalare(basi + i, altezze + i, perimetri ? perimetri + i : NULL, aree ? aree + i : NULL, n - i);
+}
+
+__attribute__((target("avx"))) static void rettangoliAvx(const float basi[], const float altezze[],
+                                                         float perimetri[], float aree[], size_t n) {
+    __m256 due = _mm256_set1_ps(2);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 b = _mm256_loadu_ps(&basi[i]);
+        __m256 h = _mm256_loadu_ps(&altezze[i]);
+        if (perimetri != NULL) {
+            _mm256_storeu_ps(&perimetri[i], _mm256_add_ps(_mm256_mul_ps(b, due), _mm256_mul_ps(h, due)));
+        }
+        if (aree != NULL) {
+            _mm256_storeu_ps(&aree[i], _mm256_mul_ps(b, h));
+        }
+    }
+    rettangoliSse(basi + i, altezze + i, perimetri ? perimetri + i : NULL, aree ? aree + i : NULL, n - i);
+}
+
+// I cerchi si calcolano in double come in cerchiScalare: 2 (SSE) o 4 (AVX) raggi per istruzione
+
+// Due raggi convertiti in double: circonferenze e aree in c e a (due float ciascuno, nella meta' bassa)
+static void cerchiSse2(__m128 raggi, __m128 *c, __m128 *a) {
+    __m128d r = _mm_cvtps_pd(raggi);
+    *c = _mm_cvtpd_ps(_mm_mul_pd(_mm_set1_pd(2 * GEOMETRIA_PI), r));
+    *a = _mm_cvtpd_ps(_mm_mul_pd(_mm_mul_pd(_mm_set1_pd(GEOMETRIA_PI), r), r));
+}
+
+static void cerchiSse(const float raggi[], float circonferenze[], float aree[], size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 r = _mm_loadu_ps(&raggi[i]);
+        __m128 cBassa, aBassa, cAlta, aAlta;
+        cerchiSse2(r, &cBassa, &aBassa);
+        cerchiSse2(_mm_movehl_ps(r, r), &cAlta, &aAlta);
+        if (circonferenze != NULL) {
+            _mm_storeu_ps(&circonferenze[i], _mm_movelh_ps(cBassa, cAlta));
+        }
+        if (aree != NULL) {
+            _mm_storeu_ps(&aree[i], _mm_movelh_ps(aBassa, aAlta));
+        }
+    }
+    cerchiScalare(raggi + i, circonferenze ? circonferenze + i : NULL, aree ? aree + i : NULL, n - i);
+}
+
+__attribute__((target("avx"))) static void cerchiAvx(const float raggi[], float circonferenze[], float aree[],
+                                                     size_t n) {
+    __m256d pi = _mm256_set1_pd(GEOMETRIA_PI);
+    __m256d duePi = _mm256_set1_pd(2 * GEOMETRIA_PI);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d r = _mm256_cvtps_pd(_mm_loadu_ps(&raggi[i]));
+        if (circonferenze != NULL) {
+            _mm_storeu_ps(&circonferenze[i], _mm256_cvtpd_ps(_mm256_mul_pd(duePi, r)));
+        }
+        if (aree != NULL) {
+            _mm_storeu_ps(&aree[i], _mm256_cvtpd_ps(_mm256_mul_pd(_mm256_mul_pd(pi, r), r)));
+        }
+    }
+    cerchiSse(raggi + i, circonferenze ? circonferenze + i : NULL, aree ? aree + i : NULL, n - i);
+}
+
+#endif // GEOMETRIA_X86
+
+void rettangoliCalcola(const float basi[], const float altezze[], float perimetri[], float aree[], size_t n) {
+#ifdef GEOMETRIA_X86
+    if (__builtin_cpu_supports("avx")) {
+        rettangoliAvx(basi, altezze, perimetri, aree, n);
+    } else {
+        rettangoliSse(basi, altezze, perimetri, aree, n);
+    }
+#else
+    rettangoliScalare(basi, altezze, perimetri, aree, n);
+#endif
+}
+
+void cerchiCalcola(const float raggi[], float circonferenze[], float aree[], size_t n) {
+#ifdef GEOMETRIA_X86
+    if (__builtin_cpu_supports("avx")) {
+        cerchiAvx(raggi, circonferenze, aree, n);
+    } else {
+        cerchiSse(raggi, circonferenze, aree, n);
+    }
+#else
+    cerchiScalare(raggi, circonferenze, aree, n);
+#endif
+}
+
+//----------------------------------------------------------------------
+// File
+//----------------------------------------------------------------------
+
+static size_t numeroVettori(uint32_t tipo) {
+    return tipo == GEOMETRIA_CERCHI ? 1 : 2;
+}
+
+int geometriaScrivi(const char *percorso, TipoGeometria tipo, const float primo[], const float secondo[], size_t n) {
+    FILE *file = fopen(percorso, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+    IntestazioneGeometria intestazione;
+    memcpy(intestazione.magia, MAGIA, sizeof(MAGIA));
+    intestazione.tipo = tipo;
+    intestazione.n = n;
+    int ok = fwrite(&intestazione, sizeof(intestazione), 1, file) == 1 && fwrite(primo, sizeof(float), n, file) == n;
+    if (ok && numeroVettori(tipo) == 2) {
+        ok = fwrite(secondo, sizeof(float), n, file) == n;
+    }
+    if (fclose(file) != 0) {
+        ok = 0;
+    }
+    return ok ? 0 : -1;
+}
+
+int geometriaApri(const char *percorso, FileGeometria *f) {
+    int fd = open(percorso, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(IntestazioneGeometria)) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    size_t byte = (size_t)info.st_size;
+    void *mappa = mmap(NULL, byte, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // la mappatura resta valida anche dopo la chiusura
+    if (mappa == MAP_FAILED) {
+        return -1;
+    }
+
+    const IntestazioneGeometria *intestazione = mappa;
+    uint32_t tipo = intestazione->tipo;
+    uint64_t n = intestazione->n;
+    int valido = memcmp(intestazione->magia, MAGIA, sizeof(MAGIA)) == 0 && tipo >= GEOMETRIA_RETTANGOLI &&
+                 tipo <= GEOMETRIA_RISULTATI &&
+                 n <= (byte - sizeof(IntestazioneGeometria)) / sizeof(float) / numeroVettori(tipo) &&
+                 byte == sizeof(IntestazioneGeometria) + n * sizeof(float) * numeroVettori(tipo);
+    if (!valido) {
+        munmap(mappa, byte);
+        errno = EINVAL;
+        return -1;
+    }
+    // Il file verra' letto tutto una volta dall'inizio alla fine
+    madvise(mappa, byte, MADV_SEQUENTIAL);
+
+    f->tipo = (TipoGeometria)tipo;
+    f->n = (size_t)n;
+    f->primo = (const float *)(intestazione + 1);
+    f->secondo = numeroVettori(tipo) == 2 ? f->primo + n : NULL;
+    f->mappa = mappa;
+    f->byteMappa = byte;
+    return 0;
+}
+
+void geometriaChiudi(FileGeometria *f) {
+    if (f->mappa != NULL) {
+        munmap(f->mappa, f->byteMappa);
+        f->mappa = NULL;
+    }
+}
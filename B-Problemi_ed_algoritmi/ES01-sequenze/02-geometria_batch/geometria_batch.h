@@ -0,0 +1,94 @@
+/**
+ * @file geometria_batch.h
+ * @brief Perimetri e aree di milioni di rettangoli e cerchi con una sola chiamata
+ *
+ * rettangolo.c (e const.c per il cerchio) legge una figura con scanf, calcola e
+ * stampa: per milioni di figure quasi tutto il tempo va nella conversione del
+ * testo e nelle printf. Qui le figure sono in vettori separati, uno per
+ * grandezza (basi[], altezze[], raggi[]: "struttura di vettori" invece di un
+ * vettore di struct), cosi' 4 (SSE) o 8 (AVX) valori consecutivi si caricano
+ * con una sola istruzione e si elaborano insieme.
+ *
+ * I dati si leggono da un file binario con mmap(), senza conversioni:
+ *   intestazione (16 byte) | primo vettore (n float) | secondo vettore (n float)
+ * I cerchi hanno solo il primo vettore (i raggi). Lo stesso formato serve per
+ * salvare i risultati (perimetri e aree).
+ *
+ * I risultati sono identici, bit per bit, a quelli del calcolo un elemento alla
+ * volta con le formule di rettangolo.c (in float) e di const.c (PI * raggio *
+ * raggio in double, con PI 3.14159, arrotondato a float).
+ */
+#ifndef GEOMETRIA_BATCH_H
+#define GEOMETRIA_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Lo stesso valore (double) della #define PI di const.c
+#define GEOMETRIA_PI 3.14159
+
+/**
+ * Contenuto di un file di figure.
+ */
+typedef enum {
+    GEOMETRIA_RETTANGOLI = 1,   // basi, altezze
+    GEOMETRIA_CERCHI = 2,       // raggi
+    GEOMETRIA_RISULTATI = 3     // perimetri (o circonferenze), aree
+} TipoGeometria;
+
+/**
+ * File di figure aperto con geometriaApri(): i vettori puntano nel file mappato.
+ */
+typedef struct {
+    TipoGeometria tipo;
+    size_t n;
+    const float *primo;     // basi, raggi o perimetri
+    const float *secondo;   // altezze o aree; NULL per i cerchi
+    void *mappa;
+    size_t byteMappa;
+} FileGeometria;
+
+/**
+ * Calcola perimetro e area di n rettangoli.
+ * @param basi le basi
+ * @param altezze le altezze
+ * @param perimetri dove scrivere i perimetri (NULL se non servono)
+ * @param aree dove scrivere le aree (NULL se non servono)
+ * @param n il numero di rettangoli
+ */
+void rettangoliCalcola(const float basi[], const float altezze[], float perimetri[], float aree[], size_t n);
+
+/**
+ * Calcola circonferenza e area di n cerchi.
+ * @param raggi i raggi
+ * @param circonferenze dove scrivere le circonferenze (NULL se non servono)
+ * @param aree dove scrivere le aree (NULL se non servono)
+ * @param n il numero di cerchi
+ */
+void cerchiCalcola(const float raggi[], float circonferenze[], float aree[], size_t n);
+
+/**
+ * Scrive un file di figure.
+ * @param percorso il nome del file
+ * @param tipo il contenuto
+ * @param primo il primo vettore
+ * @param secondo il secondo vettore (ignorato per GEOMETRIA_CERCHI)
+ * @param n il numero di elementi di ciascun vettore
+ * @return 0 se il file e' stato scritto, -1 in caso di errore (errno indica la causa)
+ */
+int geometriaScrivi(const char *percorso, TipoGeometria tipo, const float primo[], const float secondo[], size_t n);
+
+/**
+ * Apre un file di figure mappandolo in memoria (sola lettura).
+ * @param percorso il nome del file
+ * @param f il file aperto
+ * @return 0 se il file e' stato aperto, -1 se non esiste o non e' valido
+ */
+int geometriaApri(const char *percorso, FileGeometria *f);
+
+/**
+ * Chiude un file aperto con geometriaApri().
+ */
+void geometriaChiudi(FileGeometria *f);
+
+#endif // GEOMETRIA_BATCH_H
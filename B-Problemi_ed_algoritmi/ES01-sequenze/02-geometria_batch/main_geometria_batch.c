@@ -0,0 +1,217 @@
+/**
+ * @file main_geometria_batch.c
+ * @brief Perimetri e aree di milioni di figure lette da file binario
+ *
+ * Utilizzo:
+ *   ./main_geometria_batch genera rettangoli|cerchi N figure.bin   crea un file di N figure casuali
+ *   ./main_geometria_batch figure.bin [risultati.bin]             calcola (e salva) perimetri e aree
+ *   ./main_geometria_batch prova [N]                              confronto con il ciclo di rettangolo.c
+ *
+ * La prova misura, per N rettangoli:
+ *  - il ciclo di rettangolo.c: fscanf di base e altezza, calcolo, fprintf del risultato;
+ *  - il calcolo un rettangolo alla volta sui vettori;
+ *  - rettangoliCalcola() (SSE/AVX);
+ *  - la lettura dal file binario con mmap e il calcolo.
+ * e controlla che tutti diano gli stessi risultati. Controlla anche che
+ * cerchiCalcola() dia gli stessi risultati della formula di const.c.
+ *
+ * Compilazione:
+ *   gcc -O2 -std=c11 main_geometria_batch.c geometria_batch.c -o main_geometria_batch
+ */
+#define _POSIX_C_SOURCE 199309L   // clock_gettime con -std=c11
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "geometria_batch.h"
+
+static double secondi(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Misura casuale tra 0.01 e 100 con due cifre decimali, come quelle scritte a mano
+static float misuraCasuale(void) {
+    return (float)(1 + rand() % 10000) / 100.0f;
+}
+
+static int genera(const char *tipo, size_t n, const char *percorso) {
+    float *primo = malloc(n * sizeof(float));
+    float *secondo = malloc(n * sizeof(float));
+    for (size_t i = 0; i < n; i++) {
+        primo[i] = misuraCasuale();
+        secondo[i] = misuraCasuale();
+    }
+    TipoGeometria t = strcmp(tipo, "cerchi") == 0 ? GEOMETRIA_CERCHI : GEOMETRIA_RETTANGOLI;
+    int esito = geometriaScrivi(percorso, t, primo, secondo, n);
+    if (esito != 0) {
+        perror(percorso);
+    }
+    free(primo);
+    free(secondo);
+    return esito != 0;
+}
+
+static int calcola(const char *percorso, const char *percorsoRisultati) {
+    FileGeometria f;
+    double t0 = secondi();
+    if (geometriaApri(percorso, &f) != 0) {
+        perror(percorso);
+        return 1;
+    }
+    if (f.tipo == GEOMETRIA_RISULTATI) {
+        printf("%s contiene gia' dei risultati\n", percorso);
+        geometriaChiudi(&f);
+        return 1;
+    }
+    float *perimetri = malloc(f.n * sizeof(float));
+    float *aree = malloc(f.n * sizeof(float));
+    if (f.tipo == GEOMETRIA_RETTANGOLI) {
+        rettangoliCalcola(f.primo, f.secondo, perimetri, aree, f.n);
+    } else {
+        cerchiCalcola(f.primo, perimetri, aree, f.n);
+    }
+    double tCalcolo = secondi() - t0;
+
+    double sommaAree = 0;
+    for (size_t i = 0; i < f.n; i++) {
+        sommaAree += aree[i];
+    }
+    printf("%zu %s in %.1f ms (%.2f ns per figura), somma delle aree %.2f\n", f.n,
+           f.tipo == GEOMETRIA_RETTANGOLI ? "rettangoli" : "cerchi", tCalcolo * 1e3, tCalcolo / f.n * 1e9, sommaAree);
+    for (size_t i = 0; i < f.n && i < 3; i++) {
+        printf("  %s = %f  Area = %f\n", f.tipo == GEOMETRIA_RETTANGOLI ? "Perimetro" : "Circonferenza",
+               perimetri[i], aree[i]);
+    }
+    int esito = 0;
+    if (percorsoRisultati != NULL && geometriaScrivi(percorsoRisultati, GEOMETRIA_RISULTATI, perimetri, aree, f.n)) {
+        perror(percorsoRisultati);
+        esito = 1;
+    }
+    free(perimetri);
+    free(aree);
+    geometriaChiudi(&f);
+    return esito;
+}
+
+static int prova(size_t n) {
+    float *basi = malloc(n * sizeof(float));
+    float *altezze = malloc(n * sizeof(float));
+    float *perimetri = malloc(n * sizeof(float));
+    float *aree = malloc(n * sizeof(float));
+    float *perimetriRif = malloc(n * sizeof(float));
+    float *areeRif = malloc(n * sizeof(float));
+    for (size_t i = 0; i < n; i++) {
+        basi[i] = misuraCasuale();
+        altezze[i] = misuraCasuale();
+    }
+    // Pagine dei risultati gia' assegnate, per non misurare i page fault della prima scrittura
+    memset(perimetri, 0, n * sizeof(float));
+    memset(aree, 0, n * sizeof(float));
+    memset(perimetriRif, 0, n * sizeof(float));
+    memset(areeRif, 0, n * sizeof(float));
+    int errori = 0;
+
+    // 1. Il ciclo di rettangolo.c su un file di testo, uscita su /dev/null
+    FILE *testo = tmpfile();
+    for (size_t i = 0; i < n; i++) {
+        fprintf(testo, "%.2f\n%.2f\n", basi[i], altezze[i]);
+    }
+    rewind(testo);
+    FILE *nulla = fopen("/dev/null", "w");
+    double t0 = secondi();
+    float base, altezza;
+    size_t letti = 0;
+    while (fscanf(testo, "%f", &base) == 1 && fscanf(testo, "%f", &altezza) == 1) {
+        float perimetro = base * 2 + altezza * 2;
+        float area = base * altezza;
+        fprintf(nulla, "Perimetro = %f\n", perimetro);
+        fprintf(nulla, "Area = %f\n", area);
+        errori += perimetro != basi[letti] * 2 + altezze[letti] * 2;
+        letti++;
+    }
+    double tTesto = secondi() - t0;
+    fclose(testo);
+    fclose(nulla);
+    errori += letti != n;
+
+    // 2. Un rettangolo alla volta sui vettori (volatile: il compilatore non vettorizza)
+    t0 = secondi();
+    for (volatile size_t i = 0; i < n; i++) {
+        perimetriRif[i] = basi[i] * 2 + altezze[i] * 2;
+        areeRif[i] = basi[i] * altezze[i];
+    }
+    double tScalare = secondi() - t0;
+
+    // 3. Tutti insieme
+    t0 = secondi();
+    rettangoliCalcola(basi, altezze, perimetri, aree, n);
+    double tBatch = secondi() - t0;
+    errori += memcmp(perimetri, perimetriRif, n * sizeof(float)) != 0 || memcmp(aree, areeRif, n * sizeof(float)) != 0;
+
+    // 4. Dal file binario (la prima lettura dopo la scrittura e' dalla cache del sistema operativo)
+    const char *percorso = "prova_geometria.bin";
+    double tFile = 0;
+    if (geometriaScrivi(percorso, GEOMETRIA_RETTANGOLI, basi, altezze, n) == 0) {
+        FileGeometria f;
+        t0 = secondi();
+        if (geometriaApri(percorso, &f) == 0) {
+            rettangoliCalcola(f.primo, f.secondo, perimetri, aree, f.n);
+            tFile = secondi() - t0;
+            errori += f.n != n || memcmp(aree, areeRif, n * sizeof(float)) != 0;
+            geometriaChiudi(&f);
+        }
+        remove(percorso);
+    }
+
+    // Cerchi (le basi come raggi): la formula di const.c, un cerchio alla volta
+    for (size_t i = 0; i < n; i++) {
+        float raggio = basi[i];
+        perimetriRif[i] = 2 * GEOMETRIA_PI * raggio;
+        areeRif[i] = GEOMETRIA_PI * raggio * raggio;
+    }
+    cerchiCalcola(basi, perimetri, aree, n);
+    errori += memcmp(perimetri, perimetriRif, n * sizeof(float)) != 0 || memcmp(aree, areeRif, n * sizeof(float)) != 0;
+
+    printf("%zu rettangoli (ns per rettangolo)\n", n);
+    printf("  testo: fscanf, calcolo, fprintf   %8.2f\n", tTesto / n * 1e9);
+    printf("  vettori, uno alla volta           %8.2f\n", tScalare / n * 1e9);
+    printf("  rettangoliCalcola (%s)           %8.2f\n",
+#if defined(__SSE2__)
+           __builtin_cpu_supports("avx") ? "AVX" : "SSE",
+#else
+           "---",
+#endif
+           tBatch / n * 1e9);
+    printf("  file binario con mmap + calcolo   %8.2f\n", tFile / n * 1e9);
+    if (errori) {
+        printf("ERRORE: risultati diversi\n");
+    }
+
+    free(basi);
+    free(altezze);
+    free(perimetri);
+    free(aree);
+    free(perimetriRif);
+    free(areeRif);
+    return errori != 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 5 && strcmp(argv[1], "genera") == 0) {
+        return genera(argv[2], strtoul(argv[3], NULL, 10), argv[4]);
+    }
+    if (argc >= 2 && strcmp(argv[1], "prova") == 0) {
+        return prova(argc > 2 ? strtoul(argv[2], NULL, 10) : 2000000);
+    }
+    if (argc >= 2) {
+        return calcola(argv[1], argc > 2 ? argv[2] : NULL);
+    }
+    printf("Utilizzo:\n");
+    printf("  %s genera rettangoli|cerchi N figure.bin\n", argv[0]);
+    printf("  %s figure.bin [risultati.bin]\n", argv[0]);
+    printf("  %s prova [N]\n", argv[0]);
+    return 1;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file main_somma_stream.c
+ * @brief Somma di tutti i numeri interi di uno o piu' file (o dello standard input)
+ *
+ * Utilizzo:
+ *   ./main_somma_stream [-b] [-t thread] [file...]   somma i numeri (testo, o binario con -b)
+ *   ./main_somma_stream -g N [-b] > numeri.txt       scrive N numeri casuali per le prove
+ *   ./main_somma_stream -p                           controlla le somme di alcuni testi difficili
+ *
+ * Esempi:
+ *   ./main_somma_stream -g 100000000 > numeri.txt
+ *   ./main_somma_stream -t 4 numeri.txt
+ *   seq 1 1000000 | ./main_somma_stream
+ *
+ * Stampa la somma esatta e il numero di numeri sommati; su stderr la velocita'.
+ *
+ * Compilazione:
+ *   gcc -O2 -std=c11 -pthread main_somma_stream.c somma_stream.c -o main_somma_stream
+ */
+#define _DEFAULT_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "somma_stream.h"
+
+static double secondi(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t statoCasuale = 88172645463325252ull;
+static uint64_t casuale(void) {
+    statoCasuale ^= statoCasuale << 13;
+    statoCasuale ^= statoCasuale >> 7;
+    statoCasuale ^= statoCasuale << 17;
+    return statoCasuale;
+}
+
+// Numeri di lunghezza varia (da 1 a 19 cifre), un terzo negativi
+static int genera(uint64_t n, FormatoSomma formato) {
+    SommaInteri attesa;
+    sommaInizia(&attesa);
+    for (uint64_t i = 0; i < n; i++) {
+        uint64_t r = casuale();
+        int64_t v = (int64_t)((r >> 1) >> (r % 63));
+        if (r % 3 == 0) {
+            v = -v;
+        }
+        if (formato == SOMMA_BINARIO) {
+            fwrite(&v, sizeof(v), 1, stdout);
+        } else {
+            printf("%lld\n", (long long)v);
+        }
+        attesa.somma += v;
+    }
+    char testo[41];
+    fprintf(stderr, "somma attesa = %s\n", sommaInTesto(attesa.somma, testo));
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// Prova
+//----------------------------------------------------------------------
+
+/**
+ * Testo di prova con la somma attesa
+ */
+typedef struct {
+    const char *nome;
+    char *testo;
+    size_t n;
+    SommaInteri attesa;
+} Prova;
+
+/**
+ * Testo da scrivere in una pipe
+ */
+typedef struct {
+    int fd;
+    const char *testo;
+    size_t n;
+} Scrittore;
+
+// Scrive nella pipe a pezzi di 1000 byte, come un programma che produce i numeri poco alla volta
+static void *scriviPipe(void *argomento) {
+    Scrittore *w = argomento;
+    for (size_t i = 0; i < w->n;) {
+        size_t pezzo = w->n - i < 1000 ? w->n - i : 1000;
+        ssize_t scritti = write(w->fd, w->testo + i, pezzo);
+        if (scritti <= 0) {
+            break;
+        }
+        i += (size_t)scritti;
+    }
+    close(w->fd);
+    return NULL;
+}
+
+static int controlla(const Prova *p, const char *modo, const SommaInteri *s) {
+    int ok = s->somma == p->attesa.somma && s->numeri == p->attesa.numeri &&
+             s->troppoGrandi == p->attesa.troppoGrandi;
+    char testo[41], atteso[41];
+    printf("%-32s %-14s %s (%s, %llu numeri, %llu troppo grandi", p->nome, modo, ok ? "ok     " : "ERRORE ",
+           sommaInTesto(s->somma, testo), (unsigned long long)s->numeri, (unsigned long long)s->troppoGrandi);
+    if (!ok) {
+        printf("; attesi %s, %llu, %llu", sommaInTesto(p->attesa.somma, atteso),
+               (unsigned long long)p->attesa.numeri, (unsigned long long)p->attesa.troppoGrandi);
+    }
+    printf(")\n");
+    return !ok;
+}
+
+// Aggiunge a p il testo "-v" (o "v" per il primo numero) e lo conta nella somma attesa
+static void aggiungiNegativo(Prova *p, uint64_t v) {
+    p->n += (size_t)sprintf(p->testo + p->n, p->n == 0 ? "%llu" : "-%llu", (unsigned long long)v);
+    p->attesa.somma += p->attesa.numeri == 0 ? (__int128)v : -(__int128)v;
+    p->attesa.numeri++;
+}
+
+/**
+ * Somma testi scelti per mettere in difficolta' la divisione in blocchi:
+ * numeri separati solo da '-' (nessun altro separatore in tutto il blocco) e
+ * sequenze di cifre che riempiono un blocco di 64 byte. Ogni testo viene
+ * letto da file, da file diviso tra 4 thread (anche se e' piccolo: i confini
+ * tra le parti cadono in punti diversi del testo) e da una pipe scritta a pezzi.
+ * @return il numero di somme sbagliate
+ */
+static int prova(void) {
+    Prova prove[3];
+    memset(prove, 0, sizeof(prove));
+
+    // "1-1-1-...-1": il primo numero e' 1, gli altri -1
+    prove[0].nome = "1-1-...-1 (1500001 numeri)";
+    prove[0].testo = malloc(3000002);
+    for (int i = 0; i <= 1500000; i++) {
+        aggiungiNegativo(&prove[0], 1);
+    }
+
+    // Numeri di 1-19 cifre separati da '-': 20 MB, abbastanza per dividerli tra 4 thread
+    prove[1].nome = "numeri casuali separati da '-'";
+    prove[1].testo = malloc(2000000 * 21);
+    for (int i = 0; i < 2000000; i++) {
+        uint64_t r = casuale();
+        aggiungiNegativo(&prove[1], (r >> 1) >> (r % 63) | 1);
+    }
+
+    // 64 cifre all'inizio del primo blocco di 64 byte, poi numeri normali e altre 100 cifre
+    prove[2].nome = "sequenze di 64 e 100 cifre";
+    prove[2].testo = malloc(200);
+    memset(prove[2].testo, '1', 64);
+    memcpy(prove[2].testo + 64, " 5 -7 ", 6);
+    memset(prove[2].testo + 70, '2', 100);
+    memcpy(prove[2].testo + 170, "\n", 2);
+    prove[2].n = 171;
+    prove[2].attesa.somma = -2;
+    prove[2].attesa.numeri = 2;
+    prove[2].attesa.troppoGrandi = 2;
+
+    int errori = 0;
+    const char *percorso = "prova_somma.txt";
+    for (int i = 0; i < 3; i++) {
+        Prova *p = &prove[i];
+        FILE *file = fopen(percorso, "wb");
+        if (file == NULL || fwrite(p->testo, 1, p->n, file) != p->n || fclose(file) != 0) {
+            perror(percorso);
+            return 1;
+        }
+        for (int thread = 1; thread <= 4; thread += 3) {
+            SommaInteri s;
+            sommaInizia(&s);
+            // 1 byte per thread: il file viene diviso qualunque sia la sua dimensione
+            if (sommaFileDiviso(percorso, SOMMA_TESTO, thread, 1, &s) != 0) {
+                perror(percorso);
+            }
+            errori += controlla(p, thread == 1 ? "file" : "file, 4 parti", &s);
+        }
+
+        int estremi[2];
+        if (pipe(estremi) == 0) {
+            Scrittore w = {estremi[1], p->testo, p->n};
+            pthread_t scrittore;
+            pthread_create(&scrittore, NULL, scriviPipe, &w);
+            SommaInteri s;
+            sommaInizia(&s);
+            if (sommaDescrittore(estremi[0], SOMMA_TESTO, &s) != 0) {
+                perror("pipe");
+            }
+            pthread_join(scrittore, NULL);
+            close(estremi[0]);
+            errori += controlla(p, "pipe", &s);
+        }
+        free(p->testo);
+    }
+    remove(percorso);
+    return errori != 0;
+}
+
+int main(int argc, char *argv[]) {
+    FormatoSomma formato = SOMMA_TESTO;
+    int thread = 1;
+    long long daGenerare = -1;
+    int opzione;
+    while ((opzione = getopt(argc, argv, "bt:g:p")) != -1) {
+        switch (opzione) {
+        case 'b':
+            formato = SOMMA_BINARIO;
+            break;
+        case 't':
+            thread = atoi(optarg);
+            break;
+        case 'g':
+            daGenerare = atoll(optarg);
+            break;
+        case 'p':
+            return prova();
+        default:
+            fprintf(stderr, "Utilizzo: %s [-b] [-t thread] [file...]\n", argv[0]);
+            fprintf(stderr, "          %s -g N [-b]\n", argv[0]);
+            fprintf(stderr, "          %s -p\n", argv[0]);
+            return 2;
+        }
+    }
+    if (daGenerare >= 0) {
+        return genera((uint64_t)daGenerare, formato);
+    }
+
+    SommaInteri s;
+    sommaInizia(&s);
+    double byte = 0;
+    int esito = 0;
+    double t0 = secondi();
+    if (optind == argc) {
+        if (sommaDescrittore(0, formato, &s) != 0) {
+            perror("stdin");
+            esito = 1;
+        }
+    }
+    for (int i = optind; i < argc; i++) {
+        struct stat info;
+        if (stat(argv[i], &info) == 0) {
+            byte += info.st_size;
+        }
+        if (sommaFile(argv[i], formato, thread, &s) != 0) {
+            perror(argv[i]);
+            esito = 1;
+        }
+    }
+    double t = secondi() - t0;
+
+    char testo[41];
+    printf("%s\n", sommaInTesto(s.somma, testo));
+    fprintf(stderr, "%llu numeri", (unsigned long long)s.numeri);
+    if (s.troppoGrandi > 0) {
+        fprintf(stderr, ", %llu troppo grandi (non sommati)", (unsigned long long)s.troppoGrandi);
+    }
+    if (byte > 0) {
+        fprintf(stderr, ", %.0f MB in %.3f s: %.2f GB/s", byte / 1e6, t, byte / t / 1e9);
+    }
+    fprintf(stderr, "\n");
+    return esito;
+}
@@ -0,0 +1,442 @@
+/**
+ * @file somma_stream.c
+ * @brief Conversione delle cifre con SSE2/SWAR, lettura a blocchi e divisione dei file tra thread
+ */
+#define _DEFAULT_SOURCE
+#include "somma_stream.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// SSE2 c'e' su tutti i processori x86 a 64 bit
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SOMMA_SSE2 1
+#endif
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "la conversione di 8 cifre alla volta presuppone un processore little endian"
+#endif
+
+#define BLOCCO (1 << 20)   // byte letti con una read()
+#define CIFRE_MAX 19       // 10^19 - 1 sta ancora in 64 bit senza segno
+#define RESTO_MAX 64       // oltre, un blocco fatto solo di cifre e' sicuramente un numero troppo grande
+
+static inline int eCifra(char c) {
+    return (unsigned char)(c - '0') < 10;
+}
+
+// Maschera a 16 bit: il bit i vale 1 se p[i] e' una cifra
+static inline unsigned mascheraCifre(const char *p) {
+#ifdef SOMMA_SSE2
+    __m128i v = _mm_loadu_si128((const __m128i *)p);
+    __m128i cifre = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+    return (unsigned)_mm_movemask_epi8(cifre);
+#else
+    unsigned m = 0;
+    for (int i = 0; i < 16; i++) {
+        m |= (unsigned)eCifra(p[i]) << i;
+    }
+    return m;
+#endif
+}
+
+// Maschera a 16 bit dei caratteri '-'
+static inline unsigned mascheraMeno(const char *p) {
+#ifdef SOMMA_SSE2
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), _mm_set1_epi8('-')));
+#else
+    unsigned m = 0;
+    for (int i = 0; i < 16; i++) {
+        m |= (unsigned)(p[i] == '-') << i;
+    }
+    return m;
+#endif
+}
+
+static inline uint64_t mascheraMeno64(const char *p) {
+    return (uint64_t)mascheraMeno(p) | (uint64_t)mascheraMeno(p + 16) << 16 | (uint64_t)mascheraMeno(p + 32) << 32 |
+           (uint64_t)mascheraMeno(p + 48) << 48;
+}
+
+static inline uint64_t mascheraCifre64(const char *p) {
+    return (uint64_t)mascheraCifre(p) | (uint64_t)mascheraCifre(p + 16) << 16 |
+           (uint64_t)mascheraCifre(p + 32) << 32 | (uint64_t)mascheraCifre(p + 48) << 48;
+}
+
+static inline uint64_t leggi8(const char *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Valore di 8 cifre ASCII (la prima nel byte basso): 3 moltiplicazioni invece di 8
+static inline uint64_t ottoCifre(uint64_t v) {
+    v = ((v & 0x0F0F0F0F0F0F0F0Full) * (10 * 256 + 1)) >> 8;                  // coppie: 10a + b
+    v = ((v & 0x00FF00FF00FF00FFull) * (100 * 65536 + 1)) >> 16;              // gruppi di 4 cifre
+    return ((v & 0x0000FFFF0000FFFFull) * (10000 * 4294967296ull + 1)) >> 32; // 8 cifre
+}
+
+// Valore di len cifre, da 1 a 8: le cifre vanno nei byte alti e i byte bassi diventano zeri iniziali
+static inline uint64_t fino8Cifre(const char *p, unsigned len) {
+    return ottoCifre(leggi8(p) << (8 * (8 - len)));
+}
+
+static inline uint64_t valoreCifre(const char *p, unsigned len) {
+    if (len <= 8) {
+        return fino8Cifre(p, len);
+    }
+    if (len <= 16) {
+        return fino8Cifre(p, len - 8) * 100000000 + ottoCifre(leggi8(p + len - 8));
+    }
+    return (fino8Cifre(p, len - 16) * 100000000 + ottoCifre(leggi8(p + len - 16))) * 100000000 +
+           ottoCifre(leggi8(p + len - 8));
+}
+
+void sommaInizia(SommaInteri *s) {
+    s->somma = 0;
+    s->numeri = 0;
+    s->troppoGrandi = 0;
+}
+
+void sommaUnisci(SommaInteri *s, const SommaInteri *altra) {
+    s->somma += altra->somma;
+    s->numeri += altra->numeri;
+    s->troppoGrandi += altra->troppoGrandi;
+}
+
+size_t sommaTesto(SommaInteri *s, const char *dati, size_t n, int ultimo) {
+    size_t limite = n;
+    if (!ultimo) {
+        // Solo i numeri completi: l'ultimo numero (le cifre finali, con il '-'
+        // che le precede) potrebbe continuare nel blocco successivo. Un '-'
+        // finale potrebbe essere il segno del primo numero del blocco successivo.
+        while (limite > 0 && eCifra(dati[limite - 1])) {
+            limite--;
+        }
+        if (limite > 0 && dati[limite - 1] == '-') {
+            limite--;
+        }
+        if (limite == 0) {
+            // Tutto il blocco e' un numero: se e' lungo e' troppo grande, basta tenerne la coda
+            return n > RESTO_MAX ? n - RESTO_MAX / 2 : 0;
+        }
+    }
+
+    // Somme a 64 bit con il conteggio dei riporti: con __int128 il compilatore tiene la somma in memoria
+    uint64_t positivi = 0;
+    uint64_t riportiPositivi = 0;
+    uint64_t negativi = 0;
+    uint64_t riportiNegativi = 0;
+    uint64_t numeri = 0;
+    uint64_t troppoGrandi = 0;
+    // Blocchi di 64 byte: prima le maschere delle cifre e degli inizi dei numeri, poi
+    // un numero per ogni bit di inizi. I numeri non dipendono l'uno dall'altro e il
+    // processore ne converte piu' d'uno insieme.
+    const char *fine = dati + limite;
+    uint64_t cifraPrecedente = 0;   // l'ultimo byte del blocco precedente e' una cifra
+    uint64_t menoPrecedente = 0;    // l'ultimo byte del blocco precedente e' un '-'
+    for (const char *blocco = dati; blocco < fine; blocco += 64) {
+        uint64_t m = mascheraCifre64(blocco);
+        uint64_t inizi = m & ~((m << 1) | cifraPrecedente);
+        uint64_t meno = mascheraMeno64(blocco);
+        uint64_t segni = inizi & ((meno << 1) | menoPrecedente);   // inizi preceduti da un '-'
+        cifraPrecedente = m >> 63;
+        menoPrecedente = meno >> 63;
+        if (fine - blocco < 64) {
+            inizi &= ((uint64_t)1 << (fine - blocco)) - 1;
+        }
+        while (inizi != 0) {
+            unsigned posizione = (unsigned)__builtin_ctzll(inizi);
+            inizi &= inizi - 1;
+            const char *q = blocco + posizione;
+            // Con le cifre fino alla fine del blocco ~(m >> posizione) e' 0 e ctz non e' definito
+            uint64_t nonCifre = ~(m >> posizione);
+            unsigned len = nonCifre != 0 ? (unsigned)__builtin_ctzll(nonCifre) : 64 - posizione;
+            if (len == 64 - posizione) {
+                // Il numero continua nel blocco successivo
+                unsigned m2;
+                while ((m2 = mascheraCifre(q + len)) == 0xFFFF) {
+                    len += 16;
+                }
+                len += (unsigned)__builtin_ctz(~m2);
+            }
+            if (len <= CIFRE_MAX) {
+                uint64_t v = valoreCifre(q, len);
+                uint64_t negativo = (uint64_t)0 - ((segni >> posizione) & 1);
+                positivi += v & ~negativo;
+                riportiPositivi += positivi < (v & ~negativo);
+                negativi += v & negativo;
+                riportiNegativi += negativi < (v & negativo);
+                numeri++;
+            } else {
+                troppoGrandi++;
+            }
+        }
+    }
+    s->somma += ((__int128)riportiPositivi << 64) + positivi - ((__int128)riportiNegativi << 64) - negativi;
+    s->numeri += numeri;
+    s->troppoGrandi += troppoGrandi;
+    return limite;
+}
+
+void sommaBinario(SommaInteri *s, const int64_t valori[], size_t n) {
+    // v = alta * 2^32 + bassa - 2^64 se v < 0, con alta e bassa le due meta' senza segno:
+    // tre somme a 64 bit senza riporti (nessuna trabocca in 2^31 valori), che SSE2 fa 2 alla volta
+    const size_t valoriBlocco = (size_t)1 << 31;
+    size_t i = 0;
+    while (i < n) {
+        size_t fineBlocco = n - i > valoriBlocco ? i + valoriBlocco : n;
+        uint64_t alte = 0;
+        uint64_t basse = 0;
+        uint64_t negativi = 0;
+#ifdef SOMMA_SSE2
+        __m128i sommaAlte = _mm_setzero_si128();
+        __m128i sommaBasse = _mm_setzero_si128();
+        __m128i sommaNegativi = _mm_setzero_si128();
+        __m128i maschera = _mm_set1_epi64x(0xFFFFFFFF);
+        for (; i + 2 <= fineBlocco; i += 2) {
+            __m128i v = _mm_loadu_si128((const __m128i *)&valori[i]);
+            sommaAlte = _mm_add_epi64(sommaAlte, _mm_srli_epi64(v, 32));
+            sommaBasse = _mm_add_epi64(sommaBasse, _mm_and_si128(v, maschera));
+            sommaNegativi = _mm_add_epi64(sommaNegativi, _mm_srli_epi64(v, 63));
+        }
+        uint64_t parziali[2];
+        _mm_storeu_si128((__m128i *)parziali, sommaAlte);
+        alte = parziali[0] + parziali[1];
+        _mm_storeu_si128((__m128i *)parziali, sommaBasse);
+        basse = parziali[0] + parziali[1];
+        _mm_storeu_si128((__m128i *)parziali, sommaNegativi);
+        negativi = parziali[0] + parziali[1];
+#endif
+        for (; i < fineBlocco; i++) {
+            uint64_t v = (uint64_t)valori[i];
+            alte += v >> 32;
+            basse += v & 0xFFFFFFFF;
+            negativi += v >> 63;
+        }
+        s->somma += ((__int128)alte << 32) + basse - ((__int128)negativi << 64);
+    }
+    s->numeri += n;
+}
+
+//----------------------------------------------------------------------
+// Lettura a blocchi
+//----------------------------------------------------------------------
+
+/**
+ * Da dove leggere: un flusso con read(), o una parte di file con pread()
+ */
+typedef struct {
+    int fd;
+    int parte;
+    off_t posizione;
+    off_t fine;
+} Sorgente;
+
+static ssize_t leggiSorgente(Sorgente *f, char *buffer, size_t n) {
+    ssize_t letti;
+    do {
+        if (f->parte) {
+            if ((off_t)n > f->fine - f->posizione) {
+                n = (size_t)(f->fine - f->posizione);
+            }
+            letti = n > 0 ? pread(f->fd, buffer, n, f->posizione) : 0;
+        } else {
+            letti = read(f->fd, buffer, n);
+        }
+    } while (letti < 0 && errno == EINTR);
+    if (letti > 0) {
+        f->posizione += letti;
+    }
+    return letti;
+}
+
+static int sommaSorgente(Sorgente *f, FormatoSomma formato, SommaInteri *s) {
+    char *buffer = malloc(BLOCCO + SOMMA_MARGINE);
+    if (buffer == NULL) {
+        return -1;
+    }
+    size_t presenti = 0;   // byte non ancora consumati all'inizio del buffer
+    int esito = 0;
+    for (;;) {
+        ssize_t letti = leggiSorgente(f, buffer + presenti, BLOCCO - presenti);
+        if (letti < 0) {
+            esito = -1;
+            break;
+        }
+        presenti += (size_t)letti;
+        int ultimo = letti == 0;
+        size_t consumati;
+        if (formato == SOMMA_TESTO) {
+            memset(buffer + presenti, 0, SOMMA_MARGINE);
+            consumati = sommaTesto(s, buffer, presenti, ultimo);
+        } else {
+            consumati = presenti / sizeof(int64_t) * sizeof(int64_t);
+            sommaBinario(s, (const int64_t *)buffer, consumati / sizeof(int64_t));
+        }
+        memmove(buffer, buffer + consumati, presenti - consumati);
+        presenti -= consumati;
+        if (ultimo) {
+            if (presenti > 0) {
+                errno = EINVAL;   // file binario con un intero incompleto alla fine
+                esito = -1;
+            }
+            break;
+        }
+    }
+    free(buffer);
+    return esito;
+}
+
+int sommaDescrittore(int fd, FormatoSomma formato, SommaInteri *s) {
+    Sorgente f = {fd, 0, 0, 0};
+    return sommaSorgente(&f, formato, s);
+}
+
+/**
+ * Parte di file sommata da un thread
+ */
+typedef struct {
+    Sorgente sorgente;
+    FormatoSomma formato;
+    SommaInteri somma;
+    int esito;
+    int errore;
+} ParteFile;
+
+static void *sommaParte(void *argomento) {
+    ParteFile *p = argomento;
+    sommaInizia(&p->somma);
+    p->esito = sommaSorgente(&p->sorgente, p->formato, &p->somma);
+    p->errore = errno;
+    return NULL;
+}
+
+// Sposta un confine tra due parti dopo l'eventuale numero che lo attraversa
+static off_t confineTesto(int fd, off_t posizione, off_t dimensione) {
+    char byte[64];
+    while (posizione < dimensione) {
+        ssize_t letti = pread(fd, byte, sizeof(byte), posizione);
+        if (letti <= 0) {
+            return dimensione;
+        }
+        for (ssize_t i = 0; i < letti; i++, posizione++) {
+            if (!eCifra(byte[i])) {
+                return posizione;
+            }
+        }
+    }
+    return dimensione;
+}
+
+int sommaFile(const char *percorso, FormatoSomma formato, int thread, SommaInteri *s) {
+    return sommaFileDiviso(percorso, formato, thread, SOMMA_BYTE_PER_THREAD, s);
+}
+
+int sommaFileDiviso(const char *percorso, FormatoSomma formato, int thread, long long bytePerThread,
+                    SommaInteri *s) {
+    int fd = open(percorso, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return -1;
+    }
+    int esito;
+    if (!S_ISREG(info.st_mode)) {
+        // Pipe o dispositivo: si legge in sequenza
+        esito = sommaDescrittore(fd, formato, s);
+        close(fd);
+        return esito;
+    }
+    off_t dimensione = info.st_size;
+    if (bytePerThread < 1) {
+        bytePerThread = 1;
+    }
+    if (thread > dimensione / bytePerThread) {
+        thread = (int)(dimensione / bytePerThread);
+    }
+    if (thread < 1) {
+        thread = 1;
+    }
+
+    ParteFile *parti = calloc((size_t)thread, sizeof(ParteFile));
+    pthread_t *id = calloc((size_t)thread, sizeof(pthread_t));
+    if (parti == NULL || id == NULL) {
+        free(parti);
+        free(id);
+        close(fd);
+        return -1;
+    }
+    off_t inizio = 0;
+    for (int i = 0; i < thread; i++) {
+        off_t fine = dimensione / thread * (i + 1);
+        if (i == thread - 1) {
+            fine = dimensione;
+        } else if (formato == SOMMA_TESTO) {
+            fine = confineTesto(fd, fine, dimensione);
+        } else {
+            fine -= fine % (off_t)sizeof(int64_t);
+        }
+        if (fine < inizio) {
+            fine = inizio;
+        }
+        parti[i].sorgente = (Sorgente){fd, 1, inizio, fine};
+        parti[i].formato = formato;
+        inizio = fine;
+    }
+
+    // Il thread principale somma l'ultima parte
+    int avviati = 0;
+    for (; avviati < thread - 1; avviati++) {
+        if (pthread_create(&id[avviati], NULL, sommaParte, &parti[avviati]) != 0) {
+            break;
+        }
+    }
+    for (int i = avviati; i < thread - 1; i++) {
+        sommaParte(&parti[i]);   // thread non disponibile: parte sommata qui
+    }
+    sommaParte(&parti[thread - 1]);
+    esito = 0;
+    for (int i = 0; i < thread; i++) {
+        if (i < avviati) {
+            pthread_join(id[i], NULL);
+        }
+        if (parti[i].esito != 0) {
+            esito = -1;
+            errno = parti[i].errore;
+        }
+        sommaUnisci(s, &parti[i].somma);
+    }
+    free(parti);
+    free(id);
+    close(fd);
+    return esito;
+}
+
+char *sommaInTesto(__int128 valore, char testo[41]) {
+    char cifre[40];
+    int n = 0;
+    unsigned __int128 modulo = valore < 0 ? -(unsigned __int128)valore : (unsigned __int128)valore;
+    do {
+        cifre[n++] = (char)('0' + (int)(modulo % 10));
+        modulo /= 10;
+    } while (modulo > 0);
+    char *p = testo;
+    if (valore < 0) {
+        *p++ = '-';
+    }
+    while (n > 0) {
+        *p++ = cifre[--n];
+    }
+    *p = '\0';
+    return testo;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file somma_stream.h
+ * @brief Somma esatta di flussi molto grandi di numeri interi, in testo o in binario
+ *
+ * somma_interi.c legge due numeri con scanf e li somma in un int. Qui i numeri
+ * arrivano a blocchi (read() da 1 MB) e vengono sommati senza scanf:
+ *  - testo: numeri decimali separati da qualsiasi carattere che non sia una
+ *    cifra; un '-' subito prima delle cifre rende il numero negativo. Le cifre
+ *    vengono cercate 16 byte alla volta con SSE2 e convertite 8 alla volta con
+ *    una moltiplicazione a 64 bit (SWAR: "SIMD in un registro");
+ *  - binario: interi a 64 bit con segno, little endian.
+ *
+ * La somma e' un intero a 128 bit: per superarne il limite servirebbero piu'
+ * di 10^19 numeri. I numeri di 20 o piu' cifre (che non stanno in 64 bit)
+ * non vengono sommati ma contati in troppoGrandi.
+ *
+ * I file si possono dividere tra piu' thread: ogni thread somma una parte
+ * del file e alla fine le somme parziali vengono unite.
+ */
+#ifndef SOMMA_STREAM_H
+#define SOMMA_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Byte leggibili, e non cifre, richiesti dopo i dati passati a sommaTesto() */
+#define SOMMA_MARGINE 64
+
+/** Byte minimi per thread in sommaFile(): con meno, avviare un thread non conviene */
+#define SOMMA_BYTE_PER_THREAD (4 << 20)
+
+typedef enum {
+    SOMMA_TESTO,
+    SOMMA_BINARIO
+} FormatoSomma;
+
+/**
+ * Somma (parziale) di un flusso.
+ */
+typedef struct {
+    __int128 somma;
+    uint64_t numeri;         // numeri sommati
+    uint64_t troppoGrandi;   // numeri di 20 o piu' cifre, non sommati
+} SommaInteri;
+
+/**
+ * Azzera una somma.
+ */
+void sommaInizia(SommaInteri *s);
+
+/**
+ * Aggiunge a s la somma parziale altra.
+ */
+void sommaUnisci(SommaInteri *s, const SommaInteri *altra);
+
+/**
+ * Somma i numeri di un blocco di testo.
+ * @param s la somma
+ * @param dati il testo; dati[n] ... dati[n + SOMMA_MARGINE - 1] devono essere leggibili e non cifre
+ * @param n la lunghezza del testo
+ * @param ultimo 0 se il flusso continua nel blocco successivo
+ * @return quanti byte sono stati consumati: se il flusso continua, i byte
+ *         restanti (un numero forse incompleto) vanno ripresentati all'inizio del blocco successivo
+ */
+size_t sommaTesto(SommaInteri *s, const char *dati, size_t n, int ultimo);
+
+/**
+ * Somma n interi a 64 bit.
+ */
+void sommaBinario(SommaInteri *s, const int64_t valori[], size_t n);
+
+/**
+ * Somma un flusso letto da un descrittore (per esempio 0, lo standard input).
+ * @return 0 se il flusso e' stato letto tutto, -1 in caso di errore di lettura (errno indica la causa)
+ */
+int sommaDescrittore(int fd, FormatoSomma formato, SommaInteri *s);
+
+/**
+ * Somma un file, diviso tra thread parti. Ogni thread riceve almeno
+ * SOMMA_BYTE_PER_THREAD byte: i file piu' piccoli usano meno thread.
+ * @param percorso il nome del file
+ * @param formato testo o binario
+ * @param thread il numero di thread (1 per non usarne)
+ * @param s la somma
+ * @return 0 se il file e' stato letto tutto, -1 in caso di errore (errno indica la causa)
+ */
+int sommaFile(const char *percorso, FormatoSomma formato, int thread, SommaInteri *s);
+
+/**
+ * Come sommaFile(), con il numero minimo di byte per thread scelto dal
+ * chiamante: con 1 anche un file di pochi byte viene diviso (per le prove).
+ * @param bytePerThread il minimo di byte per thread (almeno 1)
+ */
+int sommaFileDiviso(const char *percorso, FormatoSomma formato, int thread, long long bytePerThread,
+                    SommaInteri *s);
+
+/**
+ * Scrive un intero a 128 bit in base 10.
+ * @param valore il numero
+ * @param testo dove scriverlo, almeno 41 caratteri
+ * @return testo
+ */
+char *sommaInTesto(__int128 valore, char testo[41]);
+
+#endif // SOMMA_STREAM_H
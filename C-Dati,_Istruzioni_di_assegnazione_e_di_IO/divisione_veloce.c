@@ -0,0 +1,118 @@
+/**
+ * @file divisione_veloce.c
+ * @brief Calcolo del numero magico e divisione di un vettore con SSE2/AVX2
+ */
+#include "divisione_veloce.h"
+
+// SSE2 c'e' su tutti i processori x86 a 64 bit; AVX2 viene scelto a runtime
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define DIVISIONE_X86 1
+#endif
+
+DivisoreU32 divisoreU32Crea(uint32_t divisore) {
+    DivisoreU32 d;
+    // l = ceil(log2(divisore)): il piu' piccolo l con 2^l >= divisore
+    unsigned l = 0;
+    while (l < 32 && ((uint64_t)1 << l) < divisore) {
+        l++;
+    }
+    d.divisore = divisore;
+    // magico = floor(2^32 * (2^l - divisore) / divisore) + 1, sta in 32 bit
+    d.magico = (uint32_t)(((((uint64_t)1 << l) - divisore) << 32) / divisore + 1);
+    d.shift1 = l > 0 ? 1 : 0;
+    d.shift2 = l > 0 ? (uint8_t)(l - 1) : 0;
+    return d;
+}
+
+static void divisioneRestoScalare(const uint32_t dividendi[], uint32_t quozienti[], uint32_t resti[], size_t n,
+                                  const DivisoreU32 *d) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t q = divisioneU32(dividendi[i], d);
+        if (quozienti != NULL) {
+            quozienti[i] = q;
+        }
+        if (resti != NULL) {
+            resti[i] = dividendi[i] - q * d->divisore;
+        }
+    }
+}
+
+#ifdef DIVISIONE_X86
+
+// Parte alta dei prodotti a 32 bit di 4 numeri per lo stesso magico
+static inline __m128i parteAlta4(__m128i n, __m128i magico) {
+    // _mm_mul_epu32 moltiplica solo gli elementi pari: due passate, pari e dispari
+    __m128i pari = _mm_srli_epi64(_mm_mul_epu32(n, magico), 32);
+    __m128i dispari = _mm_mul_epu32(_mm_srli_epi64(n, 32), magico);
+    // Elementi pari nelle posizioni 0 e 2, dispari (gia' nella meta' alta) in 1 e 3
+    return _mm_or_si128(pari, _mm_and_si128(dispari, _mm_set_epi32(-1, 0, -1, 0)));
+}
+
+// Prodotto a 32 bit (parte bassa) di 4 numeri per lo stesso valore; SSE2 non ha _mm_mullo_epi32
+static inline __m128i prodottoBasso4(__m128i a, __m128i b) {
+    __m128i pari = _mm_mul_epu32(a, b);
+    __m128i dispari = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(pari, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(dispari, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static void divisioneRestoSse2(const uint32_t dividendi[], uint32_t quozienti[], uint32_t resti[], size_t n,
+                               const DivisoreU32 *d) {
+    __m128i magico = _mm_set1_epi32((int)d->magico);
+    __m128i divisore = _mm_set1_epi32((int)d->divisore);
+    __m128i shift1 = _mm_cvtsi32_si128(d->shift1);
+    __m128i shift2 = _mm_cvtsi32_si128(d->shift2);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i *)&dividendi[i]);
+        __m128i t = parteAlta4(x, magico);
+        __m128i q = _mm_srl_epi32(_mm_add_epi32(t, _mm_srl_epi32(_mm_sub_epi32(x, t), shift1)), shift2);
+        if (quozienti != NULL) {
+            _mm_storeu_si128((__m128i *)&quozienti[i], q);
+        }
+        if (resti != NULL) {
+            _mm_storeu_si128((__m128i *)&resti[i], _mm_sub_epi32(x, prodottoBasso4(q, divisore)));
+        }
+    }
+    divisioneRestoScalare(dividendi + i, quozienti ? quozienti + i : NULL, resti ? resti + i : NULL, n - i, d);
+}
+
+__attribute__((target("avx2"))) static void divisioneRestoAvx2(const uint32_t dividendi[], uint32_t quozienti[],
+                                                               uint32_t resti[], size_t n, const DivisoreU32 *d) {
+    __m256i magico = _mm256_set1_epi32((int)d->magico);
+    __m256i divisore = _mm256_set1_epi32((int)d->divisore);
+    __m128i shift1 = _mm_cvtsi32_si128(d->shift1);
+    __m128i shift2 = _mm_cvtsi32_si128(d->shift2);
+    __m256i maschera = _mm256_set_epi32(-1, 0, -1, 0, -1, 0, -1, 0);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)&dividendi[i]);
+        __m256i pari = _mm256_srli_epi64(_mm256_mul_epu32(x, magico), 32);
+        __m256i dispari = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), magico);
+        __m256i t = _mm256_or_si256(pari, _mm256_and_si256(dispari, maschera));
+        __m256i q = _mm256_srl_epi32(_mm256_add_epi32(t, _mm256_srl_epi32(_mm256_sub_epi32(x, t), shift1)), shift2);
+        if (quozienti != NULL) {
+            _mm256_storeu_si256((__m256i *)&quozienti[i], q);
+        }
+        if (resti != NULL) {
+            _mm256_storeu_si256((__m256i *)&resti[i], _mm256_sub_epi32(x, _mm256_mullo_epi32(q, divisore)));
+        }
+    }
+    divisioneRestoSse2(dividendi + i, quozienti ? quozienti + i : NULL, resti ? resti + i : NULL, n - i, d);
+}
+
+#endif // DIVISIONE_X86
+
+void divisioneRestoMolti(const uint32_t dividendi[], uint32_t quozienti[], uint32_t resti[], size_t n,
+                         const DivisoreU32 *d) {
+#ifdef DIVISIONE_X86
+    if (__builtin_cpu_supports("avx2")) {
+        divisioneRestoAvx2(dividendi, quozienti, resti, n, d);
+    } else {
+        divisioneRestoSse2(dividendi, quozienti, resti, n, d);
+    }
+#else
+    divisioneRestoScalare(dividendi, quozienti, resti, n, d);
+#endif
+}
@@ -0,0 +1,69 @@
+/**
+ * @file divisione_veloce.h
+ * @brief Divisione e resto per un divisore noto solo a runtime, senza istruzione di divisione
+ *
+ * Quando il divisore e' una costante (n / 10) il compilatore sostituisce la
+ * divisione con una moltiplicazione per un "numero magico" e uno shift. Se il
+ * divisore e' una variabile (come max - min + 1 in vet_rand_3) deve usare
+ * l'istruzione di divisione, che costa 20-90 cicli contro i 3-4 di una
+ * moltiplicazione, e non esiste nelle istruzioni SIMD.
+ *
+ * Qui il numero magico viene calcolato una volta per divisore (come fa la
+ * libreria libdivide) e poi usato per dividere molti numeri:
+ *   q = (t + ((n - t) >> s1)) >> s2     con t = (n * magico) >> 32
+ * (Granlund e Montgomery, 1994; Hacker's Delight, cap. 10). Il risultato e'
+ * esatto per ogni n e ogni divisore a 32 bit senza segno, divisore 1 compreso.
+ *
+ * divisioneRestoMolti() elabora un vettore con SSE2 (4 numeri alla volta) o
+ * AVX2 (8 alla volta) se il processore lo supporta, altrimenti un numero alla volta.
+ */
+#ifndef DIVISIONE_VELOCE_H
+#define DIVISIONE_VELOCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Divisore preparato per la divisione veloce.
+ */
+typedef struct {
+    uint32_t divisore;
+    uint32_t magico;
+    uint8_t shift1;     // 0 se divisore == 1, altrimenti 1
+    uint8_t shift2;     // ceil(log2(divisore)) - 1, 0 se divisore == 1
+} DivisoreU32;
+
+/**
+ * Calcola il numero magico di un divisore.
+ * @param divisore il divisore, diverso da 0
+ * @return il divisore preparato
+ */
+DivisoreU32 divisoreU32Crea(uint32_t divisore);
+
+/**
+ * @return n / divisore
+ */
+static inline uint32_t divisioneU32(uint32_t n, const DivisoreU32 *d) {
+    uint32_t t = (uint32_t)(((uint64_t)n * d->magico) >> 32);
+    return (t + ((n - t) >> d->shift1)) >> d->shift2;
+}
+
+/**
+ * @return n % divisore
+ */
+static inline uint32_t restoU32(uint32_t n, const DivisoreU32 *d) {
+    return n - divisioneU32(n, d) * d->divisore;
+}
+
+/**
+ * Divide tutti gli elementi di un vettore per lo stesso divisore.
+ * @param dividendi i numeri da dividere
+ * @param quozienti dove scrivere i quozienti (NULL se non servono)
+ * @param resti dove scrivere i resti (NULL se non servono)
+ * @param n il numero di elementi
+ * @param d il divisore preparato con divisoreU32Crea()
+ */
+void divisioneRestoMolti(const uint32_t dividendi[], uint32_t quozienti[], uint32_t resti[], size_t n,
+                         const DivisoreU32 *d);
+
+#endif // DIVISIONE_VELOCE_H
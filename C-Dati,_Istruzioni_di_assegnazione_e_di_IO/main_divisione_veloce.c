@@ -0,0 +1,178 @@
+/**
+ * @file main_divisione_veloce.c
+ * @brief Verifica e misura della divisione per un divisore noto a runtime
+ *
+ * 1. Verifica: per molti divisori (piccoli, potenze di 2 e vicini, grandi) e
+ *    molti dividendi (casuali e casi limite) quozienti e resti devono
+ *    coincidere con / e %.
+ * 2. Misura, su un vettore di N numeri casuali, il costo per elemento di:
+ *    - / e % con il divisore in una variabile (istruzione di divisione);
+ *    - divisioneU32/restoU32 un elemento alla volta;
+ *    - divisioneRestoMolti (SSE2/AVX2).
+ * 3. Lo schema di vet_rand_3: min + rand() % (max - min + 1) su tutto il vettore.
+ *
+ * Compilazione:
+ *   gcc -O2 -std=c11 main_divisione_veloce.c divisione_veloce.c -o main_divisione_veloce
+ * Utilizzo:
+ *   ./main_divisione_veloce [N]
+ */
+#define _POSIX_C_SOURCE 199309L   // clock_gettime con -std=c11
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "divisione_veloce.h"
+
+static double secondi(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t statoCasuale = 88172645;
+static uint32_t casuale(void) {
+    statoCasuale ^= statoCasuale << 13;
+    statoCasuale ^= statoCasuale >> 17;
+    statoCasuale ^= statoCasuale << 5;
+    return statoCasuale;
+}
+
+// Verifica un divisore su dividendi casuali e sui casi limite; restituisce il numero di errori
+static int verificaDivisore(uint32_t divisore, uint32_t dividendi[], uint32_t q[], uint32_t r[], size_t n) {
+    DivisoreU32 d = divisoreU32Crea(divisore);
+    int errori = 0;
+    for (size_t i = 0; i < n; i++) {
+        dividendi[i] = casuale();
+    }
+    // Casi limite: 0, 1, massimo, multipli del divisore e vicini
+    dividendi[0] = 0;
+    dividendi[1] = 1;
+    dividendi[2] = UINT32_MAX;
+    dividendi[3] = UINT32_MAX - 1;
+    dividendi[4] = divisore;
+    dividendi[5] = divisore - 1;
+    dividendi[6] = (UINT32_MAX / divisore) * divisore;
+    dividendi[7] = (UINT32_MAX / divisore) * divisore - 1;
+    divisioneRestoMolti(dividendi, q, r, n, &d);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t x = dividendi[i];
+        if (q[i] != x / divisore || r[i] != x % divisore || divisioneU32(x, &d) != x / divisore) {
+            if (errori++ < 3) {
+                printf("ERRORE: %u / %u: %u resto %u\n", x, divisore, q[i], r[i]);
+            }
+        }
+    }
+    return errori;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 10000000;
+    if (n < 1000) {
+        n = 1000;
+    }
+    uint32_t *dividendi = malloc(n * sizeof(uint32_t));
+    uint32_t *q = malloc(n * sizeof(uint32_t));
+    uint32_t *r = malloc(n * sizeof(uint32_t));
+
+    // 1. Verifica
+    int errori = 0;
+    int divisori = 0;
+    for (uint32_t divisore = 1; divisore <= 1000; divisore++, divisori++) {
+        errori += verificaDivisore(divisore, dividendi, q, r, 1000);
+    }
+    for (int bit = 1; bit < 32; bit++) {
+        uint32_t p = (uint32_t)1 << bit;
+        errori += verificaDivisore(p - 1, dividendi, q, r, 1000);
+        errori += verificaDivisore(p, dividendi, q, r, 1000);
+        errori += verificaDivisore(p + 1, dividendi, q, r, 1000);
+        divisori += 3;
+    }
+    for (int i = 0; i < 2000; i++, divisori++) {
+        uint32_t divisore = casuale() >> (casuale() % 32);
+        errori += verificaDivisore(divisore ? divisore : 7, dividendi, q, r, 1000);
+    }
+    errori += verificaDivisore(UINT32_MAX, dividendi, q, r, 1000);
+    printf("verifica: %d divisori, %d errori\n\n", divisori + 1, errori);
+
+    // 2. Misura
+    for (size_t i = 0; i < n; i++) {
+        dividendi[i] = casuale();
+    }
+    volatile uint32_t divisoreVariabile = 1000003;   // volatile: il compilatore non lo conosce
+    uint32_t divisore = divisoreVariabile;
+    DivisoreU32 d = divisoreU32Crea(divisore);
+    uint64_t controllo1 = 0, controllo2 = 0, controllo3 = 0;
+
+    double t0 = secondi();
+    for (size_t i = 0; i < n; i++) {
+        q[i] = dividendi[i] / divisore;
+        r[i] = dividendi[i] % divisore;
+    }
+    double tDivisione = secondi() - t0;
+    for (size_t i = 0; i < n; i++) {
+        controllo1 += q[i] ^ r[i];
+    }
+
+    t0 = secondi();
+    for (size_t i = 0; i < n; i++) {
+        q[i] = divisioneU32(dividendi[i], &d);
+        r[i] = dividendi[i] - q[i] * d.divisore;
+    }
+    double tMagico = secondi() - t0;
+    for (size_t i = 0; i < n; i++) {
+        controllo2 += q[i] ^ r[i];
+    }
+
+    t0 = secondi();
+    divisioneRestoMolti(dividendi, q, r, n, &d);
+    double tMolti = secondi() - t0;
+    for (size_t i = 0; i < n; i++) {
+        controllo3 += q[i] ^ r[i];
+    }
+
+    printf("%zu divisioni per %u (ns per elemento)\n", n, divisore);
+    printf("  / e %%                  %6.2f\n", tDivisione / n * 1e9);
+    printf("  numero magico          %6.2f\n", tMagico / n * 1e9);
+    printf("  divisioneRestoMolti    %6.2f  (%s)\n", tMolti / n * 1e9,
+#if defined(__SSE2__)
+           __builtin_cpu_supports("avx2") ? "AVX2" : "SSE2"
+#else
+           "scalare"
+#endif
+    );
+    if (controllo1 != controllo2 || controllo1 != controllo3) {
+        printf("ERRORE: risultati diversi\n");
+        errori++;
+    }
+
+    // 3. Schema di vet_rand_3: valori casuali nell'intervallo [min, max]
+    // Estremi letti a runtime (volatile), come i parametri min e max di vet_rand_3: con
+    // costanti il compilatore trasformerebbe gia' il % in una moltiplicazione
+    volatile int minVariabile = 33;
+    volatile int maxVariabile = 55;
+    int min = minVariabile;
+    int max = maxVariabile;
+    DivisoreU32 ampiezza = divisoreU32Crea((uint32_t)(max - min + 1));
+    t0 = secondi();
+    divisioneRestoMolti(dividendi, NULL, r, n, &ampiezza);
+    for (size_t i = 0; i < n; i++) {
+        r[i] += min;
+    }
+    double tIntervallo = secondi() - t0;
+    t0 = secondi();
+    uint32_t modulo = (uint32_t)(max - min + 1);
+    for (size_t i = 0; i < n; i++) {
+        q[i] = min + dividendi[i] % modulo;
+    }
+    double tIntervalloModulo = secondi() - t0;
+    for (size_t i = 0; i < n; i++) {
+        errori += q[i] != r[i];
+    }
+    printf("\nmin + x %% (max - min + 1): %.2f ns con %%, %.2f ns con divisioneRestoMolti\n",
+           tIntervalloModulo / n * 1e9, tIntervallo / n * 1e9);
+
+    free(dividendi);
+    free(q);
+    free(r);
+    return errori != 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file Arduino.h
+ * @brief Sostituto per PC delle API Arduino usate dagli sketch del corso
+ *
+ * Permette di compilare ed eseguire uno sketch .ino su Linux: il tempo e'
+ * un orologio virtuale (delay() lo fa avanzare senza attendere), la seriale
+ * legge da uno script di input e scrive su un buffer, i pin sono variabili.
+ * Il controllo del simulatore (orologio, input, sensori) e' in simulatore.h.
+ *
+ * Vedere sim_main.cpp per la compilazione di uno sketch.
+ */
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define LED_BUILTIN 13
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define NUM_PIN 70
+
+void pinMode(uint8_t pin, uint8_t modo);
+void digitalWrite(uint8_t pin, uint8_t valore);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int valore);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+/**
+ * Porta seriale simulata: stessi metodi di HardwareSerial usati negli sketch.
+ */
+class HardwareSerial {
+public:
+  void begin(unsigned long baud);
+  void end() {}
+  int available();
+  int read();
+  int peek();
+  void flush() {}
+
+  size_t write(uint8_t c);
+  size_t write(const uint8_t *buffer, size_t dimensione);
+  size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+
+  size_t print(const char *s);
+  size_t print(char c);
+  size_t print(int n, int base = DEC);
+  size_t print(unsigned int n, int base = DEC);
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(double n, int cifre = 2);
+
+  size_t println();
+  size_t println(const char *s);
+  size_t println(char c);
+  size_t println(int n, int base = DEC);
+  size_t println(unsigned int n, int base = DEC);
+  size_t println(long n, int base = DEC);
+  size_t println(unsigned long n, int base = DEC);
+  size_t println(double n, int cifre = 2);
+
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// Funzioni dello sketch
+void setup();
+void loop();
+
+#endif // ARDUINO_H
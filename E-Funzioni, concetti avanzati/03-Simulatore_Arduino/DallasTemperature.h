@@ -0,0 +1,33 @@
+/**
+ * @file DallasTemperature.h
+ * @brief Sensore DS18B20 simulato
+ *
+ * La temperatura segue il profilo impostato con simImpostaProfiloTemperatura()
+ * ed e' arrotondata a 1/16 di grado come la conversione a 12 bit del DS18B20.
+ * requestTemperatures() fa avanzare l'orologio virtuale del tempo di
+ * conversione (750 ms), come la libreria originale in modalita' bloccante.
+ */
+#ifndef DALLASTEMPERATURE_H
+#define DALLASTEMPERATURE_H
+
+#include "Arduino.h"
+#include "OneWire.h"
+
+// Valore restituito dalla libreria quando il sensore non risponde
+#define DEVICE_DISCONNECTED_C -127
+
+class DallasTemperature {
+public:
+  explicit DallasTemperature(OneWire *bus) : bus(bus) {}
+  void begin() {}
+  uint8_t getDeviceCount();
+  void setWaitForConversion(bool attesa) { attendiConversione = attesa; }
+  void requestTemperatures();
+  float getTempCByIndex(uint8_t indice);
+
+private:
+  OneWire *bus;
+  bool attendiConversione = true;
+};
+
+#endif // DALLASTEMPERATURE_H
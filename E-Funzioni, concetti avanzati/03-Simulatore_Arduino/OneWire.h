@@ -0,0 +1,16 @@
+/**
+ * @file OneWire.h
+ * @brief Bus OneWire simulato: memorizza solo il pin a cui e' collegato
+ */
+#ifndef ONEWIRE_H
+#define ONEWIRE_H
+
+#include "Arduino.h"
+
+class OneWire {
+public:
+  explicit OneWire(uint8_t pin) : pin(pin) {}
+  uint8_t pin;
+};
+
+#endif // ONEWIRE_H
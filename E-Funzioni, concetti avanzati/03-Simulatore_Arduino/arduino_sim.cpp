@@ -0,0 +1,328 @@
+/**
+ * @file arduino_sim.cpp
+ * @brief Implementazione delle API Arduino simulate e del loro controllo
+ */
+#include "Arduino.h"
+#include "DallasTemperature.h"
+#include "simulatore.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+HardwareSerial Serial;
+
+static uint64_t tempoUs = 0;
+
+static uint8_t modoPin[NUM_PIN];
+static uint8_t statoPin[NUM_PIN];
+static uint64_t commutazioniPin[NUM_PIN];
+
+// Seriale in ingresso: ogni carattere diventa leggibile al suo istante
+static std::string ingresso;
+static std::vector<uint64_t> istantiIngresso;
+static size_t posizioneIngresso = 0;
+
+static bool eco = false;
+static uint64_t byteScritti = 0;
+static uint64_t scritture = 0;
+
+static float temperaturaCostante = 22.5f;
+static float (*profiloTemperatura)(unsigned long ms) = NULL;
+static bool sensoreCollegato = true;
+static float ultimaTemperatura = 22.5f;
+
+//----------------------------------------------------------------------
+// Controllo del simulatore
+//----------------------------------------------------------------------
+void simInizializza() {
+  tempoUs = 0;
+  memset(modoPin, 0, sizeof(modoPin));
+  memset(statoPin, 0, sizeof(statoPin));
+  memset(commutazioniPin, 0, sizeof(commutazioniPin));
+  ingresso.clear();
+  istantiIngresso.clear();
+  posizioneIngresso = 0;
+  byteScritti = 0;
+  scritture = 0;
+}
+
+uint64_t simTempoUs() {
+  return tempoUs;
+}
+
+void simAvanzaUs(uint64_t us) {
+  tempoUs += us;
+}
+
+void simSerialeInput(const char *testo, uint64_t intervalloUs) {
+  // Il primo carattere segue l'ultimo gia' accodato, o il tempo corrente
+  uint64_t istante = istantiIngresso.empty() ? tempoUs : istantiIngresso.back();
+  if (istante < tempoUs) {
+    istante = tempoUs;
+  }
+  for (const char *p = testo; *p != '\0'; p++) {
+    istante += intervalloUs;
+    ingresso.push_back(*p);
+    istantiIngresso.push_back(istante);
+  }
+}
+
+size_t simSerialeInputRimasto() {
+  return ingresso.size() - posizioneIngresso;
+}
+
+void simSerialeEco(bool attivo) {
+  eco = attivo;
+}
+
+uint64_t simSerialeByteScritti() {
+  return byteScritti;
+}
+
+uint64_t simSerialeScritture() {
+  return scritture;
+}
+
+int simLeggiPin(uint8_t pin) {
+  return pin < NUM_PIN ? statoPin[pin] : LOW;
+}
+
+void simImpostaPin(uint8_t pin, int valore) {
+  if (pin < NUM_PIN) {
+    statoPin[pin] = valore ? HIGH : LOW;
+  }
+}
+
+uint64_t simCommutazioniPin(uint8_t pin) {
+  return pin < NUM_PIN ? commutazioniPin[pin] : 0;
+}
+
+void simImpostaProfiloTemperatura(float (*profilo)(unsigned long ms)) {
+  profiloTemperatura = profilo;
+}
+
+void simImpostaTemperatura(float gradi) {
+  profiloTemperatura = NULL;
+  temperaturaCostante = gradi;
+}
+
+void simSensoreCollegato(bool collegato) {
+  sensoreCollegato = collegato;
+}
+
+//----------------------------------------------------------------------
+// Pin e tempo
+//----------------------------------------------------------------------
+void pinMode(uint8_t pin, uint8_t modo) {
+  if (pin >= NUM_PIN) {
+    return;
+  }
+  modoPin[pin] = modo;
+  if (modo == INPUT_PULLUP) {
+    statoPin[pin] = HIGH;
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t valore) {
+  if (pin >= NUM_PIN) {
+    return;
+  }
+  uint8_t nuovo = valore ? HIGH : LOW;
+  if (statoPin[pin] != nuovo) {
+    commutazioniPin[pin]++;
+  }
+  statoPin[pin] = nuovo;
+}
+
+int digitalRead(uint8_t pin) {
+  return simLeggiPin(pin);
+}
+
+int analogRead(uint8_t pin) {
+  (void)pin;
+  return 0;
+}
+
+void analogWrite(uint8_t pin, int valore) {
+  digitalWrite(pin, valore > 127 ? HIGH : LOW);
+}
+
+unsigned long millis() {
+  // Come su Arduino, il valore a 32 bit riparte da 0 dopo circa 49 giorni
+  return (uint32_t)(tempoUs / 1000);
+}
+
+unsigned long micros() {
+  return (uint32_t)tempoUs;
+}
+
+void delay(unsigned long ms) {
+  tempoUs += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us) {
+  tempoUs += us;
+}
+
+//----------------------------------------------------------------------
+// Seriale
+//----------------------------------------------------------------------
+void HardwareSerial::begin(unsigned long baud) {
+  (void)baud;
+}
+
+int HardwareSerial::available() {
+  // Gli istanti sono crescenti: ricerca binaria del primo non ancora arrivato
+  std::vector<uint64_t>::iterator fine =
+      std::upper_bound(istantiIngresso.begin() + posizioneIngresso, istantiIngresso.end(), tempoUs);
+  return (int)(fine - istantiIngresso.begin() - posizioneIngresso);
+}
+
+int HardwareSerial::read() {
+  if (posizioneIngresso >= ingresso.size() || istantiIngresso[posizioneIngresso] > tempoUs) {
+    return -1;
+  }
+  return (unsigned char)ingresso[posizioneIngresso++];
+}
+
+int HardwareSerial::peek() {
+  if (posizioneIngresso >= ingresso.size() || istantiIngresso[posizioneIngresso] > tempoUs) {
+    return -1;
+  }
+  return (unsigned char)ingresso[posizioneIngresso];
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t dimensione) {
+  scritture++;
+  byteScritti += dimensione;
+  if (eco) {
+    fwrite(buffer, 1, dimensione, stdout);
+  }
+  return dimensione;
+}
+
+// Converte un intero senza segno nella base indicata
+static size_t stampaNumero(HardwareSerial &s, unsigned long n, int base, bool negativo) {
+  char buffer[8 * sizeof(long) + 2];
+  char *p = buffer + sizeof(buffer);
+  if (base < 2) {
+    base = 10;
+  }
+  do {
+    int cifra = n % base;
+    *--p = cifra < 10 ? '0' + cifra : 'A' + cifra - 10;
+    n /= base;
+  } while (n > 0);
+  if (negativo) {
+    *--p = '-';
+  }
+  return s.write((const uint8_t *)p, buffer + sizeof(buffer) - p);
+}
+
+size_t HardwareSerial::print(const char *s) {
+  return write(s);
+}
+
+size_t HardwareSerial::print(char c) {
+  return write((uint8_t)c);
+}
+
+size_t HardwareSerial::print(int n, int base) {
+  return print((long)n, base);
+}
+
+size_t HardwareSerial::print(unsigned int n, int base) {
+  return print((unsigned long)n, base);
+}
+
+size_t HardwareSerial::print(long n, int base) {
+  // Come Arduino: il segno solo in base 10
+  if (base == DEC && n < 0) {
+    return stampaNumero(*this, 0ul - (unsigned long)n, base, true);
+  }
+  return stampaNumero(*this, (unsigned long)n, base, false);
+}
+
+size_t HardwareSerial::print(unsigned long n, int base) {
+  return stampaNumero(*this, n, base, false);
+}
+
+size_t HardwareSerial::print(double n, int cifre) {
+  char buffer[64];
+  if (isnan(n)) {
+    return print("nan");
+  }
+  if (isinf(n)) {
+    return print("inf");
+  }
+  int len = snprintf(buffer, sizeof(buffer), "%.*f", cifre, n);
+  return write((const uint8_t *)buffer, len);
+}
+
+size_t HardwareSerial::println() {
+  return write((const uint8_t *)"\r\n", 2);
+}
+
+size_t HardwareSerial::println(const char *s) {
+  size_t n = print(s);
+  return n + println();
+}
+
+size_t HardwareSerial::println(char c) {
+  size_t n = print(c);
+  return n + println();
+}
+
+size_t HardwareSerial::println(int n, int base) {
+  size_t r = print(n, base);
+  return r + println();
+}
+
+size_t HardwareSerial::println(unsigned int n, int base) {
+  size_t r = print(n, base);
+  return r + println();
+}
+
+size_t HardwareSerial::println(long n, int base) {
+  size_t r = print(n, base);
+  return r + println();
+}
+
+size_t HardwareSerial::println(unsigned long n, int base) {
+  size_t r = print(n, base);
+  return r + println();
+}
+
+size_t HardwareSerial::println(double n, int cifre) {
+  size_t r = print(n, cifre);
+  return r + println();
+}
+
+//----------------------------------------------------------------------
+// DS18B20
+//----------------------------------------------------------------------
+uint8_t DallasTemperature::getDeviceCount() {
+  return sensoreCollegato ? 1 : 0;
+}
+
+void DallasTemperature::requestTemperatures() {
+  float gradi = profiloTemperatura ? profiloTemperatura(millis()) : temperaturaCostante;
+  // Risoluzione a 12 bit: passi di 0.0625 gradi
+  ultimaTemperatura = roundf(gradi * 16.0f) / 16.0f;
+  if (attendiConversione) {
+    delay(750);
+  }
+}
+
+float DallasTemperature::getTempCByIndex(uint8_t indice) {
+  if (!sensoreCollegato || indice > 0) {
+    return DEVICE_DISCONNECTED_C;
+  }
+  return ultimaTemperatura;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file sim_main.cpp
+ * @brief Esegue uno sketch Arduino sul PC e misura il costo di loop()
+ *
+ * Lo sketch viene compilato insieme al simulatore; setup() viene chiamata
+ * una volta e loop() per il numero di iterazioni richiesto. Il tempo
+ * virtuale avanza di --passo-us ad ogni iterazione (il tempo che loop()
+ * impiegherebbe sulla scheda) e di quanto richiesto da delay().
+ *
+ * Compilazione (dalla cartella del simulatore):
+ *   S=../../F-Strutture_dati/ES99_Temperature_sensor
+ *   g++ -O2 -I . -I $S -I ../../F-Strutture_dati/librerie/MessaggioSeriale/src -include Arduino.h \
+ *       -x c++ $S/temperature_sensor_v2.ino \
+ *       -x none sim_main.cpp arduino_sim.cpp $S/statistiche_finestra.cpp $S/quantile_finestra.cpp -o sketch
+ * I .cpp dello sketch (es. statistiche_finestra.cpp, scheduler.cpp) vanno aggiunti dopo -x none,
+ * le librerie (es. MessaggioSeriale) con -I sulla loro cartella src.
+ *
+ * Utilizzo:
+ *   ./sketch [--iterazioni N] [--passo-us US] [--input TESTO] [--input-file FILE]
+ *            [--intervallo-input-us US] [--temperatura GRADI] [--eco] [--csv]
+ * Con --csv viene stampata una riga con i risultati, per il confronto in CI:
+ *   iterazioni,ns_medio,ns_p50,ns_p99,ns_max,tempo_virtuale_s,byte_seriale,scritture_seriale,accelerazione
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include "simulatore.h"
+
+// Istogramma dei tempi di loop() a passi di 10 ns fino a 100 us
+const int PASSO_ISTOGRAMMA_NS = 10;
+const int CELLE_ISTOGRAMMA = 10000;
+
+static uint64_t adessoNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static double percentile(const std::vector<uint64_t> &istogramma, uint64_t totale, double p) {
+  uint64_t soglia = (uint64_t)(p * totale);
+  uint64_t cumulato = 0;
+  for (int i = 0; i <= CELLE_ISTOGRAMMA; i++) {
+    cumulato += istogramma[i];
+    if (cumulato > soglia) {
+      return (double)i * PASSO_ISTOGRAMMA_NS;
+    }
+  }
+  return (double)CELLE_ISTOGRAMMA * PASSO_ISTOGRAMMA_NS;
+}
+
+static std::string leggiFile(const char *nome) {
+  std::string contenuto;
+  FILE *f = fopen(nome, "rb");
+  if (f == NULL) {
+    fprintf(stderr, "Impossibile aprire %s\n", nome);
+    exit(1);
+  }
+  char buffer[65536];
+  size_t letti;
+  while ((letti = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+    contenuto.append(buffer, letti);
+  }
+  fclose(f);
+  return contenuto;
+}
+
+int main(int argc, char *argv[]) {
+  uint64_t iterazioni = 1000000;
+  uint64_t passoUs = 100;
+  uint64_t intervalloInputUs = 0;
+  std::string input;
+  bool csv = false;
+
+  simInizializza();
+  for (int i = 1; i < argc; i++) {
+    bool haValore = i + 1 < argc;
+    if (strcmp(argv[i], "--iterazioni") == 0 && haValore) {
+      iterazioni = strtoull(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--passo-us") == 0 && haValore) {
+      passoUs = strtoull(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--input") == 0 && haValore) {
+      input += argv[++i];
+    } else if (strcmp(argv[i], "--input-file") == 0 && haValore) {
+      input += leggiFile(argv[++i]);
+    } else if (strcmp(argv[i], "--intervallo-input-us") == 0 && haValore) {
+      intervalloInputUs = strtoull(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--temperatura") == 0 && haValore) {
+      simImpostaTemperatura((float)atof(argv[++i]));
+    } else if (strcmp(argv[i], "--eco") == 0) {
+      simSerialeEco(true);
+    } else if (strcmp(argv[i], "--csv") == 0) {
+      csv = true;
+    } else {
+      fprintf(stderr, "Opzione sconosciuta: %s\n", argv[i]);
+      return 1;
+    }
+  }
+  simSerialeInput(input.c_str(), intervalloInputUs);
+
+  std::vector<uint64_t> istogramma(CELLE_ISTOGRAMMA + 1, 0);
+  uint64_t totaleNs = 0;
+  uint64_t massimoNs = 0;
+
+  uint64_t inizio = adessoNs();
+  setup();
+  for (uint64_t i = 0; i < iterazioni; i++) {
+    uint64_t t0 = adessoNs();
+    loop();
+    uint64_t durata = adessoNs() - t0;
+
+    totaleNs += durata;
+    if (durata > massimoNs) {
+      massimoNs = durata;
+    }
+    uint64_t cella = durata / PASSO_ISTOGRAMMA_NS;
+    istogramma[cella < CELLE_ISTOGRAMMA ? cella : CELLE_ISTOGRAMMA]++;
+    simAvanzaUs(passoUs);
+  }
+  double realeS = (adessoNs() - inizio) * 1e-9;
+  double virtualeS = simTempoUs() * 1e-6;
+  double medio = iterazioni > 0 ? (double)totaleNs / iterazioni : 0;
+
+  if (csv) {
+    printf("%llu,%.1f,%.0f,%.0f,%llu,%.3f,%llu,%llu,%.0f\n", (unsigned long long)iterazioni, medio,
+           percentile(istogramma, iterazioni, 0.50), percentile(istogramma, iterazioni, 0.99),
+           (unsigned long long)massimoNs, virtualeS, (unsigned long long)simSerialeByteScritti(),
+           (unsigned long long)simSerialeScritture(), virtualeS / realeS);
+  } else {
+    fprintf(stderr, "\n--- simulazione ---\n");
+    fprintf(stderr, "iterazioni di loop(): %llu\n", (unsigned long long)iterazioni);
+    fprintf(stderr, "costo di loop(): medio %.1f ns, p50 %.0f ns, p99 %.0f ns, max %llu ns\n", medio,
+            percentile(istogramma, iterazioni, 0.50), percentile(istogramma, iterazioni, 0.99),
+            (unsigned long long)massimoNs);
+    fprintf(stderr, "tempo virtuale %.3f s in %.3f s reali (%.0fx)\n", virtualeS, realeS,
+            virtualeS / realeS);
+    fprintf(stderr, "seriale: %llu byte in %llu scritture, input non letto %zu\n",
+            (unsigned long long)simSerialeByteScritti(), (unsigned long long)simSerialeScritture(),
+            simSerialeInputRimasto());
+  }
+  return 0;
+}
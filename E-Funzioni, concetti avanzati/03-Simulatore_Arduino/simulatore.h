@@ -0,0 +1,86 @@
+/**
+ * @file simulatore.h
+ * @brief Controllo del simulatore Arduino: orologio virtuale, seriale, sensori
+ */
+#ifndef SIMULATORE_H
+#define SIMULATORE_H
+
+#include "Arduino.h"
+
+/**
+ * Riporta il simulatore allo stato iniziale (tempo 0, pin bassi, seriale vuota).
+ */
+void simInizializza();
+
+/**
+ * @return il tempo virtuale in microsecondi
+ */
+uint64_t simTempoUs();
+
+/**
+ * Fa avanzare l'orologio virtuale.
+ * @param us i microsecondi da aggiungere
+ */
+void simAvanzaUs(uint64_t us);
+
+/**
+ * Accoda caratteri sulla seriale in ingresso.
+ * @param testo i caratteri da inviare allo sketch
+ * @param intervalloUs intervallo virtuale tra un carattere e il successivo
+ *        (0 = tutti disponibili subito)
+ */
+void simSerialeInput(const char *testo, uint64_t intervalloUs);
+
+/**
+ * @return i caratteri in ingresso non ancora letti dallo sketch
+ */
+size_t simSerialeInputRimasto();
+
+/**
+ * Stampa su stdout quanto lo sketch scrive sulla seriale.
+ * Se disattivato (default) l'uscita viene solo contata.
+ */
+void simSerialeEco(bool attivo);
+
+/**
+ * @return i byte scritti dallo sketch sulla seriale
+ */
+uint64_t simSerialeByteScritti();
+
+/**
+ * @return le chiamate a write() della seriale (ogni print ne fa almeno una)
+ */
+uint64_t simSerialeScritture();
+
+/**
+ * @return lo stato di un pin digitale (HIGH/LOW)
+ */
+int simLeggiPin(uint8_t pin);
+
+/**
+ * Imposta il livello letto da digitalRead() su un pin di ingresso.
+ */
+void simImpostaPin(uint8_t pin, int valore);
+
+/**
+ * @return il numero di cambi di stato del pin
+ */
+uint64_t simCommutazioniPin(uint8_t pin);
+
+/**
+ * Imposta la temperatura misurata dal DS18B20 in funzione del tempo.
+ * @param profilo funzione che riceve il tempo virtuale in ms e restituisce i gradi
+ */
+void simImpostaProfiloTemperatura(float (*profilo)(unsigned long ms));
+
+/**
+ * Imposta una temperatura costante per il DS18B20.
+ */
+void simImpostaTemperatura(float gradi);
+
+/**
+ * Simula il distacco del sensore (getTempCByIndex restituisce -127).
+ */
+void simSensoreCollegato(bool collegato);
+
+#endif // SIMULATORE_H
@@ -0,0 +1,329 @@
+/**
+ * @file fattoriale_veloce.cpp
+ * @brief Fattoriale a precisione arbitraria con albero di prodotti e Karatsuba
+ *
+ * n! = 2^e * (prodotto delle parti dispari di 2..n)
+ * Le parti dispari vengono moltiplicate a coppie come in un torneo:
+ * i fattori crescono insieme e le moltiplicazioni grandi, dove Karatsuba
+ * conviene, sono poche. I due rami dell'albero vengono calcolati da thread
+ * diversi fino a occupare tutti i core; il fattore 2^e e' uno shift finale.
+ */
+#include "fattoriale_veloce.h"
+#include "potenza_veloce.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <future>
+#include <thread>
+
+typedef std::vector<uint32_t> Parole;
+
+// Sotto questa lunghezza (in parole) l'algoritmo scolastico e' piu' veloce
+const size_t SOGLIA_KARATSUBA = 40;
+// Sotto questa lunghezza non conviene creare un nuovo thread
+const size_t SOGLIA_THREAD = 4096;
+// Foglie dell'albero di prodotti: intervalli di fattori moltiplicati in sequenza
+const uint32_t FATTORI_PER_FOGLIA = 32;
+
+// Elimina gli zeri piu' significativi
+static void normalizza(Parole &x) {
+    while (!x.empty() && x.back() == 0) {
+        x.pop_back();
+    }
+}
+
+// dst[0..nd) += src[0..ns), con ns <= nd; il riporto oltre nd viene perso
+static void sommaIn(uint32_t *dst, size_t nd, const uint32_t *src, size_t ns) {
+    uint64_t riporto = 0;
+    size_t i = 0;
+    for (; i < ns; i++) {
+        riporto += (uint64_t)dst[i] + src[i];
+        dst[i] = (uint32_t)riporto;
+        riporto >>= 32;
+    }
+    for (; riporto != 0 && i < nd; i++) {
+        riporto += dst[i];
+        dst[i] = (uint32_t)riporto;
+        riporto >>= 32;
+    }
+}
+
+// dst[0..nd) -= src[0..ns), con dst >= src
+static void sottraiDa(uint32_t *dst, size_t nd, const uint32_t *src, size_t ns) {
+    int64_t prestito = 0;
+    size_t i = 0;
+    for (; i < ns; i++) {
+        int64_t d = (int64_t)dst[i] - src[i] - prestito;
+        prestito = d < 0;
+        dst[i] = (uint32_t)d;
+    }
+    for (; prestito != 0 && i < nd; i++) {
+        int64_t d = (int64_t)dst[i] - prestito;
+        prestito = d < 0;
+        dst[i] = (uint32_t)d;
+    }
+}
+
+// out[0..na+nb) = a * b, algoritmo scolastico
+static void moltiplicaScolastica(const uint32_t *a, size_t na, const uint32_t *b, size_t nb,
+                                 uint32_t *out) {
+    std::fill(out, out + na + nb, 0);
+    for (size_t i = 0; i < na; i++) {
+        uint64_t riporto = 0;
+        uint64_t ai = a[i];
+        for (size_t j = 0; j < nb; j++) {
+            riporto += ai * b[j] + out[i + j];
+            out[i + j] = (uint32_t)riporto;
+            riporto >>= 32;
+        }
+        out[i + nb] = (uint32_t)riporto;
+    }
+}
+
+static void moltiplica(const uint32_t *a, size_t na, const uint32_t *b, size_t nb,
+                       uint32_t *out, int profondita);
+
+// out[0..2n) = a * b con a e b di n parole
+static void karatsuba(const uint32_t *a, const uint32_t *b, size_t n, uint32_t *out,
+                      int profondita) {
+    const size_t k = n / 2;  // parole basse
+    const size_t h = n - k;  // parole alte (h >= k)
+
+    // z0 = a0*b0 in out[0..2k), z2 = a1*b1 in out[2k..2n)
+    // I due prodotti sono indipendenti: in parallelo se c'e' un core libero
+    if (profondita > 0 && n >= SOGLIA_THREAD) {
+        auto z0 = std::async(std::launch::async, moltiplica, a, k, b, k, out, profondita - 1);
+        moltiplica(a + k, h, b + k, h, out + 2 * k, profondita - 1);
+        z0.get();
+    } else {
+        moltiplica(a, k, b, k, out, 0);
+        moltiplica(a + k, h, b + k, h, out + 2 * k, 0);
+    }
+
+    // z1 = (a0 + a1) * (b0 + b1) - z0 - z2
+    Parole sa(a + k, a + n), sb(b + k, b + n);
+    sa.push_back(0);
+    sb.push_back(0);
+    sommaIn(sa.data(), h + 1, a, k);
+    sommaIn(sb.data(), h + 1, b, k);
+    Parole z1(2 * h + 2);
+    moltiplica(sa.data(), h + 1, sb.data(), h + 1, z1.data(), profondita);
+    sottraiDa(z1.data(), z1.size(), out, 2 * k);
+    sottraiDa(z1.data(), z1.size(), out + 2 * k, 2 * h);
+    normalizza(z1);
+
+    // out += z1 * 2^(32k)
+    sommaIn(out + k, 2 * n - k, z1.data(), z1.size());
+}
+
+// out[0..na+nb) = a * b
+static void moltiplica(const uint32_t *a, size_t na, const uint32_t *b, size_t nb,
+                       uint32_t *out, int profondita) {
+    if (na < nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (nb < SOGLIA_KARATSUBA) {
+        moltiplicaScolastica(a, na, b, nb, out);
+        return;
+    }
+    if (na == nb) {
+        karatsuba(a, b, na, out, profondita);
+        return;
+    }
+    // Fattori sbilanciati: a viene diviso in blocchi lunghi quanto b
+    std::fill(out, out + na + nb, 0);
+    Parole parziale(2 * nb);
+    for (size_t pos = 0; pos < na; pos += nb) {
+        size_t len = std::min(nb, na - pos);
+        moltiplica(a + pos, len, b, nb, parziale.data(), profondita);
+        sommaIn(out + pos, na + nb - pos, parziale.data(), len + nb);
+    }
+}
+
+static Parole moltiplicaParole(const Parole &a, const Parole &b, int profondita) {
+    if (a.empty() || b.empty()) {
+        return Parole();
+    }
+    Parole out(a.size() + b.size());
+    moltiplica(a.data(), a.size(), b.data(), b.size(), out.data(), profondita);
+    normalizza(out);
+    return out;
+}
+
+// x *= m, con m di una sola parola
+static void moltiplicaPiccolo(Parole &x, uint32_t m) {
+    uint64_t riporto = 0;
+    for (size_t i = 0; i < x.size(); i++) {
+        riporto += (uint64_t)x[i] * m;
+        x[i] = (uint32_t)riporto;
+        riporto >>= 32;
+    }
+    if (riporto != 0) {
+        x.push_back((uint32_t)riporto);
+    }
+}
+
+// Parte dispari di i: i senza i fattori 2
+static inline uint32_t parteDispari(uint32_t i) {
+    return i >> __builtin_ctz(i);
+}
+
+// Prodotto delle parti dispari di da..a (estremi compresi)
+static Parole prodottoIntervallo(uint32_t da, uint32_t a, int profondita) {
+    if (a - da < FATTORI_PER_FOGLIA) {
+        Parole x(1, 1);
+        uint64_t accumulo = 1;
+        // Contatore a 64 bit: con a = UINT32_MAX uno a 32 bit tornerebbe a 0 senza mai superare a
+        for (uint64_t i = da; i <= a; i++) {
+            uint32_t d = parteDispari((uint32_t)i);
+            // Accumula in 64 bit finche' il prodotto sta in una parola
+            if (accumulo * d > UINT32_MAX) {
+                moltiplicaPiccolo(x, (uint32_t)accumulo);
+                accumulo = d;
+            } else {
+                accumulo *= d;
+            }
+        }
+        moltiplicaPiccolo(x, (uint32_t)accumulo);
+        return x;
+    }
+    uint32_t medio = da + (a - da) / 2;
+    Parole sinistra, destra;
+    if (profondita > 0) {
+        auto futuro = std::async(std::launch::async, prodottoIntervallo, da, medio, profondita - 1);
+        destra = prodottoIntervallo(medio + 1, a, profondita - 1);
+        sinistra = futuro.get();
+    } else {
+        sinistra = prodottoIntervallo(da, medio, 0);
+        destra = prodottoIntervallo(medio + 1, a, 0);
+    }
+    return moltiplicaParole(sinistra, destra, profondita);
+}
+
+// x <<= bit
+static void shiftSinistra(Parole &x, uint64_t bit) {
+    size_t parole = bit / 32;
+    unsigned int resto = bit % 32;
+    if (resto != 0) {
+        uint32_t riporto = 0;
+        for (size_t i = 0; i < x.size(); i++) {
+            uint32_t v = x[i];
+            x[i] = (v << resto) | riporto;
+            riporto = v >> (32 - resto);
+        }
+        if (riporto != 0) {
+            x.push_back(riporto);
+        }
+    }
+    x.insert(x.begin(), parole, 0);
+}
+
+NumeroGrande fattorialeGrande(uint32_t n, unsigned int numThread) {
+    NumeroGrande risultato;
+    if (n <= FATTORIALE64_MAX) {
+        uint64_t v = fattoriale64(n);
+        risultato.parole.push_back((uint32_t)v);
+        risultato.parole.push_back((uint32_t)(v >> 32));
+        normalizza(risultato.parole);
+        return risultato;
+    }
+    if (numThread == 0) {
+        numThread = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Ogni livello di profondita' raddoppia i thread
+    int profondita = 0;
+    while ((1u << profondita) < numThread) {
+        profondita++;
+    }
+
+    risultato.parole = prodottoIntervallo(2, n, profondita);
+
+    // Esponente di 2 in n! (formula di Legendre): n - numero di bit a 1 di n
+    uint64_t esponenteDue = n - (uint64_t)__builtin_popcount(n);
+    shiftSinistra(risultato.parole, esponenteDue);
+    return risultato;
+}
+
+NumeroGrande numeroGrandeMoltiplica(const NumeroGrande &a, const NumeroGrande &b) {
+    NumeroGrande risultato;
+    risultato.parole = moltiplicaParole(a.parole, b.parole, 0);
+    return risultato;
+}
+
+size_t numeroGrandeBit(const NumeroGrande &x) {
+    size_t n = x.parole.size();
+    while (n > 0 && x.parole[n - 1] == 0) {
+        n--;
+    }
+    if (n == 0) {
+        return 0;
+    }
+    return (n - 1) * 32 + (32 - __builtin_clz(x.parole[n - 1]));
+}
+
+std::string numeroGrandeInStringa(const NumeroGrande &x) {
+    Parole q = x.parole;
+    normalizza(q);
+    if (q.empty()) {
+        return "0";
+    }
+    // Divisioni successive per 10^9: ogni resto fornisce 9 cifre
+    std::vector<uint32_t> blocchi;
+    while (!q.empty()) {
+        uint64_t resto = 0;
+        for (size_t i = q.size(); i-- > 0;) {
+            uint64_t corrente = (resto << 32) | q[i];
+            q[i] = (uint32_t)(corrente / 1000000000u);
+            resto = corrente % 1000000000u;
+        }
+        blocchi.push_back((uint32_t)resto);
+        normalizza(q);
+    }
+    std::string s = std::to_string(blocchi.back());
+    char buffer[16];
+    for (size_t i = blocchi.size() - 1; i-- > 0;) {
+        snprintf(buffer, sizeof(buffer), "%09u", blocchi[i]);
+        s += buffer;
+    }
+    return s;
+}
+
+uint64_t fattorialeModulare(uint64_t n, uint64_t modulo) {
+    if (modulo == 1 || n >= modulo) {
+        // Se n >= modulo, il modulo stesso e' uno dei fattori
+        return 0;
+    }
+    uint64_t risultato = 1;
+    for (uint64_t i = 2; i <= n; i++) {
+        risultato = moltiplicaModulare(risultato, i, modulo);
+    }
+    return risultato;
+}
+
+TabellaCombinatoria tabellaCombinatoriaCrea(uint32_t n, uint64_t modulo) {
+    TabellaCombinatoria t;
+    t.modulo = modulo;
+    t.fattoriali.resize((size_t)n + 1);
+    t.inversi.resize((size_t)n + 1);
+    t.fattoriali[0] = 1 % modulo;
+    for (uint32_t i = 1; i <= n; i++) {
+        t.fattoriali[i] = moltiplicaModulare(t.fattoriali[i - 1], i, modulo);
+    }
+    // Piccolo teorema di Fermat: x^-1 = x^(p-2) mod p; una sola potenza,
+    // gli altri inversi si ottengono a ritroso: 1/(i-1)! = i * 1/i!
+    t.inversi[n] = potenzaModulare(t.fattoriali[n], modulo - 2, modulo);
+    for (uint32_t i = n; i > 0; i--) {
+        t.inversi[i - 1] = moltiplicaModulare(t.inversi[i], i, modulo);
+    }
+    return t;
+}
+
+uint64_t binomialeModulare(const TabellaCombinatoria &tabella, uint32_t n, uint32_t k) {
+    if (k > n) {
+        return 0;
+    }
+    uint64_t r = moltiplicaModulare(tabella.fattoriali[n], tabella.inversi[k], tabella.modulo);
+    return moltiplicaModulare(r, tabella.inversi[n - k], tabella.modulo);
+}
@@ -0,0 +1,115 @@
+/**
+ * @file fattoriale_veloce.h
+ * @brief Fattoriale esatto: tabella constexpr, precisione arbitraria e modulare
+ *
+ * fattoriale() di fatt.c restituisce un double, che da 23! in poi non
+ * rappresenta piu' il valore esatto. Questo modulo offre:
+ *  - fattoriale64(): valori esatti fino a 20! letti da una tabella calcolata
+ *    dal compilatore;
+ *  - fattorialeGrande(): n! esatto per n anche di milioni, con un albero di
+ *    prodotti (binary splitting) i cui sottoprodotti sono distribuiti su piu'
+ *    thread, moltiplicati con l'algoritmo di Karatsuba;
+ *  - fattorialeModulare() e la tabella combinatoria per i coefficienti
+ *    binomiali modulo un primo.
+ *
+ * Compilazione (C++17):
+ *   g++ -O2 -std=c++17 -pthread main_fattoriale_veloce.cpp fattoriale_veloce.cpp potenza_veloce.cpp
+ */
+#ifndef FATTORIALE_VELOCE_H
+#define FATTORIALE_VELOCE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+// Il fattoriale piu' grande che sta in un uint64_t
+const unsigned int FATTORIALE64_MAX = 20;
+
+// Tabella di 0!..20! calcolata a tempo di compilazione
+struct TabellaFattoriali64 {
+    uint64_t valori[FATTORIALE64_MAX + 1];
+
+    constexpr TabellaFattoriali64() : valori() {
+        valori[0] = 1;
+        for (unsigned int i = 1; i <= FATTORIALE64_MAX; i++) {
+            valori[i] = valori[i - 1] * i;
+        }
+    }
+};
+
+constexpr TabellaFattoriali64 TABELLA_FATTORIALI64;
+
+/**
+ * Restituisce n! esatto per n <= 20.
+ * @param n il numero di cui calcolare il fattoriale
+ * @return n!, oppure 0 se n! non sta in 64 bit
+ */
+constexpr uint64_t fattoriale64(unsigned int n) {
+    return n <= FATTORIALE64_MAX ? TABELLA_FATTORIALI64.valori[n] : 0;
+}
+
+/**
+ * Intero senza segno a precisione arbitraria.
+ * Le parole sono cifre in base 2^32, dalla meno significativa.
+ */
+struct NumeroGrande {
+    std::vector<uint32_t> parole;
+};
+
+/**
+ * Calcola n! esatto.
+ * @param n il numero di cui calcolare il fattoriale
+ * @param numThread thread da usare (0 = tutti i core disponibili)
+ * @return n! come NumeroGrande
+ */
+NumeroGrande fattorialeGrande(uint32_t n, unsigned int numThread = 0);
+
+/**
+ * Moltiplica due numeri grandi (Karatsuba sopra una soglia, altrimenti
+ * l'algoritmo scolastico).
+ */
+NumeroGrande numeroGrandeMoltiplica(const NumeroGrande &a, const NumeroGrande &b);
+
+/**
+ * Numero di bit significativi di un numero grande.
+ */
+size_t numeroGrandeBit(const NumeroGrande &x);
+
+/**
+ * Converte un numero grande in decimale.
+ * Il costo e' quadratico nel numero di cifre: adatto a qualche decina di
+ * migliaia di cifre, non alla stampa di fattoriali di milioni.
+ */
+std::string numeroGrandeInStringa(const NumeroGrande &x);
+
+/**
+ * Calcola n! mod modulo.
+ * @param n il numero di cui calcolare il fattoriale
+ * @param modulo il modulo (> 0)
+ * @return n! mod modulo
+ */
+uint64_t fattorialeModulare(uint64_t n, uint64_t modulo);
+
+/**
+ * Fattoriali e loro inversi modulo un primo, per calcolare i coefficienti
+ * binomiali in tempo costante.
+ */
+struct TabellaCombinatoria {
+    uint64_t modulo;
+    std::vector<uint64_t> fattoriali;
+    std::vector<uint64_t> inversi;
+};
+
+/**
+ * Prepara la tabella di 0!..n! modulo il primo modulo (n < modulo).
+ */
+TabellaCombinatoria tabellaCombinatoriaCrea(uint32_t n, uint64_t modulo);
+
+/**
+ * Calcola il coefficiente binomiale C(n, k) modulo tabella.modulo.
+ * @return C(n, k) mod p, 0 se k > n
+ */
+uint64_t binomialeModulare(const TabellaCombinatoria &tabella, uint32_t n, uint32_t k);
+
+#endif // FATTORIALE_VELOCE_H
@@ -0,0 +1,57 @@
+/**
+ * @file main_fattoriale_veloce.cpp
+ * Confronto tra fattoriale() di fatt.c e le funzioni di fattoriale_veloce.h
+ *
+ * g++ -O2 -std=c++17 -pthread main_fattoriale_veloce.cpp fattoriale_veloce.cpp potenza_veloce.cpp
+ * ./a.out [n]     (n = fattoriale grande da calcolare, default 300000)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "fattoriale_veloce.h"
+
+static_assert(fattoriale64(20) == 2432902008176640000ull, "20! calcolato dal compilatore");
+
+// Versione originale di fatt.c, usata come riferimento
+double fattoriale(int n) {
+    double res = 1;
+    for (int i = 2; i <= n; i++) {
+        res *= i;
+    }
+    return res;
+}
+
+static double secondi() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t n = argc > 1 ? (uint32_t)atol(argv[1]) : 300000;
+
+    // Il double perde le ultime cifre gia' da 23!
+    printf("fattoriale(25)      = %.0f\n", fattoriale(25));
+    printf("fattorialeGrande(25) = %s\n", numeroGrandeInStringa(fattorialeGrande(25)).c_str());
+    printf("fattoriale64(20)    = %llu\n", (unsigned long long)fattoriale64(20));
+
+    // Combinatoria modulo un primo
+    const uint64_t P = 1000000007ull;
+    TabellaCombinatoria tabella = tabellaCombinatoriaCrea(1000000, P);
+    printf("\n100000! mod p      = %llu\n", (unsigned long long)fattorialeModulare(100000, P));
+    printf("C(1000000, 500000) mod p = %llu\n",
+           (unsigned long long)binomialeModulare(tabella, 1000000, 500000));
+
+    // Fattoriale grande: un thread e tutti i thread
+    double t0 = secondi();
+    NumeroGrande f1 = fattorialeGrande(n, 1);
+    double t1 = secondi();
+    NumeroGrande f2 = fattorialeGrande(n);
+    double t2 = secondi();
+
+    printf("\n%u! ha %zu bit\n", n, numeroGrandeBit(f1));
+    printf("  1 thread:      %.3f s\n", t1 - t0);
+    printf("  tutti i core:  %.3f s\n", t2 - t1);
+    printf("  risultati %s\n", f1.parole == f2.parole ? "uguali" : "DIVERSI");
+    return 0;
+}
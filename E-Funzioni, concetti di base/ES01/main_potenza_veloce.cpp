@@ -0,0 +1,90 @@
+/**
+ * @file main_potenza_veloce.cpp
+ * Confronto tra la potenza con ciclo lineare (potenza.c) e le funzioni
+ * di potenza_veloce.h, con un piccolo benchmark della potenza modulare.
+ *
+ * g++ -O2 -std=c++17 main_potenza_veloce.cpp potenza_veloce.cpp
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "potenza_veloce.h"
+
+// Calcolate dal compilatore: nessuna moltiplicazione a tempo di esecuzione
+constexpr int64_t KILOBYTE = potenzaVeloce(2, 10);
+constexpr uint64_t MODULO_CHECKSUM = 1000000007ull;
+static_assert(potenzaVeloce(5, 4) == 625, "5^4 deve valere 625");
+static_assert(potenzaModulare(2, 100, MODULO_CHECKSUM) == 976371285ull, "2^100 mod 1e9+7");
+
+// Versione originale di potenza.c, usata come riferimento
+int potenza(int base, int esponente) {
+  int risultato = 1;
+  for (int i = 0; i < esponente; i++) {
+    risultato *= base;
+  }
+  return risultato;
+}
+
+static double secondi() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main() {
+  printf("5^4 = %lld\n", (long long)potenzaVeloce(5, 4));
+  printf("12^3 = %lld\n", (long long)potenzaVeloce(12, 3));
+  printf("20^2 = %lld\n", (long long)potenzaVeloce(20, 2));
+  printf("15^0 = %lld\n", (long long)potenzaVeloce(15, 0));
+  printf("2^10 (constexpr) = %lld\n", (long long)KILOBYTE);
+
+  // Overflow: potenza() restituisce un valore sbagliato senza avvisare
+  int64_t r;
+  printf("\npotenza(10, 10) = %d\n", potenza(10, 10));
+  if (potenzaControllata(10, 10, &r)) {
+    printf("potenzaControllata(10, 10) = %lld\n", (long long)r);
+  }
+  if (!potenzaControllata(10, 19, &r)) {
+    printf("potenzaControllata(10, 19): overflow\n");
+  }
+
+  printf("\n3^200 mod %llu = %llu\n", (unsigned long long)MODULO_CHECKSUM,
+         (unsigned long long)potenzaModulare(3, 200, MODULO_CHECKSUM));
+
+  // Benchmark: potenza modulare una alla volta e a lotti
+  const size_t N = 1000000;
+  uint64_t *basi = (uint64_t *)malloc(N * sizeof(uint64_t));
+  uint64_t *esponenti = (uint64_t *)malloc(N * sizeof(uint64_t));
+  uint64_t *ris1 = (uint64_t *)malloc(N * sizeof(uint64_t));
+  uint64_t *ris2 = (uint64_t *)malloc(N * sizeof(uint64_t));
+  srand(1);
+  for (size_t i = 0; i < N; i++) {
+    basi[i] = ((uint64_t)rand() << 31) ^ (uint64_t)rand();
+    esponenti[i] = ((uint64_t)rand() << 31) ^ (uint64_t)rand();
+  }
+
+  double t0 = secondi();
+  for (size_t i = 0; i < N; i++) {
+    ris1[i] = potenzaModulare(basi[i], esponenti[i], MODULO_CHECKSUM);
+  }
+  double t1 = secondi();
+  potenzaModulareBatch(basi, esponenti, ris2, N, MODULO_CHECKSUM);
+  double t2 = secondi();
+
+  size_t errori = 0;
+  for (size_t i = 0; i < N; i++) {
+    if (ris1[i] != ris2[i]) {
+      errori++;
+    }
+  }
+  printf("\n%zu potenze modulari:\n", N);
+  printf("  potenzaModulare      %8.1f ns/potenza\n", (t1 - t0) * 1e9 / N);
+  printf("  potenzaModulareBatch %8.1f ns/potenza\n", (t2 - t1) * 1e9 / N);
+  printf("  risultati diversi: %zu\n", errori);
+
+  free(basi);
+  free(esponenti);
+  free(ris1);
+  free(ris2);
+  return 0;
+}
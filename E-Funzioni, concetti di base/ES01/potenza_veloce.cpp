@@ -0,0 +1,103 @@
+/**
+ * @file potenza_veloce.cpp
+ * @brief Potenza modulare a lotti con la moltiplicazione di Montgomery
+ */
+#include "potenza_veloce.h"
+
+typedef unsigned __int128 uint128_t;
+
+// Dati precalcolati una sola volta per ogni modulo
+struct Montgomery {
+    uint64_t modulo;   // m, dispari e minore di 2^63
+    uint64_t inverso;  // -m^-1 mod 2^64
+    uint64_t r2;       // 2^128 mod m, per portare un numero nella forma di Montgomery
+    uint64_t uno;      // 2^64 mod m, cioe' 1 nella forma di Montgomery
+};
+
+static Montgomery montgomeryPrepara(uint64_t m) {
+    Montgomery mg;
+    mg.modulo = m;
+    // Metodo di Newton: ogni passo raddoppia i bit corretti di m^-1
+    uint64_t inv = m;  // corretto su 3 bit perche' m e' dispari
+    for (int i = 0; i < 5; i++) {
+        inv *= 2 - m * inv;
+    }
+    mg.inverso = 0 - inv;
+    mg.uno = (0 - m) % m;
+    mg.r2 = (uint64_t)(((uint128_t)mg.uno * mg.uno) % m);
+    return mg;
+}
+
+// Riduzione di Montgomery: restituisce t * 2^-64 mod m (richiede t < m * 2^64)
+static inline uint64_t montgomeryRiduci(const Montgomery &mg, uint128_t t) {
+    uint64_t q = (uint64_t)t * mg.inverso;
+    uint64_t r = (uint64_t)((t + (uint128_t)q * mg.modulo) >> 64);
+    return r >= mg.modulo ? r - mg.modulo : r;
+}
+
+static inline uint64_t montgomeryMoltiplica(const Montgomery &mg, uint64_t a, uint64_t b) {
+    return montgomeryRiduci(mg, (uint128_t)a * b);
+}
+
+void potenzaModulareBatch(const uint64_t basi[], const uint64_t esponenti[],
+                          uint64_t risultati[], size_t n, uint64_t modulo) {
+    if ((modulo & 1u) == 0 || modulo >= (1ull << 63)) {
+        for (size_t i = 0; i < n; i++) {
+            risultati[i] = potenzaModulare(basi[i], esponenti[i], modulo);
+        }
+        return;
+    }
+    if (modulo == 1) {
+        for (size_t i = 0; i < n; i++) {
+            risultati[i] = 0;
+        }
+        return;
+    }
+
+    const Montgomery mg = montgomeryPrepara(modulo);
+    const int GRUPPO = 4;
+    size_t i = 0;
+
+    // Quattro potenze indipendenti per volta: le moltiplicazioni di una
+    // potenza si sovrappongono a quelle delle altre nella pipeline
+    for (; i + GRUPPO <= n; i += GRUPPO) {
+        uint64_t b[GRUPPO], r[GRUPPO], e[GRUPPO];
+        uint64_t bitRestanti = 0;
+        for (int k = 0; k < GRUPPO; k++) {
+            b[k] = montgomeryMoltiplica(mg, basi[i + k] % modulo, mg.r2);
+            e[k] = esponenti[i + k];
+            r[k] = mg.uno;
+            bitRestanti |= e[k];
+        }
+        while (bitRestanti != 0) {
+            bitRestanti = 0;
+            for (int k = 0; k < GRUPPO; k++) {
+                // Selezione senza salti: il bit basso sceglie il fattore
+                uint64_t fattore = (e[k] & 1u) ? b[k] : mg.uno;
+                r[k] = montgomeryMoltiplica(mg, r[k], fattore);
+                b[k] = montgomeryMoltiplica(mg, b[k], b[k]);
+                e[k] >>= 1;
+                bitRestanti |= e[k];
+            }
+        }
+        for (int k = 0; k < GRUPPO; k++) {
+            // Riporta il risultato dalla forma di Montgomery a quella normale
+            risultati[i + k] = montgomeryRiduci(mg, r[k]);
+        }
+    }
+
+    // Elementi rimanenti
+    for (; i < n; i++) {
+        uint64_t b = montgomeryMoltiplica(mg, basi[i] % modulo, mg.r2);
+        uint64_t e = esponenti[i];
+        uint64_t r = mg.uno;
+        while (e > 0) {
+            if (e & 1u) {
+                r = montgomeryMoltiplica(mg, r, b);
+            }
+            b = montgomeryMoltiplica(mg, b, b);
+            e >>= 1;
+        }
+        risultati[i] = montgomeryRiduci(mg, r);
+    }
+}
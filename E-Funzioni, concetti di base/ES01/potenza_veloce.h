@@ -0,0 +1,118 @@
+/**
+ * @file potenza_veloce.h
+ * @brief Elevamento a potenza con l'algoritmo "square and multiply"
+ *
+ * La funzione potenza() di potenza.c esegue esponente moltiplicazioni e,
+ * quando il risultato non sta in un int, va in overflow senza avvisare.
+ * Qui l'esponente viene scomposto in bit: ad ogni passo la base viene
+ * elevata al quadrato e moltiplicata nel risultato solo se il bit vale 1.
+ * Le moltiplicazioni diventano circa 2*log2(esponente).
+ *
+ * Le funzioni sono constexpr: se gli argomenti sono costanti il risultato
+ * viene calcolato dal compilatore, es.
+ *   constexpr int64_t KB = potenzaVeloce(2, 10);
+ *
+ * Compilazione (C++17):
+ *   g++ -O2 -std=c++17 main_potenza_veloce.cpp potenza_veloce.cpp
+ */
+#ifndef POTENZA_VELOCE_H
+#define POTENZA_VELOCE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Calcola base^esponente con "square and multiply".
+ * Come la moltiplicazione tra unsigned, il risultato e' modulo 2^64:
+ * in caso di overflow non si ha comportamento indefinito ma un valore troncato.
+ * @param base la base
+ * @param esponente l'esponente (>= 0)
+ * @return base^esponente modulo 2^64
+ */
+constexpr int64_t potenzaVeloce(int64_t base, unsigned int esponente) {
+    uint64_t b = (uint64_t)base;
+    uint64_t risultato = 1;
+    while (esponente > 0) {
+        if (esponente & 1u) {
+            risultato *= b;
+        }
+        b *= b;
+        esponente >>= 1;
+    }
+    return (int64_t)risultato;
+}
+
+/**
+ * Calcola base^esponente controllando l'overflow.
+ * @param base la base
+ * @param esponente l'esponente (>= 0)
+ * @param risultato dove scrivere il risultato (non modificato in caso di overflow)
+ * @return true se il risultato sta in un int64_t, false in caso di overflow
+ */
+constexpr bool potenzaControllata(int64_t base, unsigned int esponente, int64_t *risultato) {
+    int64_t r = 1;
+    int64_t b = base;
+    while (esponente > 0) {
+        if (esponente & 1u) {
+            if (__builtin_mul_overflow(r, b, &r)) {
+                return false;
+            }
+        }
+        esponente >>= 1;
+        // Il quadrato serve solo se restano altri bit da elaborare
+        if (esponente > 0 && __builtin_mul_overflow(b, b, &b)) {
+            return false;
+        }
+    }
+    *risultato = r;
+    return true;
+}
+
+/**
+ * Calcola (a * b) mod modulo senza overflow usando un prodotto a 128 bit.
+ */
+constexpr uint64_t moltiplicaModulare(uint64_t a, uint64_t b, uint64_t modulo) {
+    return (uint64_t)(((unsigned __int128)a * b) % modulo);
+}
+
+/**
+ * Calcola base^esponente mod modulo con "square and multiply".
+ * @param base la base
+ * @param esponente l'esponente
+ * @param modulo il modulo (> 0)
+ * @return base^esponente mod modulo
+ */
+constexpr uint64_t potenzaModulare(uint64_t base, uint64_t esponente, uint64_t modulo) {
+    if (modulo == 1) {
+        return 0;
+    }
+    uint64_t risultato = 1;
+    base %= modulo;
+    while (esponente > 0) {
+        if (esponente & 1u) {
+            risultato = moltiplicaModulare(risultato, base, modulo);
+        }
+        base = moltiplicaModulare(base, base, modulo);
+        esponente >>= 1;
+    }
+    return risultato;
+}
+
+/**
+ * Calcola n potenze modulari con lo stesso modulo:
+ *   risultati[i] = basi[i]^esponenti[i] mod modulo
+ * Per moduli dispari minori di 2^63 usa la moltiplicazione di Montgomery,
+ * che sostituisce la divisione a 128 bit con due moltiplicazioni, ed elabora
+ * quattro potenze alla volta per sfruttare il parallelismo della CPU.
+ * Gli altri moduli usano potenzaModulare().
+ * risultati puo' coincidere con basi o con esponenti.
+ * @param basi le basi
+ * @param esponenti gli esponenti
+ * @param risultati dove scrivere le n potenze
+ * @param n il numero di potenze
+ * @param modulo il modulo (> 0: con 0 il resto non e' definito, come per potenzaModulare)
+ */
+void potenzaModulareBatch(const uint64_t basi[], const uint64_t esponenti[],
+                          uint64_t risultati[], size_t n, uint64_t modulo);
+
+#endif // POTENZA_VELOCE_H
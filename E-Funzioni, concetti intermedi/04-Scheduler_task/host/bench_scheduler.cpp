@@ -0,0 +1,102 @@
+/**
+ * @file bench_scheduler.cpp
+ * Benchmark dello scheduler sul PC con 100000 timer, confrontato con il
+ * metodo di 03-Led_task (ogni task controlla millis() ad ogni giro di loop).
+ *
+ * g++ -O2 -DSCHEDULER_MAX_TASK=100000 -DSCHEDULER_BIT_LIVELLO=8 bench_scheduler.cpp ../scheduler.cpp
+ * ./a.out [numero_timer] [durata_ms]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../scheduler.h"
+
+struct Contatore {
+  unsigned long periodo;
+  unsigned long esecuzioni;
+  unsigned long ultimoTick;  // usato dalla versione a scansione
+};
+
+static Contatore *contatori;
+static unsigned long adesso;
+static unsigned long errori = 0;
+
+static void task_conta(void *dati) {
+  Contatore *c = (Contatore *)dati;
+  c->esecuzioni++;
+  // Il task deve essere eseguito esattamente ogni periodo
+  if (adesso != c->esecuzioni * c->periodo) {
+    errori++;
+  }
+}
+
+static void task_singolo(void *dati) {
+  (*(unsigned long *)dati)++;
+}
+
+static double secondi() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[]) {
+  int n = argc > 1 ? atoi(argv[1]) : SCHEDULER_MAX_TASK - 1;
+  unsigned long durata = argc > 2 ? strtoul(argv[2], NULL, 10) : 60000;
+  if (n >= SCHEDULER_MAX_TASK) {
+    n = SCHEDULER_MAX_TASK - 1;
+  }
+  contatori = (Contatore *)calloc(n, sizeof(Contatore));
+  srand(1);
+
+  // Periodi tra 1 ms e 10 minuti, per esercitare tutti i livelli della ruota
+  schedulerInizializza(0);
+  for (int i = 0; i < n; i++) {
+    contatori[i].periodo = 1 + rand() % (i % 10 == 0 ? 600000 : 5000);
+    schedulerAggiungiPeriodico(task_conta, &contatori[i], contatori[i].periodo);
+  }
+  unsigned long singoloEseguito = 0;
+  schedulerAggiungiSingolo(task_singolo, &singoloEseguito, durata / 2);
+
+  double t0 = secondi();
+  unsigned long eseguiti = 0;
+  for (adesso = 1; adesso <= durata; adesso++) {
+    eseguiti += schedulerEsegui(adesso);
+  }
+  double t1 = secondi();
+
+  unsigned long attesi = 1;
+  for (int i = 0; i < n; i++) {
+    attesi += durata / contatori[i].periodo;
+  }
+  printf("timing wheel: %d timer, %lu ms simulati\n", n, durata);
+  printf("  %.1f ns/tick, %.1f ns/task eseguito, %lu esecuzioni (attese %lu), errori %lu, singolo %lu\n",
+         (t1 - t0) * 1e9 / durata, (t1 - t0) * 1e9 / eseguiti, eseguiti, attesi, errori,
+         singoloEseguito);
+
+  // Versione a scansione: ad ogni tick si controllano tutti i task
+  unsigned long durataScansione = durata < 2000 ? durata : 2000;
+  for (int i = 0; i < n; i++) {
+    contatori[i].esecuzioni = 0;
+    contatori[i].ultimoTick = 0;
+  }
+  errori = 0;
+  eseguiti = 0;
+  double t2 = secondi();
+  for (adesso = 1; adesso <= durataScansione; adesso++) {
+    for (int i = 0; i < n; i++) {
+      if (adesso - contatori[i].ultimoTick >= contatori[i].periodo) {
+        contatori[i].ultimoTick = adesso;
+        task_conta(&contatori[i]);
+        eseguiti++;
+      }
+    }
+  }
+  double t3 = secondi();
+  printf("scansione:    %d timer, %lu ms simulati\n", n, durataScansione);
+  printf("  %.1f ns/tick, %lu esecuzioni, errori %lu\n",
+         (t3 - t2) * 1e9 / durataScansione, eseguiti, errori);
+
+  free(contatori);
+  return 0;
+}
@@ -0,0 +1,232 @@
+/**
+ * @file scheduler.cpp
+ * @brief Implementazione dello scheduler con timing wheel gerarchica
+ *
+ * Ogni casella della ruota e' una lista doppiamente concatenata di task,
+ * realizzata con indici in un vettore di dimensione fissa (niente malloc).
+ * Un task con scadenza d si trova al livello L piu' basso per cui d e il tick
+ * corrente hanno uguali tutti i bit sopra il livello L: quando la ruota
+ * arriva a quella casella, il task scende di livello fino al livello 0, dove
+ * viene eseguito esattamente al tick d.
+ */
+#include "scheduler.h"
+
+#include <stddef.h>
+
+#define CASELLE (1 << SCHEDULER_BIT_LIVELLO)
+#define MASCHERA (CASELLE - 1)
+#define BIT_TEMPO (8 * sizeof(unsigned long))
+
+struct Task {
+  FunzioneTask funzione;
+  void *dati;
+  unsigned long scadenza;  // tick di esecuzione
+  unsigned long periodo;   // 0 = task singolo
+  int prossimo;            // task successivo nella casella (o nella lista libera)
+  int precedente;          // task precedente nella casella
+  int livello;             // livello della ruota (-1 = non inserito)
+  int casella;             // casella all'interno del livello
+  bool attivo;
+};
+
+static Task task[SCHEDULER_MAX_TASK];
+static int caselle[SCHEDULER_LIVELLI][CASELLE];  // primo task di ogni casella
+static int primoLibero;                          // lista dei task liberi
+static int numeroTask;
+static unsigned long tickCorrente;               // ultimo tick elaborato
+static int taskInEsecuzione;                     // task la cui funzione e' in corso
+static bool rimossoInEsecuzione;                 // il task in corso si e' rimosso
+
+// Restituisce x >> bit anche quando bit supera la dimensione di unsigned long
+static inline unsigned long shiftDestra(unsigned long x, unsigned int bit) {
+  return bit >= BIT_TEMPO ? 0 : x >> bit;
+}
+
+static void inserisci(int id) {
+  Task &t = task[id];
+  unsigned long d = t.scadenza;
+  int livello = -1;
+  int casella = 0;
+
+  for (int l = 0; l < SCHEDULER_LIVELLI; l++) {
+    unsigned int sopra = SCHEDULER_BIT_LIVELLO * (l + 1);
+    if (shiftDestra(d, sopra) == shiftDestra(tickCorrente, sopra)) {
+      livello = l;
+      casella = shiftDestra(d, SCHEDULER_BIT_LIVELLO * l) & MASCHERA;
+      break;
+    }
+  }
+  if (livello < 0) {
+    // Scadenza oltre la portata della ruota: il task viene parcheggiato nel
+    // livello piu' alto, in una casella che si raggiunge prima della scadenza
+    // e da cui verra' reinserito
+    const unsigned int bitAlto = SCHEDULER_BIT_LIVELLO * (SCHEDULER_LIVELLI - 1);
+    unsigned long giri = shiftDestra(d - tickCorrente, bitAlto);
+    if (giri < 1) giri = 1;
+    if (giri > MASCHERA) giri = MASCHERA;
+    livello = SCHEDULER_LIVELLI - 1;
+    casella = (shiftDestra(tickCorrente, bitAlto) + giri) & MASCHERA;
+  }
+
+  t.livello = livello;
+  t.casella = casella;
+  t.precedente = -1;
+  t.prossimo = caselle[livello][casella];
+  if (t.prossimo >= 0) {
+    task[t.prossimo].precedente = id;
+  }
+  caselle[livello][casella] = id;
+}
+
+static void scollega(int id) {
+  Task &t = task[id];
+  if (t.livello < 0) {
+    return;
+  }
+  if (t.precedente >= 0) {
+    task[t.precedente].prossimo = t.prossimo;
+  } else {
+    caselle[t.livello][t.casella] = t.prossimo;
+  }
+  if (t.prossimo >= 0) {
+    task[t.prossimo].precedente = t.precedente;
+  }
+  t.livello = -1;
+}
+
+static void libera(int id) {
+  task[id].attivo = false;
+  task[id].prossimo = primoLibero;
+  primoLibero = id;
+  numeroTask--;
+}
+
+static int aggiungi(FunzioneTask funzione, void *dati, unsigned long ritardo, unsigned long periodo) {
+  if (primoLibero < 0 || funzione == NULL) {
+    return SCHEDULER_NESSUN_TASK;
+  }
+  int id = primoLibero;
+  primoLibero = task[id].prossimo;
+  numeroTask++;
+
+  Task &t = task[id];
+  t.funzione = funzione;
+  t.dati = dati;
+  t.periodo = periodo;
+  // Un ritardo nullo indica il prossimo tick: quello corrente e' gia' elaborato
+  t.scadenza = tickCorrente + (ritardo > 0 ? ritardo : 1);
+  t.livello = -1;
+  t.attivo = true;
+  inserisci(id);
+  return id;
+}
+
+void schedulerInizializza(unsigned long adesso) {
+  for (int l = 0; l < SCHEDULER_LIVELLI; l++) {
+    for (int c = 0; c < CASELLE; c++) {
+      caselle[l][c] = -1;
+    }
+  }
+  // Tutti i task nella lista libera
+  for (int i = 0; i < SCHEDULER_MAX_TASK; i++) {
+    task[i].attivo = false;
+    task[i].livello = -1;
+    task[i].prossimo = i + 1 < SCHEDULER_MAX_TASK ? i + 1 : -1;
+  }
+  primoLibero = 0;
+  numeroTask = 0;
+  tickCorrente = adesso;
+  taskInEsecuzione = -1;
+  rimossoInEsecuzione = false;
+}
+
+int schedulerAggiungiPeriodico(FunzioneTask funzione, void *dati, unsigned long periodoMs) {
+  if (periodoMs == 0) {
+    periodoMs = 1;
+  }
+  return aggiungi(funzione, dati, periodoMs, periodoMs);
+}
+
+int schedulerAggiungiSingolo(FunzioneTask funzione, void *dati, unsigned long ritardoMs) {
+  return aggiungi(funzione, dati, ritardoMs, 0);
+}
+
+void schedulerRimuovi(int id) {
+  if (id < 0 || id >= SCHEDULER_MAX_TASK || !task[id].attivo) {
+    return;
+  }
+  if (id == taskInEsecuzione) {
+    // Verra' liberato al termine della sua funzione
+    rimossoInEsecuzione = true;
+    return;
+  }
+  scollega(id);
+  libera(id);
+}
+
+// Ridistribuisce sui livelli inferiori i task di una casella
+static void ridistribuisci(int livello, int casella) {
+  int id = caselle[livello][casella];
+  caselle[livello][casella] = -1;
+  while (id >= 0) {
+    int prossimo = task[id].prossimo;
+    task[id].livello = -1;
+    inserisci(id);
+    id = prossimo;
+  }
+}
+
+// Avanza di un tick ed esegue i task in scadenza
+static unsigned long avanzaTick() {
+  unsigned long eseguiti = 0;
+  tickCorrente++;
+
+  // Quando un livello completa un giro, scende la casella corrente del
+  // livello superiore (dall'alto verso il basso)
+  for (int l = SCHEDULER_LIVELLI - 1; l > 0; l--) {
+    unsigned long sotto = (1ul << (SCHEDULER_BIT_LIVELLO * l)) - 1;
+    if ((tickCorrente & sotto) == 0) {
+      ridistribuisci(l, shiftDestra(tickCorrente, SCHEDULER_BIT_LIVELLO * l) & MASCHERA);
+    }
+  }
+
+  // La casella corrente del livello 0 contiene i task in scadenza adesso
+  int casella = tickCorrente & MASCHERA;
+  while (caselle[0][casella] >= 0) {
+    int id = caselle[0][casella];
+    scollega(id);
+    Task &t = task[id];
+    if (t.scadenza != tickCorrente) {
+      inserisci(id);
+      continue;
+    }
+
+    taskInEsecuzione = id;
+    rimossoInEsecuzione = false;
+    t.funzione(t.dati);
+    taskInEsecuzione = -1;
+    eseguiti++;
+
+    if (t.periodo > 0 && !rimossoInEsecuzione) {
+      t.scadenza += t.periodo;
+      inserisci(id);
+    } else {
+      libera(id);
+    }
+  }
+  return eseguiti;
+}
+
+unsigned long schedulerEsegui(unsigned long adesso) {
+  unsigned long eseguiti = 0;
+  // Differenza con segno: un tempo gia' passato (adesso < tickCorrente) non fa
+  // avanzare lo scheduler, invece di fargli percorrere tutto il giro di unsigned long
+  while ((long)(adesso - tickCorrente) > 0) {
+    eseguiti += avanzaTick();
+  }
+  return eseguiti;
+}
+
+int schedulerNumeroTask() {
+  return numeroTask;
+}
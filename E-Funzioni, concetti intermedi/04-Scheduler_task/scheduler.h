@@ -0,0 +1,91 @@
+/**
+ * @file scheduler.h
+ * @brief Scheduler cooperativo di task periodici e singoli con timing wheel gerarchica
+ *
+ * In 03-Led_task ogni task controlla da solo, ad ogni giro di loop(), se e'
+ * trascorso il suo intervallo. Con molti task loop() finisce per controllarli
+ * tutti anche quando nessuno e' in scadenza.
+ *
+ * Qui i task vengono registrati una volta e inseriti in una "timing wheel":
+ * un orologio con SCHEDULER_LIVELLI quadranti da 2^SCHEDULER_BIT_LIVELLO
+ * caselle ciascuno. Il primo quadrante conta i millisecondi, il secondo i
+ * giri del primo e cosi' via. A ogni millisecondo si guarda una sola casella
+ * del primo quadrante, che contiene esattamente i task in scadenza; quando un
+ * quadrante completa un giro, la casella corrente del livello superiore viene
+ * ridistribuita su quelli inferiori. Il lavoro per tick e' O(1), piu' il
+ * costo dei soli task eseguiti.
+ *
+ * Le dimensioni si possono cambiare prima della compilazione, es. sul PC:
+ *   g++ -DSCHEDULER_MAX_TASK=100000 -DSCHEDULER_BIT_LIVELLO=8 ...
+ */
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+// Numero massimo di task registrati contemporaneamente
+#ifndef SCHEDULER_MAX_TASK
+#define SCHEDULER_MAX_TASK 8
+#endif
+
+// Ogni livello della ruota ha 2^SCHEDULER_BIT_LIVELLO caselle
+#ifndef SCHEDULER_BIT_LIVELLO
+#define SCHEDULER_BIT_LIVELLO 4
+#endif
+
+// Numero di livelli: i ritardi fino a 2^(BIT*LIVELLI) ms vengono inseriti
+// direttamente, quelli piu' lunghi vengono reinseriti a ogni giro completo
+#ifndef SCHEDULER_LIVELLI
+#define SCHEDULER_LIVELLI 4
+#endif
+
+// Identificativo restituito in caso di errore (nessun posto libero)
+#define SCHEDULER_NESSUN_TASK (-1)
+
+// Funzione eseguita dal task; dati e' il puntatore passato alla registrazione
+typedef void (*FunzioneTask)(void *dati);
+
+/**
+ * Inizializza lo scheduler e rimuove tutti i task.
+ * @param adesso il tempo corrente in millisecondi (es. millis())
+ */
+void schedulerInizializza(unsigned long adesso);
+
+/**
+ * Registra un task da eseguire ogni periodoMs millisecondi.
+ * La prima esecuzione avviene dopo periodoMs.
+ * @param funzione la funzione da eseguire
+ * @param dati puntatore passato alla funzione (puo' essere NULL)
+ * @param periodoMs il periodo in millisecondi (>= 1)
+ * @return l'identificativo del task, SCHEDULER_NESSUN_TASK se non c'e' posto
+ */
+int schedulerAggiungiPeriodico(FunzioneTask funzione, void *dati, unsigned long periodoMs);
+
+/**
+ * Registra un task da eseguire una sola volta dopo ritardoMs millisecondi.
+ * @param funzione la funzione da eseguire
+ * @param dati puntatore passato alla funzione (puo' essere NULL)
+ * @param ritardoMs il ritardo in millisecondi
+ * @return l'identificativo del task, SCHEDULER_NESSUN_TASK se non c'e' posto
+ */
+int schedulerAggiungiSingolo(FunzioneTask funzione, void *dati, unsigned long ritardoMs);
+
+/**
+ * Rimuove un task; puo' essere chiamata anche dall'interno di un task.
+ * @param id l'identificativo restituito dalla registrazione
+ */
+void schedulerRimuovi(int id);
+
+/**
+ * Fa avanzare lo scheduler fino al tempo adesso ed esegue i task scaduti.
+ * Va chiamata ad ogni giro di loop(). Un tempo precedente all'ultimo
+ * elaborato viene ignorato.
+ * @param adesso il tempo corrente in millisecondi (es. millis())
+ * @return il numero di task eseguiti
+ */
+unsigned long schedulerEsegui(unsigned long adesso);
+
+/**
+ * @return il numero di task registrati
+ */
+int schedulerNumeroTask();
+
+#endif // SCHEDULER_H
@@ -0,0 +1,64 @@
+/**
+ * Scheduler di task cooperativo
+ *
+ * Evoluzione di 03-Led_task: invece di scrivere in loop() un controllo di
+ * millis() per ogni task ("Altro task ..."), i task vengono registrati una
+ * volta nello scheduler, che esegue solo quelli in scadenza.
+ *  - il LED lampeggia ogni 200 ms (task periodico)
+ *  - ogni secondo viene stampato un messaggio sulla seriale (task periodico)
+ *  - dopo 5 secondi il lampeggio rallenta a 500 ms (task singolo)
+ *
+ * Per il benchmark sul PC vedere host/bench_scheduler.cpp
+ */
+#include "scheduler.h"
+
+const int LED_PIN = 4;  // Pin a cui è collegato il LED
+int led_stato=0; // Led spento
+int idLampeggio;  // Identificativo del task di lampeggio
+unsigned long secondi = 0;
+
+void led_configura() {
+  pinMode(LED_PIN, OUTPUT);
+}
+void led_accendi() {
+  digitalWrite(LED_PIN, HIGH);
+  led_stato=HIGH;
+}
+void led_spegni() {
+  digitalWrite(LED_PIN, LOW);
+  led_stato=LOW;
+}
+void led_inverti() {
+  (led_stato == LOW) ? led_accendi() : led_spegni();
+}
+
+//Task periodico: cambia lo stato del LED
+void task_lampeggio(void *) {  // nessun dato
+  led_inverti();
+}
+
+//Task periodico: stampa i secondi trascorsi
+void task_orologio(void *) {  // nessun dato
+  secondi++;
+  Serial.print("Secondi: ");
+  Serial.println(secondi);
+}
+
+//Task singolo: sostituisce il lampeggio veloce con uno lento
+void task_rallenta(void *) {  // nessun dato
+  schedulerRimuovi(idLampeggio);
+  idLampeggio = schedulerAggiungiPeriodico(task_lampeggio, NULL, 500);
+}
+
+void setup() {
+  Serial.begin(9600);
+  led_configura();  // Imposta il pin del LED come output
+
+  schedulerInizializza(millis());
+  idLampeggio = schedulerAggiungiPeriodico(task_lampeggio, NULL, 200);
+  schedulerAggiungiPeriodico(task_orologio, NULL, 1000);
+  schedulerAggiungiSingolo(task_rallenta, NULL, 5000);
+}
+void loop() {
+  schedulerEsegui(millis()); // Esegue i task in scadenza
+}
@@ -0,0 +1,109 @@
+/**
+ * @file main_vettori_grandi.c
+ * @brief Confronto tra malloc+memset, mmap pigra, pagine da 2 MB e precarica
+ *
+ * Per ogni modo crea un vettore di int a zero, lo scrive una volta tutto
+ * (vet[i] = i) e stampa il tempo di creazione, il tempo della scrittura, i
+ * page fault e quanti byte sono finiti in pagine da 2 MB.
+ *
+ * Compilazione:
+ *   gcc -O2 -std=c11 -pthread main_vettori_grandi.c vettori_grandi.c -o main_vettori_grandi
+ * Utilizzo:
+ *   ./main_vettori_grandi [megabyte] [thread]     (predefiniti: 1024 e tutti i processori)
+ */
+#define _POSIX_C_SOURCE 199309L   // clock_gettime con -std=c11
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vettori_grandi.h"
+
+// Chiamata attraverso un puntatore volatile: il compilatore trasformerebbe malloc + memset a zero
+// in calloc, che per blocchi grandi usa proprio mmap e non azzera niente
+static void *(*volatile azzera)(void *, int, size_t) = memset;
+
+static double secondi() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Scrive tutto il vettore e restituisce un valore per non far eliminare il ciclo
+static long long scrivi(int vet[], size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        vet[i] = (int)i;
+    }
+    return vet[n / 2] + vet[n - 1];
+}
+
+static void stampaRiga(const char *nome, double creazione, double scrittura, const PageFault *prima,
+                       const PageFault *dopo, size_t pagineGrandi) {
+    printf("%-22s %12.2f %12.2f %12ld %12zu\n", nome, creazione * 1e3, scrittura * 1e3,
+           dopo->minori - prima->minori, pagineGrandi >> 20);
+}
+
+static int provaMmap(const char *nome, size_t byte, int opzioni, unsigned thread) {
+    VettoreGrande v;
+    PageFault prima, dopo;
+    pageFaultLeggi(&prima);
+    double t0 = secondi();
+    if (vettoreGrandeCrea(&v, byte, opzioni, thread) != 0) {
+        perror(nome);
+        return 1;
+    }
+    double t1 = secondi();
+    // Senza precarica il vettore non occupa memoria ma si legge come tutto a zero
+    int *vet = vettoreGrandeInt(&v);
+    size_t n = byte / sizeof(int);
+    if (vet[0] != 0 || vet[n - 1] != 0) {
+        printf("%s: il vettore non e' a zero\n", nome);
+    }
+    long long controllo = scrivi(vet, n);
+    double t2 = secondi();
+    pageFaultLeggi(&dopo);
+    stampaRiga(nome, t1 - t0, t2 - t1, &prima, &dopo, vettoreGrandeByteInPagineGrandi(&v));
+    vettoreGrandeLibera(&v);
+    return controllo == 0;
+}
+
+int main(int argc, char *argv[]) {
+    size_t megabyte = argc > 1 ? strtoul(argv[1], NULL, 10) : 1024;
+    unsigned thread = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 10) : 0;
+    size_t byte = megabyte << 20;
+    size_t n = byte / sizeof(int);
+    if (n == 0) {
+        printf("Dimensione non valida\n");
+        return 1;
+    }
+    printf("Vettore di %zu MB (%zu int)\n\n", megabyte, n);
+    printf("%-22s %12s %12s %12s %12s\n", "modo", "creazione ms", "scrittura ms", "page fault", "MB in 2 MB");
+
+    // Riferimento: malloc e azzeramento esplicito
+    PageFault prima, dopo;
+    pageFaultLeggi(&prima);
+    double t0 = secondi();
+    int *vet = malloc(byte);
+    if (vet == NULL) {
+        printf("Memoria insufficiente\n");
+        return 1;
+    }
+    azzera(vet, 0, byte);
+    double t1 = secondi();
+    long long controllo = scrivi(vet, n);
+    double t2 = secondi();
+    pageFaultLeggi(&dopo);
+    stampaRiga("malloc + memset", t1 - t0, t2 - t1, &prima, &dopo, 0);
+    free(vet);
+
+    int errori = 0;
+    errori += provaMmap("mmap pigra", byte, VETTORE_PIGRO, thread);
+    errori += provaMmap("pagine da 2 MB", byte, VETTORE_PAGINE_GRANDI, thread);
+    errori += provaMmap("precarica", byte, VETTORE_PRECARICA, thread);
+    errori += provaMmap("2 MB + precarica", byte, VETTORE_PAGINE_GRANDI | VETTORE_PRECARICA, thread);
+
+    printf("\nLa creazione con mmap pigra costa pochi microsecondi: i page fault si pagano alla\n"
+           "prima scrittura. Le pagine da 2 MB (se il kernel le concede) riducono i fault di 512\n"
+           "volte; la precarica li sposta nella creazione, divisi tra i thread.\n");
+    return controllo == 0 || errori > 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file vettori_grandi.c
+ * @brief Creazione con mmap, allineamento a 2 MB e precarica in parallelo
+ */
+#define _GNU_SOURCE   // MADV_HUGEPAGE, MAP_ANONYMOUS con -std=c11
+#include "vettori_grandi.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#define PAGINA_GRANDE ((size_t)2 << 20)
+#define MASSIMO_THREAD 64
+
+static size_t arrotonda(size_t n, size_t multiplo) {
+    return (n + multiplo - 1) / multiplo * multiplo;
+}
+
+int vettoreGrandeCrea(VettoreGrande *v, size_t byte, int opzioni, unsigned thread) {
+    size_t pagina = (size_t)sysconf(_SC_PAGESIZE);
+    size_t allineamento = (opzioni & VETTORE_PAGINE_GRANDI) ? PAGINA_GRANDE : pagina;
+    size_t mappati = arrotonda(byte > 0 ? byte : 1, allineamento);
+    // Con le pagine grandi si chiede un allineamento in piu' e si tagliano inizio e fine
+    size_t richiesti = mappati + (allineamento > pagina ? allineamento : 0);
+    char *p = mmap(NULL, richiesti, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        return -1;
+    }
+    char *inizio = (char *)arrotonda((uintptr_t)p, allineamento);
+    if (inizio > p) {
+        munmap(p, inizio - p);
+    }
+    if (p + richiesti > inizio + mappati) {
+        munmap(inizio + mappati, p + richiesti - (inizio + mappati));
+    }
+#ifdef MADV_HUGEPAGE
+    if (opzioni & VETTORE_PAGINE_GRANDI) {
+        // Se il kernel non ha le transparent huge pages il vettore usa pagine normali
+        madvise(inizio, mappati, MADV_HUGEPAGE);
+    }
+#endif
+    v->dati = inizio;
+    v->byte = byte;
+    v->mappati = mappati;
+    if (opzioni & VETTORE_PRECARICA) {
+        vettoreGrandePrecarica(v, thread);
+    }
+    return 0;
+}
+
+typedef struct {
+    char *inizio;
+    size_t byte;
+} PartePrecarica;
+
+static void *precaricaParte(void *argomento) {
+    PartePrecarica *parte = argomento;
+#ifdef MADV_POPULATE_WRITE
+    // Linux 5.14 o successivo: il kernel alloca le pagine senza un fault per pagina
+    if (madvise(parte->inizio, parte->byte, MADV_POPULATE_WRITE) == 0) {
+        return NULL;
+    }
+#endif
+    // Una scrittura per pagina: l'addizione atomica di 0 non cambia il contenuto ma
+    // e' un accesso in scrittura, che alloca la pagina (una lettura mapperebbe solo
+    // la pagina di zeri condivisa)
+    size_t pagina = (size_t)sysconf(_SC_PAGESIZE);
+    for (size_t k = 0; k < parte->byte; k += pagina) {
+        __atomic_fetch_add(parte->inizio + k, 0, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+void vettoreGrandePrecarica(VettoreGrande *v, unsigned thread) {
+    if (thread == 0) {
+        long processori = sysconf(_SC_NPROCESSORS_ONLN);
+        thread = processori > 0 ? (unsigned)processori : 1;
+    }
+    if (thread > MASSIMO_THREAD) {
+        thread = MASSIMO_THREAD;
+    }
+    // Parti multiple di 2 MB, per non dividere una pagina grande tra due thread
+    size_t passo = arrotonda((v->mappati + thread - 1) / thread, PAGINA_GRANDE);
+    PartePrecarica parti[MASSIMO_THREAD];
+    pthread_t id[MASSIMO_THREAD];
+    unsigned avviati = 0;
+    for (unsigned t = 0; t < thread && (size_t)t * passo < v->mappati; t++) {
+        size_t da = (size_t)t * passo;
+        parti[t].inizio = (char *)v->dati + da;
+        parti[t].byte = v->mappati - da < passo ? v->mappati - da : passo;
+        avviati++;
+    }
+    // Il thread chiamante fa la prima parte
+    for (unsigned t = 1; t < avviati; t++) {
+        if (pthread_create(&id[t], NULL, precaricaParte, &parti[t]) != 0) {
+            precaricaParte(&parti[t]);
+            id[t] = 0;
+        }
+    }
+    if (avviati > 0) {
+        precaricaParte(&parti[0]);
+    }
+    for (unsigned t = 1; t < avviati; t++) {
+        if (id[t] != 0) {
+            pthread_join(id[t], NULL);
+        }
+    }
+}
+
+void vettoreGrandeLibera(VettoreGrande *v) {
+    if (v->dati != NULL) {
+        munmap(v->dati, v->mappati);
+    }
+    v->dati = NULL;
+    v->byte = 0;
+    v->mappati = 0;
+}
+
+size_t vettoreGrandeByteInPagineGrandi(const VettoreGrande *v) {
+    FILE *f = fopen("/proc/self/smaps", "r");
+    if (f == NULL) {
+        return 0;
+    }
+    uintptr_t inizio = (uintptr_t)v->dati;
+    uintptr_t fine = inizio + v->mappati;
+    char riga[256];
+    int dentro = 0;
+    size_t byte = 0;
+    while (fgets(riga, sizeof(riga), f) != NULL) {
+        unsigned long da;
+        unsigned long a;
+        size_t kb;
+        // Le righe "inizio-fine ..." aprono una mappatura, le altre ne descrivono i dettagli
+        if (sscanf(riga, "%lx-%lx ", &da, &a) == 2) {
+            dentro = da < fine && a > inizio;
+        } else if (dentro && sscanf(riga, "AnonHugePages: %zu kB", &kb) == 1) {
+            byte += kb * 1024;
+        }
+    }
+    fclose(f);
+    return byte;
+}
+
+void pageFaultLeggi(PageFault *pf) {
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    pf->minori = uso.ru_minflt;
+    pf->maggiori = uso.ru_majflt;
+}
@@ -3,8 +3,11 @@
  *
  * Questo programma implementa un sistema di riconoscimento di sequenza utilizzando Arduino.
  * L'utente inserisce una sequenza continua di caratteri tramite la linea seriale.
- * La sequenza viene memorizzata in un array e, quando l'array è completo, i valori vengono
- * shiftati a sinistra per fare spazio al nuovo carattere letto.
+ * Gli ultimi caratteri ricevuti vengono memorizzati in un buffer circolare: il nuovo
+ * carattere sovrascrive il più vecchio, senza spostare gli altri.
+ * Il confronto con la sequenza predefinita non rilegge tutto il buffer: un riconoscitore
+ * KMP (Knuth-Morris-Pratt) ricorda quanti caratteri della sequenza sono già stati
+ * trovati e, ad ogni carattere, aggiorna solo questo stato.
  *
  * Se la sequenza inserita corrisponde a una sequenza predefinita, un LED verde lampeggia
  * e rimane acceso, indicando che l'allarme è attivato.
@@ -14,34 +17,61 @@
  * https://wokwi.com/projects/419596014187366401
  * https://github.com/filippo-bilardo/INFORMATICA_1/blob/a359542667b12596fbf0b84d4f4c12642d9b6184/F-Strutture_dati/ES02_Riconoscitore_sequenza/README.md
  *
+ * I lampeggi dei LED non usano delay(): ogni LED ha uno stato di lampeggio
+ * aggiornato ad ogni giro di loop() con millis(), cosi' i caratteri in arrivo
+ * sulla seriale vengono letti anche mentre i LED lampeggiano.
+ *
  * @author Filippo Bilardo
  * @version 1.0 17/03/25 - Versione iniziale
+ * @version 1.1 18/10/26 - Lampeggio dei LED non bloccante
+ * @version 1.2 18/10/26 - Buffer circolare e riconoscitore KMP al posto dello shift
+ * @version 1.3 18/10/26 - Messaggi seriali composti in un buffer e inviati con una sola scrittura
+ * @version 1.4 18/10/26 - Il lampeggio di ricezione non interrompe quello dell'allarme
  */
 #include <Arduino.h>
+#include <MessaggioSeriale.h>
 
 const int PIN_LED_VERDE = 8;                                             // Pin per il LED verde
 const int PIN_LED_ROSSO = 13;                                            // Pin per il LED rosso
 const int LUNGHEZZA_SEQUENZA = 6;                                        // Lunghezza della sequenza da riconoscere
-char sequenzaInput[LUNGHEZZA_SEQUENZA] = {'9', '9', '9', '9', '9', '9'}; // Inizializza l'array
+char sequenzaInput[LUNGHEZZA_SEQUENZA] = {'9', '9', '9', '9', '9', '9'}; // Buffer circolare degli ultimi caratteri
+int indiceInput = 0;                                                     // Posizione del carattere più vecchio
 char sequenzaCorretta[] = {'a','2','3','4','5','Z'};                     // Sequenza predefinita da riconoscere
+int prefissoSuffisso[LUNGHEZZA_SEQUENZA];                                // Tabella KMP della sequenza corretta
+int caratteriRiconosciuti = 0;                                           // Stato del riconoscitore KMP
 bool allarmeAttivo = false;                                              // Stato dell'allarme (attivo/disattivo)
+const unsigned long DURATA_RICEZIONE_MS = 50;                            // Durata del lampeggio di ricezione
+
+// Stato di un lampeggio in corso su un LED
+struct Lampeggio
+{
+    int pin;                    // Pin del LED
+    int fasiRimaste;            // Accensioni e spegnimenti ancora da eseguire
+    unsigned long durataFaseMs; // Durata di ogni fase in millisecondi
+    unsigned long inizioFase;   // Istante di inizio della fase corrente (millis)
+    bool acceso;                // Stato corrente del LED
+    bool accesoAllaFine;        // Stato in cui lasciare il LED al termine
+};
+Lampeggio lampeggioVerde = {PIN_LED_VERDE, 0, 0, 0, false, false};
+Lampeggio lampeggioRosso = {PIN_LED_ROSSO, 0, 0, 0, false, false};
 
 // Prototipi delle funzioni
 void LedVerdeConfigura();
 void LedVerdeAccendi();
 void LedVerdeSpegni();
-void LedVerdeLampeggia(int volte, int ritardoMs);
+void LedVerdeLampeggia(int volte, int ritardoMs, bool accesoAllaFine);
 void LedRossoConfigura();
 void LedRossoAccendi();
 void LedRossoSpegni();
-void LedRossoLampeggia(int volte, int ritardoMs);
+void LedRossoLampeggia(int volte, int ritardoMs, bool accesoAllaFine);
+void LampeggioAvvia(Lampeggio &lampeggio, int fasi, unsigned long durataFaseMs, bool accesoAllaFine);
+void LampeggioAggiorna(Lampeggio &lampeggio, unsigned long adesso);
 void SerialeMostraRicezione(char carattereInput);
-void AllarmeMostraStato();
 void AllarmeImpostaStato(bool attivo);
-void ArrayShiftSinistra(char array[], int dimensione);
-void ArrayImpostaValoreElemento(char array[], char valore, int posizione);
-bool ArrayConfronta(char array1[], char array2[], int dimensione);
+void BufferInserisci(char valore);
 void ArrayStampa();
+void RiconoscitorePrepara(char sequenza[], int dimensione);
+bool RiconoscitoreAggiorna(char carattere);
 
 
 void setup()
@@ -49,6 +79,7 @@ void setup()
     Serial.begin(9600); // Inizializza la comunicazione seriale
     LedVerdeConfigura(); // Configura il pin del LED verde
     LedRossoConfigura(); // Configura il pin del LED rosso
+    RiconoscitorePrepara(sequenzaCorretta, LUNGHEZZA_SEQUENZA); // Prepara la tabella KMP
     
     // Messaggio iniziale
     Serial.println("Sistema di riconoscimento sequenza avviato");
@@ -57,6 +88,11 @@ void setup()
 
 void loop()
 {
+    // Fa avanzare i lampeggi in corso senza bloccare la lettura della seriale
+    unsigned long adesso = millis();
+    LampeggioAggiorna(lampeggioVerde, adesso);
+    LampeggioAggiorna(lampeggioRosso, adesso);
+
     // Controlla se è disponibile un carattere da leggere dalla linea seriale
     if (Serial.available() > 0)
     {
@@ -69,15 +105,13 @@ void loop()
             // Indica la ricezione di un carattere
             SerialeMostraRicezione(carattereInput);
 
-            // Aggiorna la sequenza
-            ArrayShiftSinistra(sequenzaInput, LUNGHEZZA_SEQUENZA);
-            // Aggiunge il nuovo carattere alla fine dell'array
-            ArrayImpostaValoreElemento(sequenzaInput, carattereInput, LUNGHEZZA_SEQUENZA - 1);
+            // Aggiunge il nuovo carattere al buffer circolare
+            BufferInserisci(carattereInput);
             // Stampa la sequenza corrente
             ArrayStampa();
 
-            // Verifica se la sequenza corrisponde a quella corretta
-            if (ArrayConfronta(sequenzaInput, sequenzaCorretta, LUNGHEZZA_SEQUENZA))
+            // Verifica se gli ultimi caratteri corrispondono alla sequenza corretta
+            if (RiconoscitoreAggiorna(carattereInput))
             {
                 Serial.println("Sequenza riconosciuta!");
 
@@ -90,40 +124,87 @@ void loop()
 
 
 /**
- * Imposta il valore di un elemento dell'array
- * @param array L'array da modificare
- * @param valore Il valore da impostare
- * @param posizione La posizione dell'elemento da modificare
+ * Inserisce un carattere nel buffer circolare al posto del più vecchio
+ * @param valore Il carattere da inserire
  */
-void ArrayImpostaValoreElemento(char array[], char valore, int posizione)
+void BufferInserisci(char valore)
 {
+    sequenzaInput[indiceInput] = valore;
+    indiceInput++;
+    if (indiceInput == LUNGHEZZA_SEQUENZA)
+    {
+        indiceInput = 0;
+    }
 }
 
 /**
- * Sposta tutti gli elementi dell'array di una posizione a sinistra
- * @param array L'array da modificare
- * @param dimensione La dimensione dell'array
+ * Stampa il contenuto del buffer circolare, dal carattere più vecchio al più recente.
+ * Le due parti del buffer (dal più vecchio alla fine, e dall'inizio al più recente)
+ * vengono copiate nel messaggio, inviato con una sola scrittura
  */
-void ArrayShiftSinistra(char array[], int dimensione)
+void ArrayStampa()
 {
+    char buffer[16 + LUNGHEZZA_SEQUENZA];
+    MessaggioSeriale m;
+    messaggioInizia(m, buffer, sizeof(buffer));
+    messaggioTesto(m, "Sequenza: ");
+    messaggioByte(m, &sequenzaInput[indiceInput], LUNGHEZZA_SEQUENZA - indiceInput);
+    messaggioByte(m, sequenzaInput, indiceInput);
+    messaggioACapo(m);
+    messaggioInvia(m, Serial);
 }
 
 /**
- * Verifica se due array sono identici
- * @param array1 Il primo array da confrontare
- * @param array2 Il secondo array da confrontare
- * @param dimensione La dimensione degli array
- * @return true se gli array sono identici, false altrimenti
+ * Prepara la tabella KMP della sequenza da riconoscere.
+ * prefissoSuffisso[i] è la lunghezza del più lungo prefisso della sequenza che è
+ * anche suffisso dei primi i+1 caratteri: dopo un carattere sbagliato indica
+ * quanti caratteri già ricevuti possono ancora essere l'inizio della sequenza
+ * @param sequenza La sequenza da riconoscere
+ * @param dimensione La lunghezza della sequenza
  */
-bool ArrayConfronta(char array1[], char array2[], int dimensione)
+void RiconoscitorePrepara(char sequenza[], int dimensione)
 {
+    prefissoSuffisso[0] = 0;
+    int lunghezza = 0;
+    for (int i = 1; i < dimensione; i++)
+    {
+        while (lunghezza > 0 && sequenza[i] != sequenza[lunghezza])
+        {
+            lunghezza = prefissoSuffisso[lunghezza - 1];
+        }
+        if (sequenza[i] == sequenza[lunghezza])
+        {
+            lunghezza++;
+        }
+        prefissoSuffisso[i] = lunghezza;
+    }
+    caratteriRiconosciuti = 0;
 }
 
 /**
- * Stampa il contenuto dell'array
+ * Aggiorna il riconoscitore con un nuovo carattere.
+ * Il ciclo while arretra al massimo di tanti passi quanti caratteri sono stati
+ * riconosciuti in precedenza: in media il lavoro per carattere è costante
+ * @param carattere Il carattere ricevuto
+ * @return true se gli ultimi caratteri ricevuti formano la sequenza corretta
  */
-void ArrayStampa()
+bool RiconoscitoreAggiorna(char carattere)
 {
+    while (caratteriRiconosciuti > 0 && carattere != sequenzaCorretta[caratteriRiconosciuti])
+    {
+        caratteriRiconosciuti = prefissoSuffisso[caratteriRiconosciuti - 1];
+    }
+    if (carattere == sequenzaCorretta[caratteriRiconosciuti])
+    {
+        caratteriRiconosciuti++;
+    }
+    if (caratteriRiconosciuti == LUNGHEZZA_SEQUENZA)
+    {
+        // Le sequenze possono sovrapporsi: si riparte dal bordo più lungo
+        caratteriRiconosciuti = prefissoSuffisso[LUNGHEZZA_SEQUENZA - 1];
+        return true;
+    }
+    return false;
 }
 
 //----------------------------------------------------------------------
@@ -154,19 +235,15 @@ void LedVerdeSpegni()
 }
 
 /**
- * Fa lampeggiare il LED verde per un determinato numero di volte
+ * Avvia il lampeggio del LED verde per un determinato numero di volte.
+ * La funzione ritorna subito: il lampeggio prosegue nei successivi giri di loop()
  * @param volte Il numero di volte che il LED deve lampeggiare
  * @param ritardoMs Il tempo di attesa tra un lampeggio e l'altro in millisecondi
+ * @param accesoAllaFine true per lasciare il LED acceso al termine del lampeggio
  */
-void LedVerdeLampeggia(int volte, int ritardoMs)
+void LedVerdeLampeggia(int volte, int ritardoMs, bool accesoAllaFine)
 {
-    for (int i = 0; i < volte; i++)
-    {
-        LedVerdeAccendi();
-        delay(ritardoMs);
-        LedVerdeSpegni();
-        delay(ritardoMs);
-    }
+    LampeggioAvvia(lampeggioVerde, 2 * volte, ritardoMs, accesoAllaFine);
 }
 
 
@@ -194,52 +271,77 @@ void LedRossoSpegni()
     digitalWrite(PIN_LED_ROSSO, LOW);
 }
 /**
- * Fa lampeggiare il LED rosso per un determinato numero di volte
+ * Avvia il lampeggio del LED rosso per un determinato numero di volte.
+ * La funzione ritorna subito: il lampeggio prosegue nei successivi giri di loop()
  * @param volte Il numero di volte che il LED deve lampeggiare
  * @param ritardoMs Il tempo di attesa tra un lampeggio e l'altro in millisecondi
+ * @param accesoAllaFine true per lasciare il LED acceso al termine del lampeggio
  */
-void LedRossoLampeggia(int volte, int ritardoMs)
+void LedRossoLampeggia(int volte, int ritardoMs, bool accesoAllaFine)
 {
-    for (int i = 0; i < volte; i++)
-    {
-        LedRossoAccendi();
-        delay(ritardoMs);
-        LedRossoSpegni();
-        delay(ritardoMs);
-    }
+    LampeggioAvvia(lampeggioRosso, 2 * volte, ritardoMs, accesoAllaFine);
 }
 
 /**
- * Indica la ricezione di un carattere facendo lampeggiare brevemente entrambi i LED
- * @param carattereInput Il carattere ricevuto
+ * Avvia un lampeggio: il LED si accende e poi cambia stato ad ogni fase.
+ * Un lampeggio gia' in corso sullo stesso LED viene sostituito
+ * @param lampeggio Lo stato del lampeggio del LED
+ * @param fasi Il numero di fasi (accensioni + spegnimenti), 0 per impostare subito lo stato finale
+ * @param durataFaseMs La durata di ogni fase in millisecondi
+ * @param accesoAllaFine true per lasciare il LED acceso al termine del lampeggio
  */
-void SerialeMostraRicezione(char carattereInput)
+void LampeggioAvvia(Lampeggio &lampeggio, int fasi, unsigned long durataFaseMs, bool accesoAllaFine)
 {
-    LedVerdeAccendi();
-    LedRossoAccendi();
-    Serial.print("Ricevuto: ");
-    Serial.println(carattereInput);
-    delay(50);
-
-    // Mostra lo stato dell'allarme
-    AllarmeMostraStato();
+    lampeggio.fasiRimaste = fasi;
+    lampeggio.durataFaseMs = durataFaseMs;
+    lampeggio.inizioFase = millis();
+    lampeggio.accesoAllaFine = accesoAllaFine;
+    lampeggio.acceso = fasi > 0 ? true : accesoAllaFine;
+    digitalWrite(lampeggio.pin, lampeggio.acceso ? HIGH : LOW);
 }
 
 /**
- * Mostra lo stato dell'allarme (attivo/disattivo)
+ * Fa avanzare un lampeggio in corso; va chiamata ad ogni giro di loop()
+ * @param lampeggio Lo stato del lampeggio del LED
+ * @param adesso Il tempo corrente in millisecondi (millis())
  */
-void AllarmeMostraStato()
+void LampeggioAggiorna(Lampeggio &lampeggio, unsigned long adesso)
 {
-    if (allarmeAttivo)
+    if (lampeggio.fasiRimaste == 0 || adesso - lampeggio.inizioFase < lampeggio.durataFaseMs)
     {
-        LedVerdeAccendi();
-        LedRossoSpegni();
+        return;
     }
-    else
+    // La fase successiva parte dalla fine della precedente, non da adesso,
+    // cosi' un loop() lento non allunga il lampeggio
+    lampeggio.inizioFase += lampeggio.durataFaseMs;
+    lampeggio.fasiRimaste--;
+    lampeggio.acceso = lampeggio.fasiRimaste > 0 ? !lampeggio.acceso : lampeggio.accesoAllaFine;
+    digitalWrite(lampeggio.pin, lampeggio.acceso ? HIGH : LOW);
+}
+
+/**
+ * Indica la ricezione di un carattere facendo lampeggiare brevemente entrambi i LED.
+ * Se un LED sta gia' lampeggiando (lampeggio dell'allarme o di una ricezione
+ * precedente) i LED non vengono toccati, per non interrompere il lampeggio in corso
+ * @param carattereInput Il carattere ricevuto
+ */
+void SerialeMostraRicezione(char carattereInput)
+{
+    char buffer[16];
+    MessaggioSeriale m;
+    messaggioInizia(m, buffer, sizeof(buffer));
+    messaggioTesto(m, "Ricevuto: ");
+    messaggioCarattere(m, carattereInput);
+    messaggioACapo(m);
+    messaggioInvia(m, Serial);
+
+    if (lampeggioVerde.fasiRimaste > 0 || lampeggioRosso.fasiRimaste > 0)
     {
-        LedVerdeSpegni();
-        LedRossoAccendi();
+        return;
     }
+    // Entrambi i LED accesi per DURATA_RICEZIONE_MS, poi lo stato dell'allarme
+    LampeggioAvvia(lampeggioVerde, 1, DURATA_RICEZIONE_MS, allarmeAttivo);
+    LampeggioAvvia(lampeggioRosso, 1, DURATA_RICEZIONE_MS, !allarmeAttivo);
 }
 
 /**
@@ -254,17 +356,15 @@ void AllarmeImpostaStato(bool attivo)
     {
         // Attiva l'allarme
         Serial.println("Allarme attivato");
-        LedVerdeLampeggia(3, 200);
-        LedVerdeAccendi();
-        LedRossoSpegni();
+        LampeggioAvvia(lampeggioRosso, 0, 0, false);
+        LedVerdeLampeggia(3, 200, true);
     }
     else
     {
         // Disattiva l'allarme
         Serial.println("Allarme disattivato");
-        LedRossoLampeggia(3, 200);
-        LedRossoAccendi();
-        LedVerdeSpegni();
+        LampeggioAvvia(lampeggioVerde, 0, 0, false);
+        LedRossoLampeggia(3, 200, true);
     }
 }
 
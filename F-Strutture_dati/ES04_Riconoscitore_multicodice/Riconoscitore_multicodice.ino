@@ -0,0 +1,231 @@
+/**
+ * Riconoscitore di piu' codici
+ *
+ * Evoluzione di ES02_Riconoscitore_sequenza: invece di una sola sequenza, il
+ * programma riconosce contemporaneamente tutti i codici della tabella codici[],
+ * ognuno con la propria azione (attivare o disattivare l'allarme, lampeggiare
+ * un LED, stampare lo stato...).
+ *
+ * All'avvio i codici vengono trasformati in un automa di Aho-Corasick
+ * (aho_corasick.h): ad ogni carattere ricevuto basta una lettura in tabella,
+ * sia con 3 codici sia con 300. I codici possono sovrapporsi o essere uno la
+ * parte finale dell'altro: vengono riconosciuti tutti.
+ *
+ * Collegamenti: LED verde sul pin 8, LED rosso sul pin 13 (come in ES02).
+ *
+ * @author Filippo Bilardo
+ * @version 1.0 18/10/26 - Versione iniziale
+ */
+#include <Arduino.h>
+#include "aho_corasick.h"
+
+const int PIN_LED_VERDE = 8;          // Pin per il LED verde
+const int PIN_LED_ROSSO = 13;         // Pin per il LED rosso
+const unsigned long DURATA_FASE_MS = 200; // Durata di accensione/spegnimento nei lampeggi
+
+// Azioni associate ai codici
+enum Azione
+{
+    AZIONE_ATTIVA,          // Attiva l'allarme
+    AZIONE_DISATTIVA,       // Disattiva l'allarme
+    AZIONE_COMMUTA,         // Cambia lo stato dell'allarme
+    AZIONE_LAMPEGGIA_VERDE, // Lampeggio di prova del LED verde
+    AZIONE_LAMPEGGIA_ROSSO, // Lampeggio di prova del LED rosso
+    AZIONE_STATO            // Stampa lo stato dell'allarme
+};
+
+// Tabella dei codici: codici[i] esegue azioni[i]
+const char *const codici[] = {
+    "a2345Z",   // il codice di ES02
+    "ON1234",
+    "OFF1234",
+    "1234",     // parte finale di ON1234 e OFF1234: riconosciuto insieme a loro
+    "VVV",
+    "RRR",
+    "??",
+};
+const Azione azioni[] = {
+    AZIONE_COMMUTA,
+    AZIONE_ATTIVA,
+    AZIONE_DISATTIVA,
+    AZIONE_STATO,
+    AZIONE_LAMPEGGIA_VERDE,
+    AZIONE_LAMPEGGIA_ROSSO,
+    AZIONE_STATO,
+};
+const uint16_t NUMERO_CODICI = sizeof(codici) / sizeof(codici[0]);
+
+AutomaAC automa;                // Automa costruito all'avvio dai codici
+uint16_t statoAutoma = 0;       // Stato corrente del riconoscitore
+bool allarmeAttivo = false;     // Stato dell'allarme (attivo/disattivo)
+
+// Stato di un lampeggio in corso su un LED (come in ES02)
+struct Lampeggio
+{
+    int pin;                    // Pin del LED
+    int fasiRimaste;            // Accensioni e spegnimenti ancora da eseguire
+    unsigned long durataFaseMs; // Durata di ogni fase in millisecondi
+    unsigned long inizioFase;   // Istante di inizio della fase corrente (millis)
+    bool acceso;                // Stato corrente del LED
+    bool accesoAllaFine;        // Stato in cui lasciare il LED al termine
+};
+Lampeggio lampeggioVerde = {PIN_LED_VERDE, 0, 0, 0, false, false};
+Lampeggio lampeggioRosso = {PIN_LED_ROSSO, 0, 0, 0, false, false};
+
+// Prototipi delle funzioni
+void LampeggioAvvia(Lampeggio &lampeggio, int fasi, unsigned long durataFaseMs, bool accesoAllaFine);
+void LampeggioAggiorna(Lampeggio &lampeggio, unsigned long adesso);
+void CodiceEsegui(uint16_t codice);
+void AllarmeImpostaStato(bool attivo);
+void AllarmeMostraStato();
+
+
+void setup()
+{
+    Serial.begin(9600);
+    pinMode(PIN_LED_VERDE, OUTPUT);
+    pinMode(PIN_LED_ROSSO, OUTPUT);
+    AllarmeMostraStato();
+
+    if (!acCostruisci(&automa, codici, NUMERO_CODICI))
+    {
+        Serial.println("Memoria insufficiente per l'automa dei codici");
+        while (true)
+        {
+        }
+    }
+
+    Serial.println("Sistema di riconoscimento codici avviato");
+    Serial.print("Codici: ");
+    Serial.print(NUMERO_CODICI);
+    Serial.print(", stati: ");
+    Serial.print(automa.numeroStati);
+    Serial.print(", classi di caratteri: ");
+    Serial.println(automa.numeroClassi);
+}
+
+void loop()
+{
+    // Fa avanzare i lampeggi in corso senza bloccare la lettura della seriale
+    unsigned long adesso = millis();
+    LampeggioAggiorna(lampeggioVerde, adesso);
+    LampeggioAggiorna(lampeggioRosso, adesso);
+
+    // Elabora tutti i caratteri gia' arrivati
+    while (Serial.available() > 0)
+    {
+        uint8_t carattere = Serial.read();
+        if (carattere == '\n' || carattere == '\r')
+        {
+            continue;
+        }
+
+        statoAutoma = acPasso(&automa, statoAutoma, carattere);
+
+        // Tutti i codici che terminano con questo carattere, dal piu' lungo
+        uint16_t uscita = acCodice(&automa, statoAutoma) != AC_NESSUN_CODICE ? statoAutoma
+                                                                              : acAltraUscita(&automa, statoAutoma);
+        while (uscita != 0)
+        {
+            CodiceEsegui(acCodice(&automa, uscita));
+            uscita = acAltraUscita(&automa, uscita);
+        }
+    }
+}
+
+/**
+ * Esegue l'azione associata a un codice riconosciuto
+ * @param codice L'indice del codice nella tabella codici[]
+ */
+void CodiceEsegui(uint16_t codice)
+{
+    Serial.print("Codice riconosciuto: ");
+    Serial.println(codici[codice]);
+
+    switch (azioni[codice])
+    {
+    case AZIONE_ATTIVA:
+        AllarmeImpostaStato(true);
+        break;
+    case AZIONE_DISATTIVA:
+        AllarmeImpostaStato(false);
+        break;
+    case AZIONE_COMMUTA:
+        AllarmeImpostaStato(!allarmeAttivo);
+        break;
+    case AZIONE_LAMPEGGIA_VERDE:
+        LampeggioAvvia(lampeggioVerde, 6, DURATA_FASE_MS, allarmeAttivo);
+        break;
+    case AZIONE_LAMPEGGIA_ROSSO:
+        LampeggioAvvia(lampeggioRosso, 6, DURATA_FASE_MS, !allarmeAttivo);
+        break;
+    case AZIONE_STATO:
+        Serial.println(allarmeAttivo ? "Allarme attivo" : "Allarme non attivo");
+        break;
+    }
+}
+
+/**
+ * Imposta lo stato dell'allarme e lo segnala con 3 lampeggi del LED corrispondente
+ * @param attivo true per attivare l'allarme, false per disattivarlo
+ */
+void AllarmeImpostaStato(bool attivo)
+{
+    allarmeAttivo = attivo;
+    if (attivo)
+    {
+        Serial.println("Allarme attivato");
+        LampeggioAvvia(lampeggioRosso, 0, 0, false);
+        LampeggioAvvia(lampeggioVerde, 6, DURATA_FASE_MS, true);
+    }
+    else
+    {
+        Serial.println("Allarme disattivato");
+        LampeggioAvvia(lampeggioVerde, 0, 0, false);
+        LampeggioAvvia(lampeggioRosso, 6, DURATA_FASE_MS, true);
+    }
+}
+
+/**
+ * Mostra lo stato dell'allarme: verde se attivo, rosso se non attivo
+ */
+void AllarmeMostraStato()
+{
+    LampeggioAvvia(lampeggioVerde, 0, 0, allarmeAttivo);
+    LampeggioAvvia(lampeggioRosso, 0, 0, !allarmeAttivo);
+}
+
+/**
+ * Avvia un lampeggio: il LED si accende e poi cambia stato ad ogni fase.
+ * Un lampeggio gia' in corso sullo stesso LED viene sostituito
+ * @param lampeggio Lo stato del lampeggio del LED
+ * @param fasi Il numero di fasi (accensioni + spegnimenti), 0 per impostare subito lo stato finale
+ * @param durataFaseMs La durata di ogni fase in millisecondi
+ * @param accesoAllaFine true per lasciare il LED acceso al termine del lampeggio
+ */
+void LampeggioAvvia(Lampeggio &lampeggio, int fasi, unsigned long durataFaseMs, bool accesoAllaFine)
+{
+    lampeggio.fasiRimaste = fasi;
+    lampeggio.durataFaseMs = durataFaseMs;
+    lampeggio.inizioFase = millis();
+    lampeggio.accesoAllaFine = accesoAllaFine;
+    lampeggio.acceso = fasi > 0 ? true : accesoAllaFine;
+    digitalWrite(lampeggio.pin, lampeggio.acceso ? HIGH : LOW);
+}
+
+/**
+ * Fa avanzare un lampeggio in corso; va chiamata ad ogni giro di loop()
+ * @param lampeggio Lo stato del lampeggio del LED
+ * @param adesso Il tempo corrente in millisecondi (millis())
+ */
+void LampeggioAggiorna(Lampeggio &lampeggio, unsigned long adesso)
+{
+    if (lampeggio.fasiRimaste == 0 || adesso - lampeggio.inizioFase < lampeggio.durataFaseMs)
+    {
+        return;
+    }
+    lampeggio.inizioFase += lampeggio.durataFaseMs;
+    lampeggio.fasiRimaste--;
+    lampeggio.acceso = lampeggio.fasiRimaste > 0 ? !lampeggio.acceso : lampeggio.accesoAllaFine;
+    digitalWrite(lampeggio.pin, lampeggio.acceso ? HIGH : LOW);
+}
@@ -0,0 +1,153 @@
+/**
+ * @file aho_corasick.cpp
+ * @brief Costruzione dell'automa di Aho-Corasick
+ *
+ * La costruzione avviene in tre passi:
+ *  1. classi: ogni carattere usato da almeno un codice riceve una colonna,
+ *     tutti gli altri condividono la colonna 0;
+ *  2. albero dei prefissi: ogni codice viene inserito carattere per carattere;
+ *  3. visita in ampiezza: per ogni stato si calcola lo stato di "ripiego"
+ *     (il piu' lungo suffisso che e' anche prefisso di un codice) e si
+ *     completano le transizioni mancanti copiando quelle del ripiego.
+ * Alla fine ogni casella della tabella contiene lo stato successivo:
+ * durante il riconoscimento non si torna mai indietro.
+ */
+#include "aho_corasick.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define AC_NESSUNO 0xFFFF
+
+/**
+ * malloc() di un numero di byte calcolato a 32 bit. Su AVR size_t e' a 16
+ * bit: senza controllo 1800 stati * 37 classi * 2 = 133200 byte verrebbero
+ * troncati a 2128. Rifiuta anche i blocchi oltre PTRDIFF_MAX (32767 su AVR),
+ * che non si possono indicizzare; SIZE_MAX e PTRDIFF_MAX non si usano perche'
+ * avr-libc in C++ li definisce solo con __STDC_LIMIT_MACROS.
+ * @return il blocco, NULL se e' troppo grande o non c'e' memoria
+ */
+static void *acAssegna(uint32_t byte) {
+    if ((uint32_t)(size_t)byte != byte || (size_t)byte > ((size_t)-1 >> 1)) {
+        return NULL;
+    }
+    return malloc((size_t)byte);
+}
+
+bool acCostruisci(AutomaAC *automa, const char *const codici[], uint16_t numeroCodici) {
+    memset(automa, 0, sizeof(*automa));
+
+    // 1. Classi dei caratteri e numero massimo di stati
+    uint8_t *classe = (uint8_t *)calloc(256, sizeof(uint8_t));
+    if (classe == NULL) {
+        return false;
+    }
+    uint16_t numeroClassi = 1;
+    uint32_t massimoStati = 1;
+    for (uint16_t i = 0; i < numeroCodici; i++) {
+        for (const uint8_t *p = (const uint8_t *)codici[i]; *p != '\0'; p++) {
+            if (classe[*p] == 0) {
+                classe[*p] = (uint8_t)numeroClassi++;
+            }
+            massimoStati++;
+        }
+    }
+    if (massimoStati >= AC_NESSUNO || numeroClassi > 256) {
+        free(classe);
+        return false;
+    }
+
+    uint16_t *transizioni = (uint16_t *)acAssegna(massimoStati * numeroClassi * (uint32_t)sizeof(uint16_t));
+    uint16_t *codice = (uint16_t *)acAssegna(massimoStati * (uint32_t)sizeof(uint16_t));
+    // Non calloc(): quella di avr-libc non controlla il prodotto dei suoi argomenti
+    uint16_t *altraUscita = (uint16_t *)acAssegna(massimoStati * (uint32_t)sizeof(uint16_t));
+    uint16_t *ripiego = (uint16_t *)acAssegna(massimoStati * (uint32_t)sizeof(uint16_t));
+    uint16_t *coda = (uint16_t *)acAssegna(massimoStati * (uint32_t)sizeof(uint16_t));
+    if (transizioni == NULL || codice == NULL || altraUscita == NULL || ripiego == NULL || coda == NULL) {
+        free(classe);
+        free(transizioni);
+        free(codice);
+        free(altraUscita);
+        free(ripiego);
+        free(coda);
+        return false;
+    }
+    memset(altraUscita, 0, massimoStati * sizeof(uint16_t));
+    memset(ripiego, 0, massimoStati * sizeof(uint16_t));
+    for (uint32_t i = 0; i < massimoStati * numeroClassi; i++) {
+        transizioni[i] = AC_NESSUNO;
+    }
+    for (uint32_t i = 0; i < massimoStati; i++) {
+        codice[i] = AC_NESSUN_CODICE;
+    }
+
+    // 2. Albero dei prefissi
+    uint16_t numeroStati = 1;
+    for (uint16_t i = 0; i < numeroCodici; i++) {
+        uint16_t stato = 0;
+        for (const uint8_t *p = (const uint8_t *)codici[i]; *p != '\0'; p++) {
+            uint16_t *casella = &transizioni[(uint32_t)stato * numeroClassi + classe[*p]];
+            if (*casella == AC_NESSUNO) {
+                *casella = numeroStati++;
+            }
+            stato = *casella;
+        }
+        // Un codice ripetuto mantiene il primo indice
+        if (stato != 0 && codice[stato] == AC_NESSUN_CODICE) {
+            codice[stato] = i;
+        }
+    }
+
+    // 3. Visita in ampiezza: i figli della radice ripiegano sulla radice
+    uint16_t testa = 0;
+    uint16_t fondo = 0;
+    for (uint16_t c = 0; c < numeroClassi; c++) {
+        uint16_t *casella = &transizioni[c];
+        if (*casella == AC_NESSUNO) {
+            *casella = 0;
+        } else {
+            ripiego[*casella] = 0;
+            coda[fondo++] = *casella;
+        }
+    }
+    while (testa < fondo) {
+        uint16_t stato = coda[testa++];
+        uint16_t r = ripiego[stato];
+        // Il codice piu' corto che termina qui e' quello del ripiego o della sua catena
+        altraUscita[stato] = codice[r] != AC_NESSUN_CODICE ? r : altraUscita[r];
+        for (uint16_t c = 0; c < numeroClassi; c++) {
+            uint16_t *casella = &transizioni[(uint32_t)stato * numeroClassi + c];
+            uint16_t diRipiego = transizioni[(uint32_t)r * numeroClassi + c];
+            if (*casella == AC_NESSUNO) {
+                *casella = diRipiego;
+            } else {
+                ripiego[*casella] = diRipiego;
+                coda[fondo++] = *casella;
+            }
+        }
+    }
+    free(ripiego);
+    free(coda);
+
+    // Con codici che condividono prefissi gli stati sono meno del massimo
+    uint16_t *ridotte = (uint16_t *)realloc(transizioni, (uint32_t)numeroStati * numeroClassi * sizeof(uint16_t));
+    if (ridotte != NULL) {
+        transizioni = ridotte;
+    }
+
+    automa->numeroStati = numeroStati;
+    automa->numeroClassi = numeroClassi;
+    automa->classe = classe;
+    automa->transizioni = transizioni;
+    automa->codice = codice;
+    automa->altraUscita = altraUscita;
+    return true;
+}
+
+void acLibera(AutomaAC *automa) {
+    free((void *)automa->classe);
+    free((void *)automa->transizioni);
+    free((void *)automa->codice);
+    free((void *)automa->altraUscita);
+    memset(automa, 0, sizeof(*automa));
+}
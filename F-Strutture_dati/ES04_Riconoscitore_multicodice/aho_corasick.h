@@ -0,0 +1,133 @@
+/**
+ * @file aho_corasick.h
+ * @brief Riconoscitore di molti codici contemporaneamente (automa di Aho-Corasick)
+ *
+ * Il riconoscitore di ES02 confronta gli ultimi caratteri con un solo codice.
+ * Con centinaia di codici, confrontarli tutti ad ogni carattere costerebbe
+ * centinaia di confronti. L'automa di Aho-Corasick unisce tutti i codici in
+ * un unico albero dei prefissi (trie) e precalcola, per ogni stato e ogni
+ * carattere, lo stato successivo: ad ogni carattere ricevuto basta una
+ * lettura in tabella, qualunque sia il numero di codici.
+ *
+ * Tabella compatta:
+ *  - i caratteri che non compaiono in nessun codice sono raggruppati in
+ *    un'unica classe, quindi le colonne sono solo (caratteri usati + 1);
+ *  - la tabella e' di uint16_t: fino a 65535 stati (somma delle lunghezze dei codici).
+ * Occupazione: 256 + 2 * stati * classi + 4 * stati byte.
+ *
+ * La tabella puo' essere costruita all'avvio con acCostruisci() oppure, per
+ * schede con poca RAM, generata sul PC (host/genera_tabella.cpp) e messa in
+ * memoria flash: in quel caso definire AC_TABELLA_IN_FLASH prima di includere
+ * questo file.
+ */
+#ifndef AHO_CORASICK_H
+#define AHO_CORASICK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(AC_TABELLA_IN_FLASH) && defined(__AVR__)
+#include <avr/pgmspace.h>
+#define AC_LEGGI8(p) pgm_read_byte(p)
+#define AC_LEGGI16(p) pgm_read_word(p)
+#else
+#define AC_LEGGI8(p) (*(p))
+#define AC_LEGGI16(p) (*(p))
+#endif
+
+// Valore di codice per "nessun codice riconosciuto"
+#define AC_NESSUN_CODICE 0xFFFF
+
+/**
+ * Automa di Aho-Corasick in forma di tabella di transizione.
+ * Lo stato 0 e' lo stato iniziale (nessun carattere riconosciuto).
+ */
+struct AutomaAC {
+    uint16_t numeroStati;
+    uint16_t numeroClassi;
+    const uint8_t *classe;           // [256] classe di ogni carattere
+    const uint16_t *transizioni;     // [numeroStati * numeroClassi] stato successivo
+    const uint16_t *codice;          // [numeroStati] codice che termina nello stato, o AC_NESSUN_CODICE
+    const uint16_t *altraUscita;     // [numeroStati] stato con un codice piu' corto che termina qui, 0 = nessuno
+};
+
+/**
+ * Costruisce l'automa a partire da una tabella di codici (allocazione dinamica).
+ * @param automa l'automa da costruire
+ * @param codici i codici da riconoscere (stringhe terminate da '\0', non vuote)
+ * @param numeroCodici il numero di codici
+ * @return true se la costruzione e' riuscita, false se manca memoria o ci sono troppi stati
+ */
+bool acCostruisci(AutomaAC *automa, const char *const codici[], uint16_t numeroCodici);
+
+/**
+ * Libera la memoria di un automa creato con acCostruisci().
+ */
+void acLibera(AutomaAC *automa);
+
+/**
+ * Passa allo stato successivo leggendo un carattere.
+ * @param automa l'automa
+ * @param stato lo stato corrente
+ * @param carattere il carattere ricevuto
+ * @return il nuovo stato
+ */
+static inline uint16_t acPasso(const AutomaAC *automa, uint16_t stato, uint8_t carattere) {
+    uint8_t classe = AC_LEGGI8(&automa->classe[carattere]);
+    return AC_LEGGI16(&automa->transizioni[(uint32_t)stato * automa->numeroClassi + classe]);
+}
+
+/**
+ * @return il codice piu' lungo che termina nello stato, o AC_NESSUN_CODICE
+ */
+static inline uint16_t acCodice(const AutomaAC *automa, uint16_t stato) {
+    return AC_LEGGI16(&automa->codice[stato]);
+}
+
+/**
+ * Per scorrere tutti i codici che terminano nello stesso carattere (un codice
+ * puo' essere la parte finale di un altro):
+ *   for (uint16_t s = stato; s != 0; s = acAltraUscita(automa, s))
+ *       if (acCodice(automa, s) != AC_NESSUN_CODICE) ...
+ * @return lo stato successivo della catena, 0 se non ce ne sono altri
+ */
+static inline uint16_t acAltraUscita(const AutomaAC *automa, uint16_t stato) {
+    return AC_LEGGI16(&automa->altraUscita[stato]);
+}
+
+// Funzione chiamata per ogni codice riconosciuto
+typedef void (*FunzioneCodice)(uint16_t codice, size_t posizione, void *dati);
+
+/**
+ * Elabora un blocco di caratteri, chiamando trovato() per ogni codice riconosciuto.
+ * E' inline come acPasso(): legge la tabella con pgm_read_* se chi include
+ * questo file ha definito AC_TABELLA_IN_FLASH.
+ * @param automa l'automa
+ * @param stato stato corrente, aggiornato al termine (per elaborare un flusso a blocchi)
+ * @param testo i caratteri da elaborare
+ * @param lunghezza il numero di caratteri
+ * @param trovato funzione chiamata per ogni codice (puo' essere NULL)
+ * @param dati puntatore passato a trovato()
+ * @return il numero di codici riconosciuti
+ */
+static inline size_t acElabora(const AutomaAC *automa, uint16_t *stato, const uint8_t *testo, size_t lunghezza,
+                               FunzioneCodice trovato, void *dati) {
+    size_t trovati = 0;
+    uint16_t s = *stato;
+    for (size_t i = 0; i < lunghezza; i++) {
+        s = acPasso(automa, s, testo[i]);
+        uint16_t uscita = acCodice(automa, s) != AC_NESSUN_CODICE ? s : acAltraUscita(automa, s);
+        // Caso piu' frequente: nessun codice termina qui, un solo confronto
+        while (uscita != 0) {
+            trovati++;
+            if (trovato != NULL) {
+                trovato(acCodice(automa, uscita), i, dati);
+            }
+            uscita = acAltraUscita(automa, uscita);
+        }
+    }
+    *stato = s;
+    return trovati;
+}
+
+#endif // AHO_CORASICK_H
@@ -0,0 +1,145 @@
+/**
+ * @file bench_aho_corasick.cpp
+ * @brief Velocita' dell'automa di Aho-Corasick su flussi di alcuni MB
+ *
+ * Genera N codici casuali e un flusso casuale in cui sono inseriti alcuni
+ * codici, poi misura i MB/s dell'automa e, come confronto, di un
+ * riconoscitore che controlla tutti i codici ad ogni carattere (sul primo MB,
+ * perche' e' molto piu' lento). Sul primo MB i codici trovati dai due metodi
+ * devono coincidere.
+ *
+ * Compilazione (dalla cartella host):
+ *   g++ -O2 -std=c++17 -I .. bench_aho_corasick.cpp ../aho_corasick.cpp -o bench_aho_corasick
+ * Utilizzo:
+ *   ./bench_aho_corasick [numero_codici] [MB]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include "aho_corasick.h"
+
+static double secondi() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Generatore pseudo-casuale veloce e riproducibile (xorshift)
+static uint32_t statoCasuale = 2463534242u;
+static uint32_t casuale() {
+    statoCasuale ^= statoCasuale << 13;
+    statoCasuale ^= statoCasuale >> 17;
+    statoCasuale ^= statoCasuale << 5;
+    return statoCasuale;
+}
+
+// Caratteri dei codici: cifre e lettere maiuscole, come da una tastiera
+static const char ALFABETO[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+struct Conteggio {
+    size_t trovati;
+    uint64_t sommaControllo;   // somma di (codice + posizione): deve coincidere tra i metodi
+};
+
+static void contaCodice(uint16_t codice, size_t posizione, void *dati) {
+    Conteggio *c = (Conteggio *)dati;
+    c->trovati++;
+    c->sommaControllo += codice * 1000003ull + posizione;
+}
+
+int main(int argc, char *argv[]) {
+    int numeroCodici = argc > 1 ? atoi(argv[1]) : 300;
+    size_t mb = argc > 2 ? strtoul(argv[2], NULL, 10) : 16;
+    size_t lunghezza = mb << 20;
+
+    // Codici di 4..8 caratteri
+    std::vector<std::string> testi(numeroCodici);
+    std::vector<const char *> codici(numeroCodici);
+    for (int i = 0; i < numeroCodici; i++) {
+        int n = 4 + casuale() % 5;
+        for (int j = 0; j < n; j++) {
+            testi[i] += ALFABETO[casuale() % (sizeof(ALFABETO) - 1)];
+        }
+        codici[i] = testi[i].c_str();
+    }
+
+    // Flusso casuale con un codice inserito ogni ~1000 caratteri
+    std::vector<uint8_t> flusso(lunghezza);
+    for (size_t i = 0; i < lunghezza; i++) {
+        flusso[i] = ALFABETO[casuale() % (sizeof(ALFABETO) - 1)];
+    }
+    for (size_t i = 0; i + 16 < lunghezza; i += 500 + casuale() % 1000) {
+        const std::string &c = testi[casuale() % numeroCodici];
+        memcpy(&flusso[i], c.data(), c.size());
+    }
+
+    double t0 = secondi();
+    AutomaAC automa;
+    if (!acCostruisci(&automa, codici.data(), (uint16_t)numeroCodici)) {
+        fprintf(stderr, "Costruzione dell'automa non riuscita\n");
+        return 1;
+    }
+    double tCostruzione = secondi() - t0;
+    size_t byteTabella = 256 + (size_t)automa.numeroStati * automa.numeroClassi * 2 + automa.numeroStati * 4;
+    printf("%d codici: %u stati, %u classi, tabella %zu byte, costruita in %.2f ms\n", numeroCodici,
+           automa.numeroStati, automa.numeroClassi, byteTabella, tCostruzione * 1e3);
+
+    // Automa: un passo in tabella per carattere
+    Conteggio ac = {0, 0};
+    uint16_t stato = 0;
+    t0 = secondi();
+    acElabora(&automa, &stato, flusso.data(), lunghezza, contaCodice, &ac);
+    double tAutoma = secondi() - t0;
+    printf("automa: %.1f MB/s, %zu codici trovati\n", mb / tAutoma, ac.trovati);
+
+    // Verifica e confronto sul primo MB
+    size_t lunghezzaConfronto = lunghezza < ((size_t)1 << 20) ? lunghezza : (size_t)1 << 20;
+    double mbConfronto = lunghezzaConfronto / (double)(1 << 20);
+    Conteggio acConfronto = {0, 0};
+    stato = 0;
+    t0 = secondi();
+    acElabora(&automa, &stato, flusso.data(), lunghezzaConfronto, contaCodice, &acConfronto);
+    double tAutomaConfronto = secondi() - t0;
+
+    // Confronto: ad ogni carattere si controllano tutti i codici che terminano li'.
+    // Per i codici che terminano nella stessa posizione, l'automa li riporta dal
+    // piu' lungo al piu' corto: la somma di controllo non dipende dall'ordine.
+    Conteggio ingenuo = {0, 0};
+    std::vector<size_t> lunghezze(numeroCodici);
+    for (int k = 0; k < numeroCodici; k++) {
+        lunghezze[k] = testi[k].size();
+    }
+    t0 = secondi();
+    for (size_t i = 0; i < lunghezzaConfronto; i++) {
+        for (int k = 0; k < numeroCodici; k++) {
+            size_t n = lunghezze[k];
+            if (n <= i + 1 && flusso[i] == (uint8_t)codici[k][n - 1] &&
+                memcmp(&flusso[i + 1 - n], codici[k], n) == 0) {
+                // I codici ripetuti contano una volta sola, col primo indice
+                bool primo = true;
+                for (int h = 0; h < k && primo; h++) {
+                    primo = testi[h] != testi[k];
+                }
+                if (primo) {
+                    contaCodice((uint16_t)k, i, &ingenuo);
+                }
+            }
+        }
+    }
+    double tIngenuo = secondi() - t0;
+
+    printf("primo MB, tutti i codici ad ogni carattere: %.1f MB/s, %zu codici trovati (automa %zu)\n",
+           mbConfronto / tIngenuo, ingenuo.trovati, acConfronto.trovati);
+    printf("accelerazione %.1fx\n", tIngenuo / tAutomaConfronto);
+
+    acLibera(&automa);
+    if (acConfronto.trovati != ingenuo.trovati || acConfronto.sommaControllo != ingenuo.sommaControllo) {
+        printf("ERRORE: i risultati non coincidono\n");
+        return 1;
+    }
+    return 0;
+}
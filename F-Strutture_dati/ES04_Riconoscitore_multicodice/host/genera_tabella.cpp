@@ -0,0 +1,97 @@
+/**
+ * @file genera_tabella.cpp
+ * @brief Genera sul PC la tabella dell'automa da mettere nella flash di Arduino
+ *
+ * Con centinaia di codici la tabella puo' non stare nei 2 KB di RAM di un
+ * Arduino Uno. Questo programma costruisce l'automa sul PC e lo scrive come
+ * header C con gli array in PROGMEM: lo sketch lo include dopo aver definito
+ * AC_TABELLA_IN_FLASH, e acPasso() legge la tabella direttamente dalla flash.
+ *
+ * Compilazione (dalla cartella host):
+ *   g++ -O2 -std=c++17 -I .. genera_tabella.cpp ../aho_corasick.cpp -o genera_tabella
+ * Utilizzo:
+ *   ./genera_tabella codici.txt > ../tabella_codici.h
+ * Il file dei codici contiene un codice per riga; l'indice di ogni codice e'
+ * il numero della riga (da 0), come nella tabella codici[] dello sketch.
+ *
+ * Nello sketch:
+ *   #define AC_TABELLA_IN_FLASH
+ *   #include "aho_corasick.h"
+ *   #include "tabella_codici.h"    // definisce automaCodici
+ */
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "aho_corasick.h"
+
+static void stampaArray(const char *tipo, const char *nome, const uint16_t *valori, size_t n) {
+    printf("const %s %s[%zu] PROGMEM = {", tipo, nome, n);
+    for (size_t i = 0; i < n; i++) {
+        printf("%s%u,", i % 16 == 0 ? "\n    " : " ", valori[i]);
+    }
+    printf("\n};\n\n");
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Utilizzo: %s codici.txt\n", argv[0]);
+        return 1;
+    }
+    FILE *f = fopen(argv[1], "r");
+    if (f == NULL) {
+        fprintf(stderr, "Impossibile aprire %s\n", argv[1]);
+        return 1;
+    }
+    std::vector<std::string> testi;
+    char riga[256];
+    while (fgets(riga, sizeof(riga), f) != NULL) {
+        std::string codice(riga);
+        while (!codice.empty() && (codice.back() == '\n' || codice.back() == '\r')) {
+            codice.pop_back();
+        }
+        if (codice.empty()) {
+            fprintf(stderr, "Riga %zu vuota: i codici non possono essere vuoti\n", testi.size() + 1);
+            return 1;
+        }
+        testi.push_back(codice);
+    }
+    fclose(f);
+
+    std::vector<const char *> codici;
+    for (size_t i = 0; i < testi.size(); i++) {
+        codici.push_back(testi[i].c_str());
+    }
+    AutomaAC automa;
+    if (!acCostruisci(&automa, codici.data(), (uint16_t)codici.size())) {
+        fprintf(stderr, "Troppi codici: la tabella supera 65535 stati\n");
+        return 1;
+    }
+
+    size_t celle = (size_t)automa.numeroStati * automa.numeroClassi;
+    // avr-gcc non accetta oggetti oltre 32767 byte (PTRDIFF_MAX su AVR)
+    if (celle * sizeof(uint16_t) > 32767) {
+        fprintf(stderr, "Tabella troppo grande per AVR: %u stati x %u classi = %zu byte, il massimo e' 32767\n",
+                automa.numeroStati, automa.numeroClassi, celle * sizeof(uint16_t));
+        acLibera(&automa);
+        return 1;
+    }
+    printf("// Generato da genera_tabella.cpp da %s: %zu codici, %u stati, %u classi, %zu byte\n", argv[1],
+           testi.size(), automa.numeroStati, automa.numeroClassi, 256 + celle * 2 + automa.numeroStati * 4u);
+    printf("#ifndef TABELLA_CODICI_H\n#define TABELLA_CODICI_H\n\n");
+    printf("#ifndef PROGMEM\n#define PROGMEM\n#endif\n\n");
+    printf("const uint8_t classeCodici[256] PROGMEM = {");
+    for (int i = 0; i < 256; i++) {
+        printf("%s%u,", i % 16 == 0 ? "\n    " : " ", automa.classe[i]);
+    }
+    printf("\n};\n\n");
+    stampaArray("uint16_t", "transizioniCodici", automa.transizioni, celle);
+    stampaArray("uint16_t", "codiceCodici", automa.codice, automa.numeroStati);
+    stampaArray("uint16_t", "altraUscitaCodici", automa.altraUscita, automa.numeroStati);
+    printf("const AutomaAC automaCodici = {%u, %u, classeCodici, transizioniCodici, codiceCodici, altraUscitaCodici};\n\n",
+           automa.numeroStati, automa.numeroClassi);
+    printf("#endif // TABELLA_CODICI_H\n");
+
+    acLibera(&automa);
+    return 0;
+}
@@ -0,0 +1,307 @@
+/**
+ * @file banca_domande.cpp
+ * @brief Lettura della banca, indici hash e correzione dei compiti
+ */
+#include "banca_domande.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+//----------------------------------------------------------------------
+// FileMappato
+//----------------------------------------------------------------------
+
+bool FileMappato::apri(const char *percorso) {
+    chiudi();
+    int fd = open(percorso, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    if (info.st_size > 0) {
+        void *mappa = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mappa == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        dati = mappa;
+        byte = (size_t)info.st_size;
+    }
+    close(fd);   // la mappatura resta valida anche dopo la chiusura
+    return true;
+}
+
+void FileMappato::chiudi() {
+    if (dati != nullptr) {
+        munmap(dati, byte);
+        dati = nullptr;
+        byte = 0;
+    }
+}
+
+//----------------------------------------------------------------------
+// IndiceTesti
+//----------------------------------------------------------------------
+
+// Hash di un testo 8 byte alla volta (moltiplicazioni e shift come nel finalizzatore di MurmurHash3)
+static uint64_t hashTesto(std::string_view s) {
+    const char *p = s.data();
+    size_t n = s.size();
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ n;
+    for (; n >= 8; n -= 8, p += 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        h = (h ^ v) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    uint64_t v = 0;
+    memcpy(&v, p, n);
+    h = (h ^ v) * 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 29);
+}
+
+void IndiceTesti::prepara(size_t elementi) {
+    // Al massimo meta' dei posti occupati: le sequenze di posti occupati restano corte
+    size_t capacita = 16;
+    while (capacita < elementi * 2) {
+        capacita *= 2;
+    }
+    if (capacita > posti.size()) {
+        ingrandisci(capacita);
+    }
+}
+
+void IndiceTesti::ingrandisci(size_t capacita) {
+    std::vector<Posto> vecchi;
+    vecchi.swap(posti);
+    posti.assign(capacita, Posto{nullptr, 0, 0, 0});
+    maschera = capacita - 1;
+    for (const Posto &p : vecchi) {
+        if (p.testo == nullptr) {
+            continue;
+        }
+        // L'hash completo non c'e' piu': la posizione si ricalcola
+        size_t i = hashTesto(std::string_view(p.testo, p.lunghezza)) & maschera;
+        while (posti[i].testo != nullptr) {
+            i = (i + 1) & maschera;
+        }
+        posti[i] = p;
+    }
+}
+
+uint32_t IndiceTesti::inserisci(std::string_view chiave, uint32_t valore) {
+    if ((occupati + 1) * 2 > posti.size()) {
+        ingrandisci(posti.empty() ? 16 : posti.size() * 2);
+    }
+    uint64_t h = hashTesto(chiave);
+    size_t i = h & maschera;
+    for (;; i = (i + 1) & maschera) {
+        Posto &p = posti[i];
+        if (p.testo == nullptr) {
+            p = Posto{chiave.data(), (uint32_t)chiave.size(), (uint32_t)(h >> 32), valore};
+            occupati++;
+            return valore;
+        }
+        if (p.hash == (uint32_t)(h >> 32) && std::string_view(p.testo, p.lunghezza) == chiave) {
+            return p.valore;
+        }
+    }
+}
+
+uint32_t IndiceTesti::cerca(std::string_view chiave) const {
+    if (posti.empty()) {
+        return NON_TROVATO;
+    }
+    uint64_t h = hashTesto(chiave);
+    for (size_t i = h & maschera;; i = (i + 1) & maschera) {
+        const Posto &p = posti[i];
+        if (p.testo == nullptr) {
+            return NON_TROVATO;
+        }
+        if (p.hash == (uint32_t)(h >> 32) && std::string_view(p.testo, p.lunghezza) == chiave) {
+            return p.valore;
+        }
+    }
+}
+
+void IndiceTesti::svuota() {
+    std::fill(posti.begin(), posti.end(), Posto{nullptr, 0, 0, 0});
+    occupati = 0;
+}
+
+//----------------------------------------------------------------------
+// BancaDomande
+//----------------------------------------------------------------------
+
+// Toglie spazi, tabulazioni e '\r' (file scritti su Windows) all'inizio e alla fine
+static std::string_view senzaSpazi(std::string_view s) {
+    size_t inizio = 0;
+    size_t fine = s.size();
+    while (inizio < fine && (s[inizio] == ' ' || s[inizio] == '\t' || s[inizio] == '\r')) {
+        inizio++;
+    }
+    while (fine > inizio && (s[fine - 1] == ' ' || s[fine - 1] == '\t' || s[fine - 1] == '\r')) {
+        fine--;
+    }
+    return s.substr(inizio, fine - inizio);
+}
+
+// Prossima riga di testo a partire da posizione (che viene spostata dopo la riga)
+static bool prossimaRiga(std::string_view testo, size_t &posizione, std::string_view &riga) {
+    if (posizione >= testo.size()) {
+        return false;
+    }
+    const char *inizio = testo.data() + posizione;
+    const char *a = static_cast<const char *>(memchr(inizio, '\n', testo.size() - posizione));
+    size_t lunghezza = a != nullptr ? (size_t)(a - inizio) : testo.size() - posizione;
+    riga = std::string_view(inizio, lunghezza);
+    posizione += lunghezza + 1;
+    return true;
+}
+
+bool BancaDomande::apri(const char *percorso) {
+    // Domande, risposte e indici puntano nel file aperto prima, che file.apri() chiude
+    domande.clear();
+    risposte.clear();
+    indiceDomande.svuota();
+    indiceRisposte.svuota();
+    nonValide = 0;
+    if (!file.apri(percorso)) {
+        return false;
+    }
+    std::string_view testo = file.testo();
+    madvise(const_cast<char *>(testo.data()), testo.size(), MADV_SEQUENTIAL);
+
+    // Un primo passaggio veloce (memchr) conta le righe: gli indici non vengono mai ingranditi
+    size_t righe = 0;
+    for (const char *p = testo.data(), *fine = p + testo.size();
+         (p = static_cast<const char *>(memchr(p, '\n', fine - p))) != nullptr; p++) {
+        righe++;
+    }
+    domande.reserve(righe + 1);
+    indiceDomande.prepara(righe + 1);
+
+    std::string_view riga;
+    size_t posizione = 0;
+    while (prossimaRiga(testo, posizione, riga)) {
+        if (riga.empty() || riga[0] == '#' || senzaSpazi(riga).empty()) {
+            continue;
+        }
+        size_t tab1 = riga.find('\t');
+        size_t tab2 = tab1 == std::string_view::npos ? tab1 : riga.find('\t', tab1 + 1);
+        if (tab2 == std::string_view::npos) {
+            nonValide++;
+            continue;
+        }
+        std::string_view id = senzaSpazi(riga.substr(0, tab1));
+        std::string_view risposta = senzaSpazi(riga.substr(tab2 + 1));
+        uint32_t numero = indiceRisposte.inserisci(risposta, (uint32_t)risposte.size());
+        if (numero == risposte.size()) {
+            risposte.push_back(risposta);
+        }
+        // Con id ripetuti vale la prima domanda
+        if (indiceDomande.inserisci(id, (uint32_t)domande.size()) != domande.size()) {
+            nonValide++;
+            continue;
+        }
+        domande.push_back(Domanda{id, riga.substr(tab1 + 1, tab2 - tab1 - 1), numero});
+    }
+    return true;
+}
+
+const Domanda *BancaDomande::cerca(std::string_view id) const {
+    uint32_t i = indiceDomande.cerca(id);
+    return i == IndiceTesti::NON_TROVATO ? nullptr : &domande[i];
+}
+
+//----------------------------------------------------------------------
+// Correzione
+//----------------------------------------------------------------------
+
+void correggiTesto(const BancaDomande &banca, std::string_view testo, EsitoCompito &esito) {
+    std::string_view riga;
+    size_t posizione = 0;
+    while (prossimaRiga(testo, posizione, riga)) {
+        if (senzaSpazi(riga).empty()) {
+            continue;
+        }
+        size_t tab = riga.find('\t');
+        const Domanda *d = tab == std::string_view::npos ? nullptr : banca.cerca(senzaSpazi(riga.substr(0, tab)));
+        if (d == nullptr) {
+            esito.sconosciute++;
+            continue;
+        }
+        esito.risposte++;
+        esito.corrette += banca.corretta(*d, senzaSpazi(riga.substr(tab + 1)));
+    }
+}
+
+// Legge un file piccolo con read(): per decine di migliaia di compiti costa meno di mmap/munmap
+static bool leggiFile(const char *percorso, std::string &contenuto) {
+    int fd = open(percorso, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    contenuto.clear();
+    char blocco[16384];
+    ssize_t letti;
+    while ((letti = read(fd, blocco, sizeof(blocco))) != 0) {
+        if (letti < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            close(fd);
+            return false;
+        }
+        contenuto.append(blocco, (size_t)letti);
+    }
+    close(fd);
+    return true;
+}
+
+std::vector<EsitoCompito> correggiCompiti(const BancaDomande &banca, const std::vector<std::string> &file,
+                                          unsigned thread) {
+    std::vector<EsitoCompito> esiti(file.size());
+    if (thread == 0) {
+        thread = std::thread::hardware_concurrency();
+    }
+    if (thread > file.size()) {
+        thread = (unsigned)file.size();
+    }
+    // Ogni thread prende il prossimo compito: i compiti lunghi non fermano gli altri thread
+    std::atomic<size_t> prossimo(0);
+    auto lavoro = [&]() {
+        std::string contenuto;
+        size_t i;
+        while ((i = prossimo.fetch_add(1, std::memory_order_relaxed)) < file.size()) {
+            EsitoCompito &e = esiti[i];
+            e.file = file[i];
+            e.letto = leggiFile(file[i].c_str(), contenuto);
+            if (e.letto) {
+                correggiTesto(banca, contenuto, e);
+            } else {
+                e.errore = errno;   // errno e' di questo thread: il chiamante non lo vede
+            }
+        }
+    };
+    std::vector<std::thread> altri;
+    for (unsigned t = 1; t < thread; t++) {
+        altri.emplace_back(lavoro);
+    }
+    lavoro();   // anche il thread chiamante corregge
+    for (std::thread &t : altri) {
+        t.join();
+    }
+    return esiti;
+}
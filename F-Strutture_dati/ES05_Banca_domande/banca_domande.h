@@ -0,0 +1,174 @@
+/**
+ * @file banca_domande.h
+ * @brief Banca di milioni di domande con indice hash e correzione in parallelo dei compiti
+ *
+ * quiz.cpp tiene tre domande in string domande[3] / risposteCorrette[3] e
+ * confronta una risposta alla volta con ==. Per un esame con una banca di
+ * milioni di domande e decine di migliaia di compiti da correggere:
+ *  - la banca e' un file di testo mappato in memoria (mmap): le domande non
+ *    vengono copiate, id, testo e risposta sono string_view nel file;
+ *  - le risposte corrette vengono "internate": ogni risposta diversa riceve
+ *    un numero e ogni domanda tiene solo quel numero. Correggere una
+ *    risposta vuol dire cercarla una volta nell'indice delle risposte e
+ *    confrontare due interi;
+ *  - gli indici (id -> domanda, risposta -> numero) sono tabelle hash a
+ *    indirizzamento aperto: un solo vettore, nessuna allocazione per elemento;
+ *  - i compiti vengono corretti da piu' thread, ognuno prende il prossimo file.
+ *
+ * Formato della banca, una domanda per riga (le righe che iniziano con # sono commenti):
+ *   id <TAB> domanda <TAB> risposta
+ * Formato di un compito, una risposta per riga:
+ *   id <TAB> risposta
+ * Come con cin >> nel quiz, gli spazi prima e dopo la risposta non contano;
+ * maiuscole e minuscole si'.
+ */
+#ifndef BANCA_DOMANDE_H
+#define BANCA_DOMANDE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * File in sola lettura mappato in memoria.
+ */
+class FileMappato {
+public:
+    FileMappato() = default;
+    ~FileMappato() { chiudi(); }
+    FileMappato(const FileMappato &) = delete;
+    FileMappato &operator=(const FileMappato &) = delete;
+
+    /**
+     * @return false se il file non puo' essere aperto (errno indica la causa)
+     */
+    bool apri(const char *percorso);
+    void chiudi();
+    std::string_view testo() const { return std::string_view(static_cast<const char *>(dati), byte); }
+
+private:
+    void *dati = nullptr;
+    size_t byte = 0;
+};
+
+/**
+ * Tabella hash a indirizzamento aperto (scansione lineare) da testo a numero.
+ * I testi non vengono copiati: devono restare validi finche' esiste la tabella.
+ */
+class IndiceTesti {
+public:
+    static const uint32_t NON_TROVATO = UINT32_MAX;
+
+    /**
+     * Prepara la tabella per almeno elementi chiavi senza ingrandirla.
+     */
+    void prepara(size_t elementi);
+
+    /**
+     * Inserisce una chiave se non c'e' gia'.
+     * @return il valore associato alla chiave: valore se e' nuova, altrimenti quello gia' presente
+     */
+    uint32_t inserisci(std::string_view chiave, uint32_t valore);
+
+    /**
+     * @return il valore associato alla chiave, NON_TROVATO se non c'e'
+     */
+    uint32_t cerca(std::string_view chiave) const;
+
+    /**
+     * Toglie tutte le chiavi (la memoria della tabella resta assegnata).
+     */
+    void svuota();
+
+    size_t dimensione() const { return occupati; }
+
+private:
+    struct Posto {
+        const char *testo;   // nullptr: posto libero
+        uint32_t lunghezza;
+        uint32_t hash;       // parte bassa dell'hash: evita quasi tutti i confronti dei testi
+        uint32_t valore;
+    };
+
+    void ingrandisci(size_t capacita);
+
+    std::vector<Posto> posti;
+    size_t maschera = 0;
+    size_t occupati = 0;
+};
+
+/**
+ * Una domanda della banca: i testi puntano nel file mappato.
+ */
+struct Domanda {
+    std::string_view id;
+    std::string_view testo;
+    uint32_t risposta;   // numero della risposta corretta internata
+};
+
+class BancaDomande {
+public:
+    /**
+     * Mappa il file della banca e costruisce gli indici.
+     * @return false se il file non puo' essere aperto (errno indica la causa)
+     */
+    bool apri(const char *percorso);
+
+    size_t numeroDomande() const { return domande.size(); }
+    size_t numeroRisposteDiverse() const { return risposte.size(); }
+    size_t righeNonValide() const { return nonValide; }
+    const Domanda &domanda(size_t i) const { return domande[i]; }
+
+    /**
+     * @return la domanda con questo id, nullptr se non c'e'
+     */
+    const Domanda *cerca(std::string_view id) const;
+
+    std::string_view risposta(const Domanda &d) const { return risposte[d.risposta]; }
+
+    /**
+     * @return true se la risposta (gia' senza spazi iniziali e finali) e' quella corretta
+     */
+    bool corretta(const Domanda &d, std::string_view risposta) const {
+        return indiceRisposte.cerca(risposta) == d.risposta;
+    }
+
+private:
+    FileMappato file;
+    std::vector<Domanda> domande;
+    std::vector<std::string_view> risposte;   // risposte diverse, in ordine di numero
+    IndiceTesti indiceDomande;
+    IndiceTesti indiceRisposte;
+    size_t nonValide = 0;
+};
+
+/**
+ * Risultato della correzione di un compito.
+ */
+struct EsitoCompito {
+    std::string file;
+    bool letto = false;          // false: file non leggibile
+    int errore = 0;              // se il file non e' leggibile, errno (del thread che l'ha letto)
+    uint32_t risposte = 0;
+    uint32_t corrette = 0;
+    uint32_t sconosciute = 0;    // righe con un id che non e' nella banca (o senza TAB)
+};
+
+/**
+ * Corregge un compito gia' in memoria.
+ */
+void correggiTesto(const BancaDomande &banca, std::string_view testo, EsitoCompito &esito);
+
+/**
+ * Corregge molti compiti, divisi tra thread.
+ * @param banca la banca delle domande
+ * @param file i percorsi dei compiti
+ * @param thread il numero di thread (0: uno per core)
+ * @return un esito per ogni file, nello stesso ordine
+ */
+std::vector<EsitoCompito> correggiCompiti(const BancaDomande &banca, const std::vector<std::string> &file,
+                                          unsigned thread);
+
+#endif // BANCA_DOMANDE_H
@@ -0,0 +1,215 @@
+/**
+ * @file main_banca_domande.cpp
+ * @brief Genera una banca di domande e dei compiti, corregge i compiti in parallelo
+ *
+ * Utilizzo:
+ *   ./main_banca_domande genera banca.tsv N                  banca di N domande
+ *   ./main_banca_domande compiti banca.tsv cartella M K      M compiti di K risposte
+ *   ./main_banca_domande correggi banca.tsv [-t T] compito.. corregge file o cartelle di compiti
+ *   ./main_banca_domande quiz banca.tsv [N]                  N domande a caso, come quiz.cpp
+ *
+ * correggi stampa una riga CSV per compito (file, risposte, corrette,
+ * sconosciute, voto in decimi) e su stderr i tempi.
+ *
+ * Esempio:
+ *   ./main_banca_domande genera banca.tsv 2000000
+ *   ./main_banca_domande compiti banca.tsv compiti 20000 50
+ *   ./main_banca_domande correggi banca.tsv compiti > voti.csv
+ *
+ * Compilazione:
+ *   g++ -O2 -std=c++17 -pthread main_banca_domande.cpp banca_domande.cpp -o main_banca_domande
+ */
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "banca_domande.h"
+
+static double secondi() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static const char *CAPITALI[][2] = {{"Italia", "Roma"},   {"Francia", "Parigi"}, {"Spagna", "Madrid"},
+                                    {"Germania", "Berlino"}, {"Grecia", "Atene"}, {"Portogallo", "Lisbona"},
+                                    {"Austria", "Vienna"}, {"Irlanda", "Dublino"}};
+
+// Domande di tre tipi, come quelle di quiz.cpp: capitali, somme, giorni dell'anno
+static void scriviDomanda(FILE *f, unsigned long i) {
+    unsigned long r = i * 2654435761u;
+    switch (r % 3) {
+    case 0: {
+        const char **c = CAPITALI[(r >> 8) % (sizeof(CAPITALI) / sizeof(CAPITALI[0]))];
+        fprintf(f, "D%07lu\tQual e' la capitale di %s?\t%s\n", i, c[0], c[1]);
+        break;
+    }
+    case 1: {
+        unsigned a = (r >> 8) % 1000;
+        unsigned b = (r >> 18) % 1000;
+        fprintf(f, "D%07lu\tQuanto fa %u + %u?\t%u\n", i, a, b, a + b);
+        break;
+    }
+    default: {
+        unsigned anno = 1900 + (r >> 8) % 200;
+        bool bisestile = (anno % 4 == 0 && anno % 100 != 0) || anno % 400 == 0;
+        fprintf(f, "D%07lu\tQuanti giorni ha l'anno %u?\t%u\n", i, anno, bisestile ? 366 : 365);
+        break;
+    }
+    }
+}
+
+static int genera(const char *percorso, unsigned long n) {
+    FILE *f = fopen(percorso, "w");
+    if (f == nullptr) {
+        perror(percorso);
+        return 1;
+    }
+    fprintf(f, "# id\tdomanda\trisposta\n");
+    for (unsigned long i = 0; i < n; i++) {
+        scriviDomanda(f, i);
+    }
+    fclose(f);
+    return 0;
+}
+
+// Compiti con circa il 70% di risposte corrette
+static int compiti(const char *percorsoBanca, const char *cartella, unsigned m, unsigned k) {
+    BancaDomande banca;
+    if (!banca.apri(percorsoBanca) || banca.numeroDomande() == 0) {
+        perror(percorsoBanca);
+        return 1;
+    }
+    mkdir(cartella, 0755);
+    srand(1);
+    for (unsigned s = 0; s < m; s++) {
+        std::string percorso = std::string(cartella) + "/studente" + std::to_string(s) + ".txt";
+        FILE *f = fopen(percorso.c_str(), "w");
+        if (f == nullptr) {
+            perror(percorso.c_str());
+            return 1;
+        }
+        for (unsigned j = 0; j < k; j++) {
+            const Domanda &d = banca.domanda((size_t)rand() * RAND_MAX % banca.numeroDomande());
+            std::string_view risposta = banca.risposta(d);
+            if (rand() % 10 < 7) {
+                fprintf(f, "%.*s\t%.*s\n", (int)d.id.size(), d.id.data(), (int)risposta.size(), risposta.data());
+            } else {
+                fprintf(f, "%.*s\t%d\n", (int)d.id.size(), d.id.data(), rand() % 400);
+            }
+        }
+        fclose(f);
+    }
+    return 0;
+}
+
+// Aggiunge un file, o tutti i file di una cartella
+static void aggiungiCompiti(const char *percorso, std::vector<std::string> &file) {
+    DIR *cartella = opendir(percorso);
+    if (cartella == nullptr) {
+        file.push_back(percorso);
+        return;
+    }
+    struct dirent *voce;
+    while ((voce = readdir(cartella)) != nullptr) {
+        if (voce->d_name[0] != '.') {
+            file.push_back(std::string(percorso) + "/" + voce->d_name);
+        }
+    }
+    closedir(cartella);
+}
+
+static int correggi(const char *percorsoBanca, int argc, char *argv[]) {
+    unsigned thread = 0;
+    std::vector<std::string> file;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            thread = (unsigned)atoi(argv[++i]);
+        } else {
+            aggiungiCompiti(argv[i], file);
+        }
+    }
+
+    double t0 = secondi();
+    BancaDomande banca;
+    if (!banca.apri(percorsoBanca)) {
+        perror(percorsoBanca);
+        return 1;
+    }
+    double tBanca = secondi() - t0;
+
+    t0 = secondi();
+    std::vector<EsitoCompito> esiti = correggiCompiti(banca, file, thread);
+    double tCorrezione = secondi() - t0;
+
+    unsigned long risposte = 0;
+    int errori = 0;
+    printf("file,risposte,corrette,sconosciute,voto\n");
+    for (const EsitoCompito &e : esiti) {
+        if (!e.letto) {
+            fprintf(stderr, "%s: %s\n", e.file.c_str(), strerror(e.errore));
+            errori++;
+            continue;
+        }
+        double voto = e.risposte > 0 ? 10.0 * e.corrette / e.risposte : 0.0;
+        printf("%s,%u,%u,%u,%.1f\n", e.file.c_str(), e.risposte, e.corrette, e.sconosciute, voto);
+        risposte += e.risposte;
+    }
+    fprintf(stderr, "banca: %zu domande, %zu risposte diverse, %zu righe non valide, caricata in %.3f s\n",
+            banca.numeroDomande(), banca.numeroRisposteDiverse(), banca.righeNonValide(), tBanca);
+    fprintf(stderr, "%zu compiti (%lu risposte) corretti in %.3f s: %.0f compiti/s\n", esiti.size(), risposte,
+            tCorrezione, esiti.size() / tCorrezione);
+    return errori != 0;
+}
+
+// Il quiz di quiz.cpp, con le domande prese dalla banca
+static int quiz(const char *percorsoBanca, int n) {
+    BancaDomande banca;
+    if (!banca.apri(percorsoBanca) || banca.numeroDomande() == 0) {
+        perror(percorsoBanca);
+        return 1;
+    }
+    srand((unsigned)time(nullptr));
+    int punteggio = 0;
+    for (int i = 0; i < n; i++) {
+        const Domanda &d = banca.domanda((size_t)rand() * RAND_MAX % banca.numeroDomande());
+        std::cout << "Domanda " << (i + 1) << ": " << d.testo << std::endl;
+        std::string rispostaUtente;
+        std::cin >> rispostaUtente;
+        if (banca.corretta(d, rispostaUtente)) {
+            std::cout << "Corretto!" << std::endl;
+            punteggio++;
+        } else {
+            std::cout << "Sbagliato. La risposta corretta era: " << banca.risposta(d) << std::endl;
+        }
+    }
+    std::cout << "\nPunteggio finale: " << punteggio << "/" << n << std::endl;
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 4 && strcmp(argv[1], "genera") == 0) {
+        return genera(argv[2], strtoul(argv[3], nullptr, 10));
+    }
+    if (argc >= 6 && strcmp(argv[1], "compiti") == 0) {
+        return compiti(argv[2], argv[3], (unsigned)atoi(argv[4]), (unsigned)atoi(argv[5]));
+    }
+    if (argc >= 4 && strcmp(argv[1], "correggi") == 0) {
+        return correggi(argv[2], argc - 3, argv + 3);
+    }
+    if (argc >= 3 && strcmp(argv[1], "quiz") == 0) {
+        return quiz(argv[2], argc > 3 ? atoi(argv[3]) : 3);
+    }
+    fprintf(stderr, "Utilizzo:\n");
+    fprintf(stderr, "  %s genera banca.tsv N\n", argv[0]);
+    fprintf(stderr, "  %s compiti banca.tsv cartella M K\n", argv[0]);
+    fprintf(stderr, "  %s correggi banca.tsv [-t T] compito|cartella...\n", argv[0]);
+    fprintf(stderr, "  %s quiz banca.tsv [N]\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file bench_ring_spsc.cpp
+ * @brief Throughput e latenza del buffer SPSC senza lock contro una coda con mutex
+ *
+ * Un thread produttore e un thread consumatore si scambiano N elementi
+ * attraverso:
+ *  - RingSPSC, un elemento alla volta;
+ *  - RingSPSC, a blocchi (inserisciBlocco/estraiBlocco);
+ *  - lo stesso buffer circolare protetto da uno std::mutex.
+ * Throughput: milioni di elementi al secondo. Latenza: il produttore invia
+ * un elemento con l'istante di invio e aspetta che il consumatore lo abbia
+ * ricevuto prima di inviare il successivo; si misurano p50 e p99.
+ * La somma degli elementi ricevuti viene controllata.
+ *
+ * Quando il buffer e' pieno o vuoto i thread chiamano std::this_thread::yield():
+ * su una macchina con un solo core e' necessario per lasciare lavorare l'altro.
+ *
+ * Compilazione (dalla cartella gateway):
+ *   g++ -O2 -std=c++17 -pthread bench_ring_spsc.cpp -o bench_ring_spsc
+ * Utilizzo:
+ *   ./bench_ring_spsc [milioni_di_elementi]
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ring_spsc.h"
+
+const size_t CAPACITA = 4096;
+const size_t BLOCCO = 64;
+const int CAMPIONI_LATENZA = 20000;
+
+static uint64_t adessoNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * Stesso buffer circolare, con un mutex attorno ad ogni operazione.
+ */
+template <typename T, size_t CAP>
+class CodaMutex {
+public:
+    bool inserisci(const T &valore) {
+        std::lock_guard<std::mutex> blocco(mutex);
+        if (coda - testa == CAP) {
+            return false;
+        }
+        elementi[coda++ & (CAP - 1)] = valore;
+        return true;
+    }
+    bool estrai(T &valore) {
+        std::lock_guard<std::mutex> blocco(mutex);
+        if (coda == testa) {
+            return false;
+        }
+        valore = elementi[testa++ & (CAP - 1)];
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    size_t testa = 0;
+    size_t coda = 0;
+    T elementi[CAP];
+};
+
+// Adattatori per usare le stesse funzioni di misura con i tre metodi
+template <typename Coda>
+struct UnoAllaVolta {
+    Coda coda;
+    void invia(const uint64_t *valori, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            while (!coda.inserisci(valori[i])) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    size_t ricevi(uint64_t *valori, size_t n) {
+        (void)n;
+        return coda.estrai(valori[0]) ? 1 : 0;
+    }
+};
+
+struct ABlocchi {
+    RingSPSC<uint64_t, CAPACITA> coda;
+    void invia(const uint64_t *valori, size_t n) {
+        while (n > 0) {
+            size_t inseriti = coda.inserisciBlocco(valori, n);
+            if (inseriti == 0) {
+                std::this_thread::yield();
+            }
+            valori += inseriti;
+            n -= inseriti;
+        }
+    }
+    size_t ricevi(uint64_t *valori, size_t n) {
+        return coda.estraiBlocco(valori, n);
+    }
+};
+
+template <typename Metodo>
+static void misuraThroughput(const char *nome, size_t numero) {
+    Metodo *metodo = new Metodo();
+    uint64_t sommaRicevuta = 0;
+
+    uint64_t t0 = adessoNs();
+    std::thread consumatore([&] {
+        uint64_t valori[BLOCCO];
+        size_t ricevuti = 0;
+        while (ricevuti < numero) {
+            size_t n = metodo->ricevi(valori, BLOCCO);
+            if (n == 0) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < n; i++) {
+                sommaRicevuta += valori[i];
+            }
+            ricevuti += n;
+        }
+    });
+    uint64_t valori[BLOCCO];
+    for (size_t inviati = 0; inviati < numero; inviati += BLOCCO) {
+        size_t n = std::min(BLOCCO, numero - inviati);
+        for (size_t i = 0; i < n; i++) {
+            valori[i] = inviati + i;
+        }
+        metodo->invia(valori, n);
+    }
+    consumatore.join();
+    double secondi = (adessoNs() - t0) * 1e-9;
+
+    uint64_t sommaAttesa = (uint64_t)numero * (numero - 1) / 2;
+    printf("%-28s %8.1f Melementi/s%s\n", nome, numero / secondi * 1e-6,
+           sommaRicevuta == sommaAttesa ? "" : "  ERRORE: somma diversa");
+    delete metodo;
+}
+
+template <typename Metodo>
+static void misuraLatenza(const char *nome) {
+    Metodo *metodo = new Metodo();
+    std::atomic<int> ricevuti(0);
+    std::vector<uint64_t> latenze(CAMPIONI_LATENZA);
+
+    std::thread consumatore([&] {
+        uint64_t istante;
+        for (int i = 0; i < CAMPIONI_LATENZA; i++) {
+            while (metodo->ricevi(&istante, 1) == 0) {
+                std::this_thread::yield();
+            }
+            latenze[i] = adessoNs() - istante;
+            ricevuti.store(i + 1, std::memory_order_release);
+        }
+    });
+    for (int i = 0; i < CAMPIONI_LATENZA; i++) {
+        uint64_t istante = adessoNs();
+        metodo->invia(&istante, 1);
+        while (ricevuti.load(std::memory_order_acquire) <= i) {
+            std::this_thread::yield();
+        }
+    }
+    consumatore.join();
+
+    std::sort(latenze.begin(), latenze.end());
+    printf("%-28s p50 %8llu ns   p99 %8llu ns\n", nome, (unsigned long long)latenze[CAMPIONI_LATENZA / 2],
+           (unsigned long long)latenze[CAMPIONI_LATENZA * 99 / 100]);
+    delete metodo;
+}
+
+int main(int argc, char *argv[]) {
+    size_t numero = (size_t)((argc > 1 ? atof(argv[1]) : 20.0) * 1e6);
+    printf("%zu elementi da 8 byte, capacita' %zu, blocchi da %zu, %u core\n\n", numero, CAPACITA, BLOCCO,
+           std::thread::hardware_concurrency());
+
+    printf("Throughput\n");
+    misuraThroughput<UnoAllaVolta<RingSPSC<uint64_t, CAPACITA> > >("RingSPSC, uno alla volta", numero);
+    misuraThroughput<ABlocchi>("RingSPSC, a blocchi", numero);
+    misuraThroughput<UnoAllaVolta<CodaMutex<uint64_t, CAPACITA> > >("mutex, uno alla volta", numero);
+
+    printf("\nLatenza (un elemento alla volta, andata)\n");
+    misuraLatenza<UnoAllaVolta<RingSPSC<uint64_t, CAPACITA> > >("RingSPSC");
+    misuraLatenza<UnoAllaVolta<CodaMutex<uint64_t, CAPACITA> > >("mutex");
+    return 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file leggi_frame.cpp
+ * @brief Legge i frame binari di temperature_sensor_v2.ino e li stampa in CSV
+ *
+ * Con USCITA_BINARIA = true lo sketch invia ogni lettura come frame di
+ * MessaggioSeriale (31 byte invece di circa 200 di testo). Questo programma
+ * legge i byte dalla seriale (o da un file), scarta quelli che non fanno parte
+ * di un frame valido (per esempio il messaggio di avvio) e stampa una riga per
+ * ogni frame FRAME_TEMPERATURA.
+ *
+ * Compilazione (dalla cartella gateway):
+ *   g++ -O2 -std=c++17 -I ../../librerie/MessaggioSeriale/src leggi_frame.cpp -o leggi_frame
+ * Utilizzo:
+ *   stty -F /dev/ttyACM0 9600 raw && ./leggi_frame < /dev/ttyACM0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "MessaggioSeriale.h"
+
+const uint8_t FRAME_TEMPERATURA = 1;
+const size_t DATI_TEMPERATURA = 4 + 6 * 4 + 2;
+
+static float leggiFloat(const uint8_t *p) {
+    float f;
+    memcpy(&f, p, sizeof(f));
+    return f;
+}
+
+static uint32_t leggiNaturale32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+int main() {
+    std::vector<uint8_t> ricevuti;
+    uint8_t blocco[256];
+    size_t letti;
+    unsigned long frame = 0;
+
+    printf("millis,temperatura,media,minima,massima,mediana,p95,letture\n");
+    while ((letti = fread(blocco, 1, sizeof(blocco), stdin)) > 0) {
+        ricevuti.insert(ricevuti.end(), blocco, blocco + letti);
+
+        FrameSeriale f;
+        size_t consumati;
+        size_t inizio = 0;
+        while (frameDecodifica(ricevuti.data() + inizio, ricevuti.size() - inizio, f, consumati)) {
+            inizio += consumati;
+            if (f.tipo != FRAME_TEMPERATURA || f.lunghezza != DATI_TEMPERATURA) {
+                continue;
+            }
+            const uint8_t *d = f.dati;
+            printf("%u,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%u\n", leggiNaturale32(d), leggiFloat(d + 4),
+                   leggiFloat(d + 8), leggiFloat(d + 12), leggiFloat(d + 16), leggiFloat(d + 20),
+                   leggiFloat(d + 24), (unsigned)(d[28] | (d[29] << 8)));
+            frame++;
+        }
+        // Restano solo i byte di un eventuale frame incompleto
+        ricevuti.erase(ricevuti.begin(), ricevuti.begin() + inizio + consumati);
+        fflush(stdout);
+    }
+    fprintf(stderr, "%lu frame letti\n", frame);
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file main_serie_temporale.cpp
+ * @brief Un anno di letture nella serie temporale compressa: memoria e interrogazioni
+ *
+ * Simula un sensore letto ogni 3 secondi per un anno (circa 10.5 milioni di
+ * letture, risoluzione 1/16 di grado, ciclo giornaliero, qualche lettura in
+ * ritardo o mancante). Misura:
+ *  - byte per lettura rispetto al vettore di struct Lettura;
+ *  - velocita' di inserimento e di decodifica;
+ *  - tempo delle aggregazioni (giorno, mese, anno) con i riepiloghi dei
+ *    blocchi, rispetto alla scansione del vettore non compresso.
+ * Tutte le letture decodificate e tutte le aggregazioni vengono confrontate
+ * con il vettore originale.
+ *
+ * Compilazione (dalla cartella gateway):
+ *   g++ -O2 -std=c++17 main_serie_temporale.cpp serie_temporale.cpp -o main_serie_temporale
+ * Utilizzo:
+ *   ./main_serie_temporale [giorni]
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+#include "serie_temporale.h"
+
+const int64_t MS_GIORNO = 24ll * 3600 * 1000;
+const int64_t INTERVALLO_MS = 3000;
+
+static double secondi() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Aggregazione di riferimento sul vettore non compresso
+static AggregatoSerie aggregaVettore(const std::vector<Lettura> &letture, int64_t da, int64_t a) {
+    AggregatoSerie r = {0, 0.0f, 0.0f, 0.0, 0};
+    for (size_t i = 0; i < letture.size(); i++) {
+        const Lettura &l = letture[i];
+        if (l.istanteMs >= da && l.istanteMs <= a) {
+            r.minimo = r.conteggio == 0 ? l.temperatura : std::min(r.minimo, l.temperatura);
+            r.massimo = r.conteggio == 0 ? l.temperatura : std::max(r.massimo, l.temperatura);
+            r.conteggio++;
+            r.somma += l.temperatura;
+        }
+    }
+    return r;
+}
+
+static bool uguali(const AggregatoSerie &x, const AggregatoSerie &y) {
+    // Le somme possono differire solo per l'ordine delle addizioni
+    return x.conteggio == y.conteggio && x.minimo == y.minimo && x.massimo == y.massimo &&
+           fabs(x.somma - y.somma) <= 1e-9 * fabs(y.somma) + 1e-6;
+}
+
+int main(int argc, char *argv[]) {
+    int giorni = argc > 1 ? atoi(argv[1]) : 365;
+    int64_t inizio = 1735689600000ll;   // 1 gennaio 2025, 00:00 UTC
+
+    // Letture simulate
+    std::vector<Lettura> letture;
+    srand(1);
+    double interna = 21.0;
+    for (int64_t t = inizio; t < inizio + giorni * MS_GIORNO; t += INTERVALLO_MS) {
+        if (rand() % 1000 == 0) {
+            continue;   // lettura persa
+        }
+        int64_t ritardo = rand() % 100 == 0 ? rand() % 50 : 0;
+        double oraDelGiorno = (double)((t - inizio) % MS_GIORNO) / MS_GIORNO;
+        interna += ((rand() % 3) - 1) * 0.002;
+        double gradi = interna + 2.0 * sin(2 * M_PI * oraDelGiorno);
+        letture.push_back(Lettura{t + ritardo, (float)(round(gradi * 16.0) / 16.0)});
+    }
+
+    SerieTemporale serie;
+    serieInizializza(&serie);
+    double t0 = secondi();
+    for (size_t i = 0; i < letture.size(); i++) {
+        serieAggiungi(&serie, letture[i]);
+    }
+    double tInserimento = secondi() - t0;
+
+    size_t byteVettore = letture.size() * sizeof(Lettura);
+    size_t byteSerie = serieByte(&serie);
+    printf("%zu letture (%d giorni, una ogni %lld ms)\n", letture.size(), giorni, (long long)INTERVALLO_MS);
+    printf("vettore di Lettura: %8.2f MB (%.2f byte/lettura)\n", byteVettore / 1048576.0,
+           (double)byteVettore / letture.size());
+    printf("serie compressa:    %8.2f MB (%.2f byte/lettura, %.1fx meno)\n", byteSerie / 1048576.0,
+           (double)byteSerie / letture.size(), (double)byteVettore / byteSerie);
+    printf("inserimento: %.1f milioni di letture/s\n", letture.size() / tInserimento * 1e-6);
+
+    // Decodifica completa e confronto
+    std::vector<Lettura> decodificate;
+    decodificate.reserve(letture.size());
+    t0 = secondi();
+    serieLeggi(&serie, INT64_MIN, INT64_MAX, decodificate);
+    double tDecodifica = secondi() - t0;
+    bool corretta = decodificate.size() == letture.size();
+    for (size_t i = 0; corretta && i < letture.size(); i++) {
+        corretta = decodificate[i].istanteMs == letture[i].istanteMs &&
+                   decodificate[i].temperatura == letture[i].temperatura;
+    }
+    printf("decodifica: %.1f milioni di letture/s%s\n", letture.size() / tDecodifica * 1e-6,
+           corretta ? "" : "  ERRORE: letture diverse");
+
+    // Aggregazioni su intervalli casuali di un giorno, un mese e tutta la serie
+    struct Prova {
+        const char *nome;
+        int64_t durata;
+        int ripetizioni;
+    } prove[] = {{"giorno", MS_GIORNO, 200}, {"mese", 30 * MS_GIORNO, 50}, {"tutto", giorni * MS_GIORNO, 10}};
+    printf("\n%-8s %14s %14s %12s\n", "intervallo", "serie us", "vettore us", "blocchi decod.");
+    int errori = 0;
+    for (const Prova &p : prove) {
+        double tSerie = 0;
+        double tVettore = 0;
+        uint64_t decodificati = 0;
+        for (int r = 0; r < p.ripetizioni; r++) {
+            int64_t spazio = giorni * MS_GIORNO - p.durata;
+            int64_t da = inizio + (spazio > 0 ? (int64_t)(((double)rand() / RAND_MAX) * spazio) : 0);
+            int64_t a = da + p.durata;
+            t0 = secondi();
+            AggregatoSerie s = serieAggrega(&serie, da, a);
+            tSerie += secondi() - t0;
+            t0 = secondi();
+            AggregatoSerie v = aggregaVettore(letture, da, a);
+            tVettore += secondi() - t0;
+            decodificati += s.blocchiDecodificati;
+            errori += !uguali(s, v);
+        }
+        printf("%-10s %14.1f %14.1f %12.1f\n", p.nome, tSerie / p.ripetizioni * 1e6,
+               tVettore / p.ripetizioni * 1e6, (double)decodificati / p.ripetizioni);
+    }
+    if (!corretta || errori) {
+        printf("ERRORE: %d aggregazioni diverse dal vettore\n", errori);
+        return 1;
+    }
+    return 0;
+}
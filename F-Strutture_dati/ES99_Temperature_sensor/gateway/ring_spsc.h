@@ -0,0 +1,152 @@
+/**
+ * @file ring_spsc.h
+ * @brief Buffer circolare senza lock per un produttore e un consumatore (SPSC)
+ *
+ * Negli sketch il buffer circolare e' un vettore globale con indiceBuffer e
+ * conteggioBuffer. Sul gateway Linux le stesse letture vengono ricevute da un
+ * thread (produttore) ed elaborate da un altro (consumatore): con un mutex
+ * ogni inserimento e ogni estrazione pagano un lock. Con un solo produttore
+ * e un solo consumatore bastano due indici atomici:
+ *  - coda: scritta solo dal produttore (prossima posizione da scrivere);
+ *  - testa: scritta solo dal consumatore (prossima posizione da leggere).
+ * Ognuno dei due legge l'indice dell'altro per sapere se il buffer e' pieno o
+ * vuoto. Gli indici crescono sempre e la posizione nel vettore e'
+ * indice & (CAPACITA - 1): per questo la capacita' deve essere una potenza di 2.
+ *
+ * Prestazioni:
+ *  - testa e coda stanno su linee di cache (64 byte) diverse, altrimenti ogni
+ *    scrittura di un thread invaliderebbe la cache dell'altro (false sharing);
+ *  - ogni thread tiene una copia dell'indice dell'altro e la rilegge solo
+ *    quando sembra che il buffer sia pieno/vuoto: meno traffico tra i core;
+ *  - inserisciBlocco/estraiBlocco spostano molti elementi con un solo
+ *    aggiornamento atomico.
+ *
+ * Compilazione: header-only, C++17 (g++ -O2 -std=c++17 -pthread ...).
+ */
+#ifndef RING_SPSC_H
+#define RING_SPSC_H
+
+#include <stddef.h>
+#include <atomic>
+#include <type_traits>
+
+// Dimensione di una linea di cache sulle CPU x86 e ARM piu' comuni
+#define RING_SPSC_LINEA_CACHE 64
+
+template <typename T, size_t CAPACITA>
+class RingSPSC {
+    static_assert(CAPACITA >= 2 && (CAPACITA & (CAPACITA - 1)) == 0, "CAPACITA deve essere una potenza di 2");
+    static_assert(std::is_trivially_copyable<T>::value, "T deve essere copiabile con memcpy (es. struct di letture)");
+
+public:
+    RingSPSC() : coda(0), testaLetta(0), testa(0), codaLetta(0) {}
+
+    RingSPSC(const RingSPSC &) = delete;
+    RingSPSC &operator=(const RingSPSC &) = delete;
+
+    /**
+     * Inserisce un elemento (solo dal thread produttore).
+     * @param valore l'elemento da inserire
+     * @return false se il buffer e' pieno
+     */
+    bool inserisci(const T &valore) {
+        size_t c = coda.load(std::memory_order_relaxed);
+        if (c - testaLetta == CAPACITA) {
+            testaLetta = testa.load(std::memory_order_acquire);
+            if (c - testaLetta == CAPACITA) {
+                return false;
+            }
+        }
+        elementi[c & MASCHERA] = valore;
+        // release: l'elemento e' visibile al consumatore prima del nuovo indice
+        coda.store(c + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Inserisce fino a n elementi (solo dal thread produttore).
+     * @param valori gli elementi da inserire
+     * @param n il numero di elementi
+     * @return il numero di elementi inseriti (meno di n se il buffer si riempie)
+     */
+    size_t inserisciBlocco(const T *valori, size_t n) {
+        size_t c = coda.load(std::memory_order_relaxed);
+        size_t liberi = CAPACITA - (c - testaLetta);
+        if (liberi < n) {
+            testaLetta = testa.load(std::memory_order_acquire);
+            liberi = CAPACITA - (c - testaLetta);
+        }
+        if (n > liberi) {
+            n = liberi;
+        }
+        for (size_t i = 0; i < n; i++) {
+            elementi[(c + i) & MASCHERA] = valori[i];
+        }
+        coda.store(c + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * Estrae l'elemento piu' vecchio (solo dal thread consumatore).
+     * @param valore dove copiare l'elemento
+     * @return false se il buffer e' vuoto
+     */
+    bool estrai(T &valore) {
+        size_t t = testa.load(std::memory_order_relaxed);
+        if (t == codaLetta) {
+            codaLetta = coda.load(std::memory_order_acquire);
+            if (t == codaLetta) {
+                return false;
+            }
+        }
+        valore = elementi[t & MASCHERA];
+        // release: la cella e' stata letta prima che il produttore possa riscriverla
+        testa.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Estrae fino a n elementi (solo dal thread consumatore).
+     * @param valori dove copiare gli elementi
+     * @param n il numero massimo di elementi
+     * @return il numero di elementi estratti
+     */
+    size_t estraiBlocco(T *valori, size_t n) {
+        size_t t = testa.load(std::memory_order_relaxed);
+        size_t disponibili = codaLetta - t;
+        if (disponibili < n) {
+            codaLetta = coda.load(std::memory_order_acquire);
+            disponibili = codaLetta - t;
+        }
+        if (n > disponibili) {
+            n = disponibili;
+        }
+        for (size_t i = 0; i < n; i++) {
+            valori[i] = elementi[(t + i) & MASCHERA];
+        }
+        testa.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @return il numero di elementi presenti (indicativo se i thread sono attivi)
+     */
+    size_t dimensione() const {
+        return coda.load(std::memory_order_acquire) - testa.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacita() { return CAPACITA; }
+
+private:
+    static constexpr size_t MASCHERA = CAPACITA - 1;
+
+    // Dati del produttore: l'indice che scrive e la sua copia di testa
+    alignas(RING_SPSC_LINEA_CACHE) std::atomic<size_t> coda;
+    size_t testaLetta;
+    // Dati del consumatore, su un'altra linea di cache
+    alignas(RING_SPSC_LINEA_CACHE) std::atomic<size_t> testa;
+    size_t codaLetta;
+    alignas(RING_SPSC_LINEA_CACHE) T elementi[CAPACITA];
+};
+
+#endif // RING_SPSC_H
@@ -0,0 +1,286 @@
+/**
+ * @file serie_temporale.cpp
+ * @brief Codifica e decodifica dei blocchi della serie temporale
+ *
+ * Formato di un blocco (bit dal piu' significativo):
+ *  - prima lettura: istante (64 bit) e temperatura (32 bit) cosi' come sono;
+ *  - istanti successivi, d = (intervallo corrente) - (intervallo precedente):
+ *      d == 0                      '0'
+ *      d in [-64, 63]              '10'    + 7 bit
+ *      d in [-256, 255]            '110'   + 9 bit
+ *      d in [-2048, 2047]          '1110'  + 12 bit
+ *      d in 32 bit                 '11110' + 32 bit
+ *      altrimenti                  '11111' + 64 bit
+ *  - temperature successive, x = bit(temperatura) XOR bit(precedente):
+ *      x == 0                      '0'
+ *      bit significativi di x dentro la finestra del valore precedente:
+ *                                  '10' + bit della finestra
+ *      altrimenti                  '11' + zeri iniziali (5 bit) + lunghezza-1 (5 bit) + bit significativi
+ */
+#include "serie_temporale.h"
+
+#include <string.h>
+#include <algorithm>
+
+//----------------------------------------------------------------------
+// Flusso di bit
+//----------------------------------------------------------------------
+
+// Scrive gli n bit meno significativi di valore (1 <= n <= 64)
+static void scriviBit(BloccoSerie *b, uint64_t valore, unsigned n) {
+    if (n < 64) {
+        valore &= (1ull << n) - 1;
+    }
+    unsigned usati = b->numeroBit & 63;
+    if (usati == 0) {
+        b->bit.push_back(0);
+    }
+    unsigned liberi = 64 - usati;
+    if (n <= liberi) {
+        b->bit.back() |= valore << (liberi - n);
+    } else {
+        unsigned resto = n - liberi;
+        b->bit.back() |= valore >> resto;
+        b->bit.push_back(valore << (64 - resto));
+    }
+    b->numeroBit += n;
+}
+
+struct LettoreBit {
+    const uint64_t *bit;
+    uint64_t posizione;
+};
+
+// Legge n bit (1 <= n <= 64)
+static uint64_t leggiBit(LettoreBit *l, unsigned n) {
+    const uint64_t *parola = &l->bit[l->posizione >> 6];
+    unsigned usati = l->posizione & 63;
+    unsigned disponibili = 64 - usati;
+    uint64_t valore = (parola[0] << usati) >> (64 - n);
+    if (n > disponibili) {
+        valore |= parola[1] >> (64 - (n - disponibili));
+    }
+    l->posizione += n;
+    return valore;
+}
+
+static bool leggiUnBit(LettoreBit *l) {
+    bool valore = (l->bit[l->posizione >> 6] >> (63 - (l->posizione & 63))) & 1;
+    l->posizione++;
+    return valore;
+}
+
+// Estende il segno di un valore di n bit
+static int64_t conSegno(uint64_t valore, unsigned n) {
+    return (int64_t)(valore << (64 - n)) >> (64 - n);
+}
+
+static uint32_t bitFloat(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float floatDaBit(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+//----------------------------------------------------------------------
+// Codifica
+//----------------------------------------------------------------------
+
+static void codificaIstante(BloccoSerie *b, int64_t istante) {
+    int64_t delta = istante - b->ultimoIstante;
+    int64_t d = delta - b->ultimoDelta;
+    b->ultimoDelta = delta;
+    if (d == 0) {
+        scriviBit(b, 0, 1);
+    } else if (d >= -64 && d <= 63) {
+        scriviBit(b, 0x2, 2);
+        scriviBit(b, (uint64_t)d, 7);
+    } else if (d >= -256 && d <= 255) {
+        scriviBit(b, 0x6, 3);
+        scriviBit(b, (uint64_t)d, 9);
+    } else if (d >= -2048 && d <= 2047) {
+        scriviBit(b, 0xE, 4);
+        scriviBit(b, (uint64_t)d, 12);
+    } else if (d >= INT32_MIN && d <= INT32_MAX) {
+        scriviBit(b, 0x1E, 5);
+        scriviBit(b, (uint64_t)d, 32);
+    } else {
+        scriviBit(b, 0x1F, 5);
+        scriviBit(b, (uint64_t)d, 64);
+    }
+}
+
+static void codificaTemperatura(BloccoSerie *b, uint32_t valore) {
+    uint32_t x = valore ^ b->ultimaTemperatura;
+    b->ultimaTemperatura = valore;
+    if (x == 0) {
+        scriviBit(b, 0, 1);
+        return;
+    }
+    unsigned zeriIniziali = __builtin_clz(x);
+    unsigned zeriFinali = __builtin_ctz(x);
+    unsigned finaliFinestra = 32 - b->zeriIniziali - b->bitSignificativi;
+    if (b->bitSignificativi > 0 && zeriIniziali >= b->zeriIniziali && zeriFinali >= finaliFinestra) {
+        // Riusa la finestra precedente: niente intestazione
+        scriviBit(b, 0x2, 2);
+        scriviBit(b, x >> finaliFinestra, b->bitSignificativi);
+    } else {
+        unsigned significativi = 32 - zeriIniziali - zeriFinali;
+        scriviBit(b, 0x3, 2);
+        scriviBit(b, zeriIniziali, 5);
+        scriviBit(b, significativi - 1, 5);
+        scriviBit(b, x >> zeriFinali, significativi);
+        b->zeriIniziali = (uint8_t)zeriIniziali;
+        b->bitSignificativi = (uint8_t)significativi;
+    }
+}
+
+//----------------------------------------------------------------------
+// Decodifica: chiama letturaDecodificata(Lettura) per ogni lettura del blocco
+//----------------------------------------------------------------------
+template <typename Funzione>
+static void decodificaBlocco(const BloccoSerie &b, Funzione letturaDecodificata) {
+    if (b.conteggio == 0) {
+        return;
+    }
+    LettoreBit l = {b.bit.data(), 0};
+    int64_t istante = (int64_t)leggiBit(&l, 64);
+    uint32_t temperatura = (uint32_t)leggiBit(&l, 32);
+    int64_t delta = 0;
+    unsigned zeriIniziali = 0;
+    unsigned bitSignificativi = 0;
+    letturaDecodificata(Lettura{istante, floatDaBit(temperatura)});
+
+    for (uint32_t i = 1; i < b.conteggio; i++) {
+        // Istante: conta gli '1' del prefisso (al massimo 5)
+        unsigned prefisso = 0;
+        while (prefisso < 5 && leggiUnBit(&l)) {
+            prefisso++;
+        }
+        static const unsigned BIT_PER_PREFISSO[] = {0, 7, 9, 12, 32, 64};
+        if (prefisso > 0) {
+            unsigned n = BIT_PER_PREFISSO[prefisso];
+            delta += conSegno(leggiBit(&l, n), n);
+        }
+        istante += delta;
+
+        // Temperatura
+        if (leggiUnBit(&l)) {
+            if (leggiUnBit(&l)) {
+                zeriIniziali = (unsigned)leggiBit(&l, 5);
+                bitSignificativi = (unsigned)leggiBit(&l, 5) + 1;
+            }
+            uint32_t x = (uint32_t)leggiBit(&l, bitSignificativi);
+            temperatura ^= x << (32 - zeriIniziali - bitSignificativi);
+        }
+        letturaDecodificata(Lettura{istante, floatDaBit(temperatura)});
+    }
+}
+
+//----------------------------------------------------------------------
+// Serie
+//----------------------------------------------------------------------
+
+void serieInizializza(SerieTemporale *serie) {
+    serie->blocchi.clear();
+    serie->numeroLetture = 0;
+}
+
+bool serieAggiungi(SerieTemporale *serie, Lettura lettura) {
+    if (!serie->blocchi.empty() && lettura.istanteMs < serie->blocchi.back().ultimoIstante) {
+        return false;
+    }
+    uint32_t temperatura = bitFloat(lettura.temperatura);
+
+    if (serie->blocchi.empty() || serie->blocchi.back().conteggio == SERIE_LETTURE_PER_BLOCCO) {
+        if (!serie->blocchi.empty()) {
+            // Il blocco completo non crescera' piu'
+            serie->blocchi.back().bit.shrink_to_fit();
+        }
+        serie->blocchi.emplace_back();
+        BloccoSerie *b = &serie->blocchi.back();
+        b->numeroBit = 0;
+        b->conteggio = 1;
+        b->primoIstante = lettura.istanteMs;
+        b->ultimoIstante = lettura.istanteMs;
+        b->minimo = lettura.temperatura;
+        b->massimo = lettura.temperatura;
+        b->somma = lettura.temperatura;
+        b->ultimoDelta = 0;
+        b->ultimaTemperatura = temperatura;
+        b->zeriIniziali = 0;
+        b->bitSignificativi = 0;
+        scriviBit(b, (uint64_t)lettura.istanteMs, 64);
+        scriviBit(b, temperatura, 32);
+    } else {
+        BloccoSerie *b = &serie->blocchi.back();
+        codificaIstante(b, lettura.istanteMs);
+        codificaTemperatura(b, temperatura);
+        b->conteggio++;
+        b->ultimoIstante = lettura.istanteMs;
+        b->minimo = std::min(b->minimo, lettura.temperatura);
+        b->massimo = std::max(b->massimo, lettura.temperatura);
+        b->somma += lettura.temperatura;
+    }
+    serie->numeroLetture++;
+    return true;
+}
+
+// Primo blocco che puo' contenere letture con istante >= da
+static size_t primoBlocco(const SerieTemporale *serie, int64_t da) {
+    std::vector<BloccoSerie>::const_iterator it =
+        std::lower_bound(serie->blocchi.begin(), serie->blocchi.end(), da,
+                         [](const BloccoSerie &b, int64_t istante) { return b.ultimoIstante < istante; });
+    return it - serie->blocchi.begin();
+}
+
+AggregatoSerie serieAggrega(const SerieTemporale *serie, int64_t da, int64_t a) {
+    AggregatoSerie risultato = {0, 0.0f, 0.0f, 0.0, 0};
+    for (size_t i = primoBlocco(serie, da); i < serie->blocchi.size() && serie->blocchi[i].primoIstante <= a;
+         i++) {
+        const BloccoSerie &b = serie->blocchi[i];
+        if (da <= b.primoIstante && b.ultimoIstante <= a) {
+            // Blocco tutto dentro l'intervallo: basta il riepilogo
+            risultato.minimo = risultato.conteggio == 0 ? b.minimo : std::min(risultato.minimo, b.minimo);
+            risultato.massimo = risultato.conteggio == 0 ? b.massimo : std::max(risultato.massimo, b.massimo);
+            risultato.conteggio += b.conteggio;
+            risultato.somma += b.somma;
+        } else {
+            risultato.blocchiDecodificati++;
+            decodificaBlocco(b, [&](Lettura l) {
+                if (l.istanteMs < da || l.istanteMs > a) {
+                    return;
+                }
+                risultato.minimo = risultato.conteggio == 0 ? l.temperatura : std::min(risultato.minimo, l.temperatura);
+                risultato.massimo = risultato.conteggio == 0 ? l.temperatura : std::max(risultato.massimo, l.temperatura);
+                risultato.conteggio++;
+                risultato.somma += l.temperatura;
+            });
+        }
+    }
+    return risultato;
+}
+
+void serieLeggi(const SerieTemporale *serie, int64_t da, int64_t a, std::vector<Lettura> &risultato) {
+    for (size_t i = primoBlocco(serie, da); i < serie->blocchi.size() && serie->blocchi[i].primoIstante <= a;
+         i++) {
+        decodificaBlocco(serie->blocchi[i], [&](Lettura l) {
+            if (l.istanteMs >= da && l.istanteMs <= a) {
+                risultato.push_back(l);
+            }
+        });
+    }
+}
+
+size_t serieByte(const SerieTemporale *serie) {
+    size_t byte = sizeof(SerieTemporale);
+    for (size_t i = 0; i < serie->blocchi.size(); i++) {
+        byte += sizeof(BloccoSerie) + serie->blocchi[i].bit.capacity() * sizeof(uint64_t);
+    }
+    return byte;
+}
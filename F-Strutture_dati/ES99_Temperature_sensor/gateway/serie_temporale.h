@@ -0,0 +1,118 @@
+/**
+ * @file serie_temporale.h
+ * @brief Archivio compresso delle letture di temperatura (codifica "Gorilla")
+ *
+ * Gli sketch tengono solo le ultime 10 letture. Il gateway le conserva per
+ * anni: una lettura ogni 3 secondi sono circa 10 milioni all'anno, 160 MB
+ * come struct Lettura. Le letture consecutive pero' si somigliano molto:
+ *  - istanti: l'intervallo e' quasi sempre lo stesso, quindi la differenza
+ *    tra due intervalli consecutivi (delta del delta) e' quasi sempre 0 e si
+ *    scrive con 1 bit;
+ *  - temperature: due float vicini hanno segno, esponente e prime cifre
+ *    della mantissa uguali; lo XOR tra i due ha molti zeri iniziali e finali
+ *    e si scrivono solo i bit "significativi" (una temperatura uguale alla
+ *    precedente costa 1 bit).
+ * E' la codifica usata dal database Gorilla di Facebook (Pelkonen et al., 2015),
+ * qui con temperature a 32 bit.
+ *
+ * Le letture sono divise in blocchi di SERIE_LETTURE_PER_BLOCCO. Ogni blocco
+ * ha un riepilogo (primo e ultimo istante, minimo, massimo, somma): le
+ * aggregazioni su un intervallo di tempo usano il riepilogo dei blocchi
+ * interamente contenuti e decodificano solo i (al massimo due) blocchi ai bordi.
+ *
+ * Compilazione: g++ -O2 -std=c++17 ... serie_temporale.cpp
+ */
+#ifndef SERIE_TEMPORALE_H
+#define SERIE_TEMPORALE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Letture per blocco: piu' grande comprime meglio, piu' piccolo decodifica meno ai bordi
+#define SERIE_LETTURE_PER_BLOCCO 1024
+
+/**
+ * Una lettura del sensore.
+ */
+struct Lettura {
+    int64_t istanteMs;     // millisecondi dall'epoca Unix
+    float temperatura;     // gradi Celsius
+};
+
+/**
+ * Blocco di letture compresse con il suo riepilogo.
+ */
+struct BloccoSerie {
+    std::vector<uint64_t> bit;   // flusso di bit compresso
+    uint64_t numeroBit;          // bit scritti in bit[]
+    uint32_t conteggio;          // letture nel blocco
+    int64_t primoIstante;
+    int64_t ultimoIstante;
+    float minimo;
+    float massimo;
+    double somma;
+
+    // Stato del codificatore, serve solo per il blocco in scrittura
+    int64_t ultimoDelta;
+    uint32_t ultimaTemperatura;  // bit del float
+    uint8_t zeriIniziali;        // finestra dei bit significativi dell'ultimo XOR
+    uint8_t bitSignificativi;
+};
+
+/**
+ * Serie temporale: blocchi ordinati per istante.
+ */
+struct SerieTemporale {
+    std::vector<BloccoSerie> blocchi;
+    uint64_t numeroLetture;
+};
+
+/**
+ * Risultato di un'aggregazione su un intervallo di tempo.
+ */
+struct AggregatoSerie {
+    uint64_t conteggio;
+    float minimo;
+    float massimo;
+    double somma;
+    uint32_t blocchiDecodificati;   // quanti blocchi non sono bastati i riepiloghi
+};
+
+/**
+ * Prepara una serie vuota.
+ */
+void serieInizializza(SerieTemporale *serie);
+
+/**
+ * Aggiunge una lettura in fondo alla serie.
+ * @param serie la serie
+ * @param lettura la lettura: l'istante non deve essere precedente all'ultimo
+ * @return false se l'istante e' precedente all'ultima lettura (lettura scartata)
+ */
+bool serieAggiungi(SerieTemporale *serie, Lettura lettura);
+
+/**
+ * Aggrega le letture con istante in [da, a].
+ * @param serie la serie
+ * @param da istante iniziale (compreso)
+ * @param a istante finale (compreso)
+ * @return conteggio, minimo, massimo e somma; minimo e massimo valgono 0 se conteggio e' 0
+ */
+AggregatoSerie serieAggrega(const SerieTemporale *serie, int64_t da, int64_t a);
+
+/**
+ * Decodifica le letture con istante in [da, a], aggiungendole in fondo a risultato.
+ * @param serie la serie
+ * @param da istante iniziale (compreso)
+ * @param a istante finale (compreso)
+ * @param risultato vettore a cui aggiungere le letture
+ */
+void serieLeggi(const SerieTemporale *serie, int64_t da, int64_t a, std::vector<Lettura> &risultato);
+
+/**
+ * @return i byte occupati dai dati compressi e dai riepiloghi
+ */
+size_t serieByte(const SerieTemporale *serie);
+
+#endif // SERIE_TEMPORALE_H
@@ -0,0 +1,149 @@
+/**
+ * @file bench_quantile_finestra.cpp
+ * @brief Mediana e 95° percentile di una finestra scorrevole: heap indicizzati contro riordino
+ *
+ * Per finestre di 10, 100, 1000 e 10000 letture confronta il costo per
+ * lettura di:
+ *  - quantile_finestra (due heap indicizzati, O(log n) per lettura);
+ *  - copia e riordino del buffer ad ogni lettura (O(n log n));
+ *  - copia e std::nth_element ad ogni lettura (O(n)).
+ * Le letture simulano un sensore a 1/16 di grado con picchi occasionali.
+ * I percentili calcolati nei tre modi devono coincidere. Prima del confronto
+ * dei tempi controlla anche finestre di 1, 2, 3 e 5 letture con percentili
+ * bassi e alti (1, 10, 50, 95, 100), dove uno dei due heap resta spesso vuoto.
+ *
+ * Compilazione (dalla cartella host):
+ *   g++ -O2 -std=c++17 -I .. bench_quantile_finestra.cpp ../quantile_finestra.cpp -o bench_quantile_finestra
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+#include "quantile_finestra.h"
+
+static double secondi() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Temperatura simulata: passeggiata casuale a passi di 1/16 di grado, con un picco ogni ~200 letture
+static float prossimaLettura(float *temperatura) {
+    *temperatura += ((rand() % 3) - 1) / 16.0f;
+    if (rand() % 200 == 0) {
+        return (rand() % 2) ? 85.0f : -127.0f;
+    }
+    return *temperatura;
+}
+
+// Percentile per rango come in quantile_finestra.h: il k-esimo valore, k = ceil(p * n / 100)
+static size_t rango(size_t n, int percentuale) {
+    return (percentuale * n + 99) / 100 - 1;
+}
+
+// Finestre piccole e percentili agli estremi, contro il riordino; ritorna il numero di errori
+static int verificaFinestrePiccole() {
+    const int DIMENSIONI[] = {1, 2, 3, 5};
+    const int PERCENTUALI[] = {1, 10, 50, 95, 100};
+    int errori = 0;
+    for (int dimensione : DIMENSIONI) {
+        for (int percentuale : PERCENTUALI) {
+            std::vector<float> buffer(dimensione), finestra(dimensione), copia;
+            std::vector<uint16_t> heap(dimensione), posizione(dimensione);
+            QuantileFinestra q;
+            quantileInizializza(&q, buffer.data(), heap.data(), posizione.data(), dimensione, percentuale);
+            srand(dimensione * 1000 + percentuale);
+            for (int i = 0; i < 1000; i++) {
+                uint16_t indice = i % dimensione;
+                buffer[indice] = finestra[indice] = (float)(rand() % 7);
+                quantileAggiorna(&q, indice);
+                size_t n = i + 1 < dimensione ? i + 1 : dimensione;
+                copia.assign(finestra.begin(), finestra.begin() + n);
+                std::sort(copia.begin(), copia.end());
+                if (copia[rango(n, percentuale)] != quantileValore(&q)) {
+                    if (errori == 0) {
+                        printf("ERRORE: finestra %d, percentile %d, lettura %d: %g invece di %g\n", dimensione,
+                               percentuale, i, quantileValore(&q), copia[rango(n, percentuale)]);
+                    }
+                    errori++;
+                }
+            }
+        }
+    }
+    return errori;
+}
+
+int main() {
+    if (verificaFinestrePiccole()) {
+        return 1;
+    }
+    const int DIMENSIONI[] = {10, 100, 1000, 10000};
+    printf("%8s %14s %14s %14s\n", "finestra", "heap ns", "riordino ns", "nth_element ns");
+
+    for (int dimensione : DIMENSIONI) {
+        int letture = dimensione <= 1000 ? 200000 : 20000;
+        std::vector<float> buffer(dimensione);
+        std::vector<uint16_t> heapMediana(dimensione), posizioneMediana(dimensione);
+        std::vector<uint16_t> heapP95(dimensione), posizioneP95(dimensione);
+        QuantileFinestra mediana, p95;
+        quantileInizializza(&mediana, buffer.data(), heapMediana.data(), posizioneMediana.data(), dimensione, 50);
+        quantileInizializza(&p95, buffer.data(), heapP95.data(), posizioneP95.data(), dimensione, 95);
+
+        // Le letture sono generate prima, per misurare solo il calcolo
+        std::vector<float> sequenza(letture);
+        float temperatura = 21.0f;
+        srand(dimensione);
+        for (int i = 0; i < letture; i++) {
+            sequenza[i] = prossimaLettura(&temperatura);
+        }
+
+        std::vector<float> risultatiHeap(2 * letture);
+        double t0 = secondi();
+        for (int i = 0; i < letture; i++) {
+            uint16_t indice = i % dimensione;
+            buffer[indice] = sequenza[i];
+            quantileAggiorna(&mediana, indice);
+            quantileAggiorna(&p95, indice);
+            risultatiHeap[2 * i] = quantileValore(&mediana);
+            risultatiHeap[2 * i + 1] = quantileValore(&p95);
+        }
+        double tHeap = secondi() - t0;
+
+        // Riordino: si copia la finestra e la si ordina ad ogni lettura
+        std::vector<float> finestra(dimensione);
+        std::vector<float> copia;
+        int errori = 0;
+        t0 = secondi();
+        for (int i = 0; i < letture; i++) {
+            finestra[i % dimensione] = sequenza[i];
+            size_t n = i + 1 < dimensione ? i + 1 : dimensione;
+            copia.assign(finestra.begin(), finestra.begin() + n);
+            std::sort(copia.begin(), copia.end());
+            errori += copia[rango(n, 50)] != risultatiHeap[2 * i];
+            errori += copia[rango(n, 95)] != risultatiHeap[2 * i + 1];
+        }
+        double tRiordino = secondi() - t0;
+
+        t0 = secondi();
+        for (int i = 0; i < letture; i++) {
+            finestra[i % dimensione] = sequenza[i];
+            size_t n = i + 1 < dimensione ? i + 1 : dimensione;
+            copia.assign(finestra.begin(), finestra.begin() + n);
+            std::nth_element(copia.begin(), copia.begin() + rango(n, 95), copia.end());
+            float valoreP95 = copia[rango(n, 95)];
+            std::nth_element(copia.begin(), copia.begin() + rango(n, 50), copia.begin() + rango(n, 95) + 1);
+            errori += copia[rango(n, 50)] != risultatiHeap[2 * i];
+            errori += valoreP95 != risultatiHeap[2 * i + 1];
+        }
+        double tNth = secondi() - t0;
+
+        printf("%8d %14.1f %14.1f %14.1f%s\n", dimensione, tHeap / letture * 1e9, tRiordino / letture * 1e9,
+               tNth / letture * 1e9, errori ? "  ERRORE: risultati diversi" : "");
+        if (errori) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file quantile_finestra.cpp
+ * @brief Implementazione del percentile della finestra con due heap indicizzati
+ *
+ * Gli elementi degli heap sono indici del buffer circolare. L'elemento i di
+ * "basso" sta in heap[i], l'elemento i di "alto" in heap[dimensione - 1 - i];
+ * posizione[] memorizza l'indice in heap[] per poter togliere un elemento
+ * qualsiasi (non solo la cima) in O(log n).
+ */
+#include "quantile_finestra.h"
+
+// Cella dell'elemento i di uno dei due heap
+static uint16_t *cella(QuantileFinestra *q, bool alto, uint16_t i) {
+    return alto ? &q->heap[q->dimensione - 1 - i] : &q->heap[i];
+}
+
+// Scrive un elemento nella cella i e ne aggiorna la posizione
+static void imposta(QuantileFinestra *q, bool alto, uint16_t i, uint16_t elemento) {
+    *cella(q, alto, i) = elemento;
+    q->posizione[elemento] = alto ? q->dimensione - 1 - i : i;
+}
+
+// true se l'elemento a deve stare sopra b: in "basso" il maggiore, in "alto" il minore
+static bool sopra(const QuantileFinestra *q, bool alto, uint16_t a, uint16_t b) {
+    return alto ? q->valori[a] < q->valori[b] : q->valori[a] > q->valori[b];
+}
+
+static uint16_t numero(const QuantileFinestra *q, bool alto) {
+    return alto ? q->numeroAlto : q->numeroBasso;
+}
+
+// Fa risalire l'elemento della cella i finche' non e' sotto un elemento che deve stargli sopra
+static void risali(QuantileFinestra *q, bool alto, uint16_t i) {
+    uint16_t elemento = *cella(q, alto, i);
+    while (i > 0) {
+        uint16_t padre = (i - 1) / 2;
+        uint16_t elementoPadre = *cella(q, alto, padre);
+        if (!sopra(q, alto, elemento, elementoPadre)) {
+            break;
+        }
+        imposta(q, alto, i, elementoPadre);
+        i = padre;
+    }
+    imposta(q, alto, i, elemento);
+}
+
+// Fa scendere l'elemento della cella i finche' i figli non devono stargli sotto
+static void scendi(QuantileFinestra *q, bool alto, uint16_t i) {
+    uint16_t n = numero(q, alto);
+    uint16_t elemento = *cella(q, alto, i);
+    while (true) {
+        uint32_t figlio = 2 * (uint32_t)i + 1;
+        if (figlio >= n) {
+            break;
+        }
+        uint16_t elementoFiglio = *cella(q, alto, figlio);
+        if (figlio + 1 < n) {
+            uint16_t altroFiglio = *cella(q, alto, figlio + 1);
+            if (sopra(q, alto, altroFiglio, elementoFiglio)) {
+                figlio++;
+                elementoFiglio = altroFiglio;
+            }
+        }
+        if (!sopra(q, alto, elementoFiglio, elemento)) {
+            break;
+        }
+        imposta(q, alto, i, elementoFiglio);
+        i = (uint16_t)figlio;
+    }
+    imposta(q, alto, i, elemento);
+}
+
+static void inserisci(QuantileFinestra *q, bool alto, uint16_t elemento) {
+    uint16_t i = alto ? q->numeroAlto++ : q->numeroBasso++;
+    imposta(q, alto, i, elemento);
+    risali(q, alto, i);
+}
+
+// Toglie l'elemento della cella i, sostituendolo con l'ultimo dello heap
+static void rimuovi(QuantileFinestra *q, bool alto, uint16_t i) {
+    uint16_t ultimo = alto ? --q->numeroAlto : --q->numeroBasso;
+    if (i == ultimo) {
+        return;
+    }
+    uint16_t elemento = *cella(q, alto, ultimo);
+    imposta(q, alto, i, elemento);
+    if (i > 0 && sopra(q, alto, elemento, *cella(q, alto, (i - 1) / 2))) {
+        risali(q, alto, i);
+    } else {
+        scendi(q, alto, i);
+    }
+}
+
+// Sposta la cima di uno heap nell'altro
+static void sposta(QuantileFinestra *q, bool daAlto) {
+    uint16_t elemento = *cella(q, daAlto, 0);
+    rimuovi(q, daAlto, 0);
+    inserisci(q, !daAlto, elemento);
+}
+
+void quantileInizializza(QuantileFinestra *q, const float valori[], uint16_t heap[], uint16_t posizione[],
+                         uint16_t dimensione, uint8_t percentuale) {
+    q->valori = valori;
+    q->heap = heap;
+    q->posizione = posizione;
+    q->dimensione = dimensione;
+    q->numeroBasso = 0;
+    q->numeroAlto = 0;
+    q->percentuale = percentuale;
+    for (uint16_t i = 0; i < dimensione; i++) {
+        posizione[i] = QUANTILE_ASSENTE;
+    }
+}
+
+void quantileAggiorna(QuantileFinestra *q, uint16_t indice) {
+    // Toglie la lettura vecchia: il suo valore e' gia' stato sovrascritto, ma
+    // per toglierla basta la posizione, non serve confrontarla
+    uint16_t p = q->posizione[indice];
+    if (p != QUANTILE_ASSENTE) {
+        if (p < q->numeroBasso) {
+            rimuovi(q, false, p);
+        } else {
+            rimuovi(q, true, q->dimensione - 1 - p);
+        }
+    }
+
+    // Inserisce la nuova nello heap giusto. Con "basso" vuoto (per esempio
+    // con k = 1, dopo aver tolto la sua unica lettura) va in "alto": il
+    // riequilibrio sposta poi in "basso" la cima di "alto", cioe' la minore
+    bool alto = q->numeroBasso == 0 || q->valori[indice] > q->valori[q->heap[0]];
+    inserisci(q, alto, indice);
+
+    // Riporta "basso" a ceil(percentuale * n / 100) elementi
+    uint32_t n = (uint32_t)q->numeroBasso + q->numeroAlto;
+    uint16_t obiettivo = (uint16_t)((q->percentuale * n + 99) / 100);
+    while (q->numeroBasso > obiettivo) {
+        sposta(q, false);
+    }
+    while (q->numeroBasso < obiettivo) {
+        sposta(q, true);
+    }
+}
+
+uint16_t quantileConteggio(const QuantileFinestra *q) {
+    return q->numeroBasso + q->numeroAlto;
+}
+
+float quantileValore(const QuantileFinestra *q) {
+    return q->numeroBasso > 0 ? q->valori[q->heap[0]] : 0.0f;
+}
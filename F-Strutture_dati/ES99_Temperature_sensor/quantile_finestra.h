@@ -0,0 +1,77 @@
+/**
+ * @file quantile_finestra.h
+ * @brief Mediana e percentili delle ultime N letture (due heap indicizzati)
+ *
+ * La mediana e il 95° percentile scartano i picchi del sensore meglio della
+ * media, ma riordinare tutto il buffer ad ogni lettura costa N log N. Qui le
+ * letture della finestra sono divise in due heap:
+ *  - "basso": le k letture piu' piccole, con in cima la maggiore (max-heap);
+ *  - "alto": le altre, con in cima la minore (min-heap);
+ * con k = ceil(percentuale * n / 100). Il percentile e' la cima di "basso":
+ * la lettura e' O(1). Ogni nuova lettura sostituisce la piu' vecchia nella
+ * stessa posizione del buffer circolare: l'elemento vecchio viene tolto dal
+ * suo heap (la posizione nello heap e' memorizzata per ogni elemento del
+ * buffer) e il nuovo inserito, con al piu' uno spostamento tra i due heap per
+ * riportare "basso" a k elementi: O(log n) per lettura.
+ *
+ * I valori non vengono copiati: la struttura legge il buffer circolare dello
+ * sketch (per esempio quello di StatisticheFinestra). Memoria per ogni
+ * percentile, fornita dallo sketch: uint16_t heap[N]; uint16_t posizione[N];
+ * cioe' 4 byte per lettura. I due heap condividono lo stesso vettore: "basso"
+ * cresce dall'inizio, "alto" dalla fine.
+ *
+ * Il percentile e' quello "per rango": con n pari la mediana e' il minore dei
+ * due valori centrali.
+ */
+#ifndef QUANTILE_FINESTRA_H
+#define QUANTILE_FINESTRA_H
+
+#include <stdint.h>
+
+// Valore di posizione per un elemento del buffer non ancora inserito
+#define QUANTILE_ASSENTE 0xFFFF
+
+/**
+ * Percentile di una finestra scorrevole di letture.
+ */
+struct QuantileFinestra {
+    const float *valori;     // [dimensione] buffer circolare delle letture (dello sketch)
+    uint16_t *heap;          // [dimensione] indici del buffer: "basso" in [0, numeroBasso), "alto" dalla fine
+    uint16_t *posizione;     // [dimensione] posizione di ogni elemento del buffer in heap[], o QUANTILE_ASSENTE
+    uint16_t dimensione;
+    uint16_t numeroBasso;
+    uint16_t numeroAlto;
+    uint8_t percentuale;     // 50 per la mediana, 95 per il 95° percentile
+};
+
+/**
+ * Prepara la struttura per una finestra vuota.
+ * @param q il percentile da inizializzare
+ * @param valori il buffer circolare delle letture
+ * @param heap memoria per gli heap
+ * @param posizione memoria per le posizioni negli heap
+ * @param dimensione la dimensione dei tre vettori (fino a 65534)
+ * @param percentuale il percentile da calcolare, da 1 a 100
+ */
+void quantileInizializza(QuantileFinestra *q, const float valori[], uint16_t heap[], uint16_t posizione[],
+                         uint16_t dimensione, uint8_t percentuale);
+
+/**
+ * Aggiorna il percentile dopo che valori[indice] e' stato scritto: se la
+ * posizione conteneva gia' una lettura, questa viene prima tolta.
+ * @param q il percentile
+ * @param indice la posizione del buffer appena scritta
+ */
+void quantileAggiorna(QuantileFinestra *q, uint16_t indice);
+
+/**
+ * @return il numero di letture nella finestra
+ */
+uint16_t quantileConteggio(const QuantileFinestra *q);
+
+/**
+ * @return il percentile delle letture nella finestra, 0 se e' vuota
+ */
+float quantileValore(const QuantileFinestra *q);
+
+#endif // QUANTILE_FINESTRA_H
@@ -0,0 +1,108 @@
+/**
+ * @file statistiche_finestra.cpp
+ * @brief Implementazione delle statistiche della finestra in tempo costante
+ */
+#include "statistiche_finestra.h"
+
+#include <math.h>
+
+// Aggiunge un termine alla somma compensata (algoritmo di Kahan)
+static void sommaCompensata(StatisticheFinestra *s, float termine) {
+    float y = termine - s->compensazione;
+    float t = s->somma + y;
+    // (t - somma) e' la parte di y effettivamente sommata: il resto e' andato perso
+    s->compensazione = (t - s->somma) - y;
+    s->somma = t;
+}
+
+// Posizione successiva in un vettore circolare, senza divisioni (lente su AVR)
+static uint16_t successiva(const StatisticheFinestra *s, uint16_t posizione) {
+    posizione++;
+    return posizione == s->dimensione ? 0 : posizione;
+}
+
+// Posizione dell'ultimo elemento di una coda
+static uint16_t ultima(const StatisticheFinestra *s, uint16_t testa, uint16_t lunghezza) {
+    uint32_t p = (uint32_t)testa + lunghezza - 1;
+    return p >= s->dimensione ? (uint16_t)(p - s->dimensione) : (uint16_t)p;
+}
+
+void statisticheInizializza(StatisticheFinestra *s, float valori[], uint16_t codaMin[], uint16_t codaMax[],
+                            uint16_t dimensione) {
+    s->valori = valori;
+    s->codaMin = codaMin;
+    s->codaMax = codaMax;
+    s->dimensione = dimensione;
+    s->indice = 0;
+    s->conteggio = 0;
+    s->testaMin = 0;
+    s->lunghezzaMin = 0;
+    s->testaMax = 0;
+    s->lunghezzaMax = 0;
+    s->somma = 0.0f;
+    s->compensazione = 0.0f;
+    for (uint16_t i = 0; i < dimensione; i++) {
+        valori[i] = 0.0f;
+    }
+}
+
+bool statisticheAggiungi(StatisticheFinestra *s, float valore) {
+    if (isnan(valore) || isinf(valore)) {
+        return false;
+    }
+    uint16_t posizione = s->indice;
+
+    if (s->conteggio == s->dimensione) {
+        // Esce la lettura piu' vecchia: se era in testa a una coda, la lascia
+        sommaCompensata(s, -s->valori[posizione]);
+        if (s->lunghezzaMin > 0 && s->codaMin[s->testaMin] == posizione) {
+            s->testaMin = successiva(s, s->testaMin);
+            s->lunghezzaMin--;
+        }
+        if (s->lunghezzaMax > 0 && s->codaMax[s->testaMax] == posizione) {
+            s->testaMax = successiva(s, s->testaMax);
+            s->lunghezzaMax--;
+        }
+    } else {
+        s->conteggio++;
+    }
+
+    s->valori[posizione] = valore;
+    sommaCompensata(s, valore);
+
+    // Le letture piu' vecchie e non minori della nuova non saranno mai piu' il minimo
+    while (s->lunghezzaMin > 0 && s->valori[s->codaMin[ultima(s, s->testaMin, s->lunghezzaMin)]] >= valore) {
+        s->lunghezzaMin--;
+    }
+    s->lunghezzaMin++;
+    s->codaMin[ultima(s, s->testaMin, s->lunghezzaMin)] = posizione;
+
+    // Allo stesso modo per il massimo
+    while (s->lunghezzaMax > 0 && s->valori[s->codaMax[ultima(s, s->testaMax, s->lunghezzaMax)]] <= valore) {
+        s->lunghezzaMax--;
+    }
+    s->lunghezzaMax++;
+    s->codaMax[ultima(s, s->testaMax, s->lunghezzaMax)] = posizione;
+
+    s->indice = successiva(s, posizione);
+    return true;
+}
+
+uint16_t statisticheConteggio(const StatisticheFinestra *s) {
+    return s->conteggio;
+}
+
+float statisticheMedia(const StatisticheFinestra *s) {
+    if (s->conteggio == 0) {
+        return 0.0f;
+    }
+    return (s->somma - s->compensazione) / s->conteggio;
+}
+
+float statisticheMinimo(const StatisticheFinestra *s) {
+    return s->lunghezzaMin > 0 ? s->valori[s->codaMin[s->testaMin]] : 0.0f;
+}
+
+float statisticheMassimo(const StatisticheFinestra *s) {
+    return s->lunghezzaMax > 0 ? s->valori[s->codaMax[s->testaMax]] : 0.0f;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file statistiche_finestra.h
+ * @brief Media, minimo e massimo delle ultime N letture in tempo costante
+ *
+ * Il buffer circolare delle temperature viene aggiornato una lettura alla
+ * volta, ma ricalcolare la media sommando tutti gli N valori costa N
+ * operazioni ad ogni lettura. Qui ogni statistica viene aggiornata solo con
+ * il valore che entra e quello che esce dalla finestra:
+ *  - somma corrente con compensazione di Kahan: su Arduino float e double
+ *    hanno 24 bit di mantissa, e dopo migliaia di somme e sottrazioni
+ *    l'errore di arrotondamento si accumulerebbe;
+ *  - minimo e massimo con due code monotone (deque): la coda del minimo
+ *    contiene solo le posizioni dei valori che possono ancora diventare il
+ *    minimo, in ordine crescente di valore. Ogni posizione entra ed esce una
+ *    sola volta, quindi il costo medio per lettura e' costante.
+ * Il costo per lettura non dipende da N: una finestra di 2000 letture costa
+ * come una di 10.
+ *
+ * La memoria (valori e code) e' fornita dallo sketch, senza malloc:
+ *   float valori[N]; uint16_t codaMin[N]; uint16_t codaMax[N];
+ * cioe' 8 byte per lettura.
+ *
+ * Nota: la compensazione di Kahan non va compilata con -ffast-math, che
+ * permetterebbe al compilatore di semplificarla via.
+ */
+#ifndef STATISTICHE_FINESTRA_H
+#define STATISTICHE_FINESTRA_H
+
+#include <stdint.h>
+
+/**
+ * Buffer circolare delle ultime letture con le relative statistiche.
+ */
+struct StatisticheFinestra {
+    float *valori;           // [dimensione] buffer circolare delle letture
+    uint16_t *codaMin;       // [dimensione] posizioni candidate al minimo (valori crescenti)
+    uint16_t *codaMax;       // [dimensione] posizioni candidate al massimo (valori decrescenti)
+    uint16_t dimensione;     // numero di letture della finestra
+    uint16_t indice;         // posizione in cui verra' scritta la prossima lettura
+    uint16_t conteggio;      // letture presenti (fino a dimensione)
+    uint16_t testaMin, lunghezzaMin;
+    uint16_t testaMax, lunghezzaMax;
+    float somma;             // somma delle letture presenti
+    float compensazione;     // parte della somma persa negli arrotondamenti (Kahan)
+};
+
+/**
+ * Prepara la finestra vuota.
+ * @param s le statistiche da inizializzare
+ * @param valori buffer delle letture
+ * @param codaMin memoria per la coda del minimo
+ * @param codaMax memoria per la coda del massimo
+ * @param dimensione la dimensione dei tre vettori (da 1 a 65535)
+ */
+void statisticheInizializza(StatisticheFinestra *s, float valori[], uint16_t codaMin[], uint16_t codaMax[],
+                            uint16_t dimensione);
+
+/**
+ * Aggiunge una lettura; se la finestra e' piena sostituisce la piu' vecchia.
+ * Le letture non finite (NaN, infinito) vengono scartate: la somma corrente
+ * non viene mai ricalcolata, quindi un solo NaN la renderebbe NaN per sempre.
+ * @param s le statistiche
+ * @param valore la nuova lettura
+ * @return false se la lettura e' stata scartata (finestra invariata)
+ */
+bool statisticheAggiungi(StatisticheFinestra *s, float valore);
+
+/**
+ * @return il numero di letture presenti nella finestra
+ */
+uint16_t statisticheConteggio(const StatisticheFinestra *s);
+
+/**
+ * @return la media delle letture presenti, 0 se la finestra e' vuota
+ */
+float statisticheMedia(const StatisticheFinestra *s);
+
+/**
+ * @return la lettura minima presente, 0 se la finestra e' vuota
+ */
+float statisticheMinimo(const StatisticheFinestra *s);
+
+/**
+ * @return la lettura massima presente, 0 se la finestra e' vuota
+ */
+float statisticheMassimo(const StatisticheFinestra *s);
+
+#endif // STATISTICHE_FINESTRA_H
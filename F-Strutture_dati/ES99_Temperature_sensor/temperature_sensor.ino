@@ -3,11 +3,15 @@
  * 
  * This sketch reads temperature from a DS18B20 sensor every 3 seconds,
  * stores readings in a circular buffer of 10 elements,
- * and calculates/displays the average temperature.
+ * and calculates/displays the average, minimum and maximum temperature.
+ *
+ * The statistics are updated on every reading in constant time
+ * (statistiche_finestra.h): the cost does not grow with BUFFER_SIZE.
  */
 
 #include <OneWire.h>
 #include <DallasTemperature.h>
+#include "statistiche_finestra.h"
 
 // Data wire is connected to digital pin 2
 #define ONE_WIRE_BUS 2
@@ -18,11 +22,12 @@ OneWire oneWire(ONE_WIRE_BUS);
 // Pass our oneWire reference to Dallas Temperature sensor
 DallasTemperature sensors(&oneWire);
 
-// Circular buffer for temperature readings
+// Circular buffer for temperature readings, with running statistics
 #define BUFFER_SIZE 10
 float tempBuffer[BUFFER_SIZE];
-int bufferIndex = 0;
-int bufferCount = 0;
+uint16_t minQueue[BUFFER_SIZE];
+uint16_t maxQueue[BUFFER_SIZE];
+StatisticheFinestra stats;
 
 // Timing variables
 unsigned long lastReadTime = 0;
@@ -36,10 +41,8 @@ void setup() {
   // Start up the Dallas Temperature library
   sensors.begin();
   
-  // Initialize the buffer with zeros
-  for (int i = 0; i < BUFFER_SIZE; i++) {
-    tempBuffer[i] = 0.0;
-  }
+  // Initialize the buffer with zeros and reset the statistics
+  statisticheInizializza(&stats, tempBuffer, minQueue, maxQueue, BUFFER_SIZE);
 }
 
 void loop() {
@@ -53,21 +56,11 @@ void loop() {
     sensors.requestTemperatures();
     float temperature = sensors.getTempCByIndex(0);
     
-    // Store temperature in circular buffer
-    tempBuffer[bufferIndex] = temperature;
-    
-    // Update buffer index and count
-    bufferIndex = (bufferIndex + 1) % BUFFER_SIZE;
-    if (bufferCount < BUFFER_SIZE) {
-      bufferCount++;
-    }
+    // Store temperature in circular buffer (updates sum, min and max)
+    statisticheAggiungi(&stats, temperature);
     
-    // Calculate average temperature
-    float sum = 0.0;
-    for (int i = 0; i < bufferCount; i++) {
-      sum += tempBuffer[i];
-    }
-    float average = sum / bufferCount;
+    // Average from the running sum
+    float average = statisticheMedia(&stats);
     
     // Display results
     Serial.print("Current temperature: ");
@@ -75,10 +68,16 @@ void loop() {
     Serial.println(" °C");
     
     Serial.print("Average temperature (last ");
-    Serial.print(bufferCount);
+    Serial.print(statisticheConteggio(&stats));
     Serial.print(" readings): ");
     Serial.print(average);
     Serial.println(" °C");
+
+    Serial.print("Min: ");
+    Serial.print(statisticheMinimo(&stats));
+    Serial.print(" °C, max: ");
+    Serial.print(statisticheMassimo(&stats));
+    Serial.println(" °C");
     
     Serial.println("-----------------------");
   }
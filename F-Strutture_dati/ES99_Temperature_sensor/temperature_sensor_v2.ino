@@ -3,13 +3,23 @@
  * 
  * Questo sketch legge la temperatura da un sensore DS18B20 ogni 3 secondi,
  * memorizza le letture in un buffer circolare di 10 elementi,
- * e calcola/visualizza la temperatura media.
+ * e calcola/visualizza la temperatura media, minima, massima, la mediana e il
+ * 95° percentile (meno sensibili della media ai picchi del sensore).
  * 
  * v1.2 17/03/25 - utilizza funzioni e delay() invece di millis() per la temporizzazione.
+ * v1.3 18/10/26 - media, minimo e massimo aggiornati ad ogni lettura in tempo costante
+ *                 (statistiche_finestra.h), senza risommare tutto il buffer.
+ * v1.4 18/10/26 - mediana e 95° percentile con due heap indicizzati (quantile_finestra.h):
+ *                 O(log n) per lettura invece di riordinare il buffer.
+ * v1.5 18/10/26 - risultati composti in un buffer e inviati con una sola scrittura
+ *                 (libreria MessaggioSeriale), con modalita' a frame binari per il gateway.
  */
 
 #include <OneWire.h>
 #include <DallasTemperature.h>
+#include "statistiche_finestra.h"
+#include "quantile_finestra.h"
+#include <MessaggioSeriale.h>
 
 // Prototipi delle funzioni
 void inizializzaBuffer();
@@ -25,15 +35,32 @@ OneWire oneWire(BUS_ONE_WIRE);
 // Passa il nostro riferimento oneWire al sensore di temperatura Dallas
 DallasTemperature sensori(&oneWire);
 
-// Buffer circolare per le letture di temperatura
+// Buffer circolare per le letture di temperatura e relative statistiche.
+// Il costo di ogni lettura non dipende da DIMENSIONE_BUFFER (8 byte di RAM per lettura)
 #define DIMENSIONE_BUFFER 10
 float bufferTemperatura[DIMENSIONE_BUFFER];
-int indiceBuffer = 0;
-int conteggioBuffer = 0;
+uint16_t codaMinimo[DIMENSIONE_BUFFER];
+uint16_t codaMassimo[DIMENSIONE_BUFFER];
+StatisticheFinestra statistiche;
+// Mediana e 95° percentile: 4 byte di RAM per lettura ciascuno
+uint16_t heapMediana[DIMENSIONE_BUFFER];
+uint16_t posizioneMediana[DIMENSIONE_BUFFER];
+QuantileFinestra mediana;
+uint16_t heapPercentile95[DIMENSIONE_BUFFER];
+uint16_t posizionePercentile95[DIMENSIONE_BUFFER];
+QuantileFinestra percentile95;
 
 // Costante di temporizzazione
 const unsigned long INTERVALLO_LETTURA = 3000; // 3 secondi in millisecondi
 
+// Uscita seriale: testo leggibile oppure frame binari per il gateway (gateway/leggi_frame.cpp)
+const bool USCITA_BINARIA = false;
+// Frame delle letture: millis (uint32), temperatura, media, minima, massima, mediana,
+// 95° percentile (float), letture nella finestra (uint16)
+const uint8_t FRAME_TEMPERATURA = 1;
+// Il messaggio di testo completo e' di circa 200 byte
+const int DIMENSIONE_MESSAGGIO = 224;
+
 void setup() {
   // Inizializza la porta seriale
   Serial.begin(9600);
@@ -63,11 +90,12 @@ void loop() {
   delay(INTERVALLO_LETTURA);
 }
 
-// Inizializza il buffer con zeri
+// Inizializza il buffer con zeri e azzera le statistiche
 void inizializzaBuffer() {
-  for (int i = 0; i < DIMENSIONE_BUFFER; i++) {
-    bufferTemperatura[i] = 0.0;
-  }
+  statisticheInizializza(&statistiche, bufferTemperatura, codaMinimo, codaMassimo, DIMENSIONE_BUFFER);
+  quantileInizializza(&mediana, bufferTemperatura, heapMediana, posizioneMediana, DIMENSIONE_BUFFER, 50);
+  quantileInizializza(&percentile95, bufferTemperatura, heapPercentile95, posizionePercentile95,
+                      DIMENSIONE_BUFFER, 95);
 }
 
 // Leggi la temperatura dal sensore DS18B20
@@ -76,37 +104,65 @@ float leggiTemperatura() {
   return sensori.getTempCByIndex(0);
 }
 
-// Memorizza la temperatura nel buffer circolare
+// Memorizza la temperatura nel buffer circolare e aggiorna somma, minimo, massimo e percentili
 void memorizzaTemperatura(float temperatura) {
-  bufferTemperatura[indiceBuffer] = temperatura;
-  
-  // Aggiorna l'indice e il conteggio del buffer
-  indiceBuffer = (indiceBuffer + 1) % DIMENSIONE_BUFFER;
-  if (conteggioBuffer < DIMENSIONE_BUFFER) {
-    conteggioBuffer++;
+  uint16_t posizione = statistiche.indice; // posizione in cui viene scritta la lettura
+  if (!statisticheAggiungi(&statistiche, temperatura)) {
+    return; // lettura non finita: scartata, i percentili restano quelli della finestra
   }
+  quantileAggiorna(&mediana, posizione);
+  quantileAggiorna(&percentile95, posizione);
 }
 
-// Calcola la temperatura media dai valori del buffer
+// Restituisce la temperatura media dei valori del buffer (somma gia' aggiornata)
 float calcolaTemperaturaMedia() {
-  float somma = 0.0;
-  for (int i = 0; i < conteggioBuffer; i++) {
-    somma += bufferTemperatura[i];
-  }
-  return somma / conteggioBuffer;
+  return statisticheMedia(&statistiche);
 }
 
-// Visualizza la temperatura corrente e media
+// Visualizza la temperatura corrente, media, minima, massima e i percentili.
+// Il messaggio viene composto in un buffer locale e inviato con una sola scrittura
 void visualizzaRisultati(float temperatura, float media) {
-  Serial.print("Temperatura corrente: ");
-  Serial.print(temperatura);
-  Serial.println(" °C");
-  
-  Serial.print("Temperatura media (ultime ");
-  Serial.print(conteggioBuffer);
-  Serial.print(" letture): ");
-  Serial.print(media);
-  Serial.println(" °C");
-  
-  Serial.println("-----------------------");
+  char buffer[DIMENSIONE_MESSAGGIO];
+  MessaggioSeriale m;
+  messaggioInizia(m, buffer, sizeof(buffer));
+
+  if (USCITA_BINARIA) {
+    frameInizia(m, FRAME_TEMPERATURA);
+    frameNaturale32(m, millis());
+    frameFloat(m, temperatura);
+    frameFloat(m, media);
+    frameFloat(m, statisticheMinimo(&statistiche));
+    frameFloat(m, statisticheMassimo(&statistiche));
+    frameFloat(m, quantileValore(&mediana));
+    frameFloat(m, quantileValore(&percentile95));
+    frameNaturale16(m, statisticheConteggio(&statistiche));
+    frameChiudi(m);
+    messaggioInvia(m, Serial);
+    return;
+  }
+
+  messaggioTesto(m, "Temperatura corrente: ");
+  messaggioDecimale(m, temperatura, 2);
+  messaggioTesto(m, " °C\r\n");
+
+  messaggioTesto(m, "Temperatura media (ultime ");
+  messaggioNaturale(m, statisticheConteggio(&statistiche));
+  messaggioTesto(m, " letture): ");
+  messaggioDecimale(m, media, 2);
+  messaggioTesto(m, " °C\r\n");
+
+  messaggioTesto(m, "Minima: ");
+  messaggioDecimale(m, statisticheMinimo(&statistiche), 2);
+  messaggioTesto(m, " °C, massima: ");
+  messaggioDecimale(m, statisticheMassimo(&statistiche), 2);
+  messaggioTesto(m, " °C\r\n");
+
+  messaggioTesto(m, "Mediana: ");
+  messaggioDecimale(m, quantileValore(&mediana), 2);
+  messaggioTesto(m, " °C, 95° percentile: ");
+  messaggioDecimale(m, quantileValore(&percentile95), 2);
+  messaggioTesto(m, " °C\r\n");
+
+  messaggioTesto(m, "-----------------------\r\n");
+  messaggioInvia(m, Serial);
 }
\ No newline at end of file
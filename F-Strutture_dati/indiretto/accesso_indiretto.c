@@ -0,0 +1,138 @@
+/**
+ * @file accesso_indiretto.c
+ * @brief Raccolta con prefetch, scalare o con gather AVX2 (scelto a runtime)
+ */
+#include "accesso_indiretto.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define INDIRETTO_X86 1
+#endif
+
+// int32 e float hanno la stessa dimensione: le funzioni lavorano su parole di
+// 32 bit, che possono essere lette e scritte al posto di entrambi i tipi
+typedef int32_t __attribute__((may_alias)) Parola32;
+
+// Gli indici vengono esaminati a blocchi: per ogni blocco si sceglie se usare
+// il gather guardando l'indice piu' grande
+#define INDICI_PER_BLOCCO 1024
+
+// Con INDIRETTO_AUTOMATICO il gather si usa se il blocco legge solo il primo
+// milione di elementi (4 MB) della tabella: con tabelle piu' grandi della cache
+// il tempo e' quello della memoria e il gather e' piu' lento del ciclo semplice
+#define LIMITE_AUTOMATICO (1u << 20)
+
+// Elementi da "da" ad "a"; il prefetch chiede anche gli elementi oltre "a", fino a n
+static void raccogliScalare(const Parola32 tabella[], const uint32_t indici[], Parola32 uscita[], size_t da,
+                            size_t a, size_t n, unsigned distanza) {
+    size_t i = da;
+    if (distanza > 0 && n > distanza) {
+        size_t fine = a < n - distanza ? a : n - distanza;
+        for (; i < fine; i++) {
+            __builtin_prefetch(&tabella[indici[i + distanza]]);
+            uscita[i] = tabella[indici[i]];
+        }
+    }
+    for (; i < a; i++) {
+        uscita[i] = tabella[indici[i]];
+    }
+}
+
+#ifdef INDIRETTO_X86
+
+__attribute__((target("avx2"))) static uint32_t indiceMassimo(const uint32_t indici[], size_t n) {
+    __m256i massimo = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        massimo = _mm256_max_epu32(massimo, _mm256_loadu_si256((const __m256i *)&indici[i]));
+    }
+    uint32_t parziali[8];
+    _mm256_storeu_si256((__m256i *)parziali, massimo);
+    uint32_t m = 0;
+    for (int k = 0; k < 8; k++) {
+        m = parziali[k] > m ? parziali[k] : m;
+    }
+    for (; i < n; i++) {
+        m = indici[i] > m ? indici[i] : m;
+    }
+    return m;
+}
+
+// Gli indici del gather sono con segno: vanno bene solo fino a 2^31 - 1
+__attribute__((target("avx2"))) static void raccogliGather(const Parola32 tabella[], const uint32_t indici[],
+                                                           Parola32 uscita[], size_t da, size_t a, size_t n,
+                                                           unsigned distanza) {
+    const int *base = (const int *)tabella;
+    size_t i = da;
+    if (distanza > 0) {
+        for (; i + 8 <= a && i + 8 + distanza <= n; i += 8) {
+            const uint32_t *avanti = indici + i + distanza;
+            for (int k = 0; k < 8; k++) {
+                __builtin_prefetch(&tabella[avanti[k]]);
+            }
+            __m256i x = _mm256_loadu_si256((const __m256i *)&indici[i]);
+            _mm256_storeu_si256((__m256i *)&uscita[i], _mm256_i32gather_epi32(base, x, 4));
+        }
+    }
+    for (; i + 8 <= a; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)&indici[i]);
+        _mm256_storeu_si256((__m256i *)&uscita[i], _mm256_i32gather_epi32(base, x, 4));
+    }
+    raccogliScalare(tabella, indici, uscita, i, a, n, 0);
+}
+
+#endif // INDIRETTO_X86
+
+static void raccogli(const Parola32 tabella[], const uint32_t indici[], Parola32 uscita[], size_t n,
+                     MetodoIndiretto metodo, unsigned distanza) {
+#ifdef INDIRETTO_X86
+    if (metodo != INDIRETTO_SCALARE && __builtin_cpu_supports("avx2")) {
+        uint32_t limite = metodo == INDIRETTO_GATHER ? INT32_MAX : LIMITE_AUTOMATICO - 1;
+        for (size_t da = 0; da < n; da += INDICI_PER_BLOCCO) {
+            size_t a = n - da > INDICI_PER_BLOCCO ? da + INDICI_PER_BLOCCO : n;
+            if (indiceMassimo(indici + da, a - da) <= limite) {
+                raccogliGather(tabella, indici, uscita, da, a, n, distanza);
+            } else {
+                raccogliScalare(tabella, indici, uscita, da, a, n, distanza);
+            }
+        }
+        return;
+    }
+#else
+    (void)metodo;
+#endif
+    raccogliScalare(tabella, indici, uscita, 0, n, n, distanza);
+}
+
+void raccogliInt32(const int32_t tabella[], const uint32_t indici[], int32_t uscita[], size_t n,
+                   MetodoIndiretto metodo, unsigned distanza) {
+    raccogli(tabella, indici, uscita, n, metodo, distanza);
+}
+
+void raccogliFloat(const float tabella[], const uint32_t indici[], float uscita[], size_t n, MetodoIndiretto metodo,
+                   unsigned distanza) {
+    raccogli((const Parola32 *)tabella, indici, (Parola32 *)uscita, n, metodo, distanza);
+}
+
+static void distribuisci(Parola32 tabella[], const uint32_t indici[], const Parola32 valori[], size_t n,
+                         unsigned distanza) {
+    size_t i = 0;
+    if (distanza > 0 && n > distanza) {
+        for (; i < n - distanza; i++) {
+            __builtin_prefetch(&tabella[indici[i + distanza]], 1);
+            tabella[indici[i]] = valori[i];
+        }
+    }
+    for (; i < n; i++) {
+        tabella[indici[i]] = valori[i];
+    }
+}
+
+void distribuisciInt32(int32_t tabella[], const uint32_t indici[], const int32_t valori[], size_t n,
+                       unsigned distanza) {
+    distribuisci(tabella, indici, valori, n, distanza);
+}
+
+void distribuisciFloat(float tabella[], const uint32_t indici[], const float valori[], size_t n, unsigned distanza) {
+    distribuisci((Parola32 *)tabella, indici, (const Parola32 *)valori, n, distanza);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file accesso_indiretto.h
+ * @brief Accesso indiretto a blocchi: uscita[i] = tabella[indici[i]] e tabella[indici[i]] = valori[i]
+ *
+ * es_vet_03.c e prep0406_vet.c usano un elemento del vettore come indice di
+ * un altro (t[ t[2]+t[3] ]). Fatto su milioni di indici in una tabella piu'
+ * grande della cache, ogni lettura e' un cache miss: il ciclo semplice
+ * aspetta la memoria (circa 100 ns) ad ogni elemento perche' il processore
+ * riesce ad anticipare solo poche letture.
+ *
+ * Qui gli indici vengono letti in anticipo (sono in un vettore, quindi si
+ * conoscono "distanza" elementi prima) e per ognuno si chiede subito la riga
+ * di cache della tabella con __builtin_prefetch: quando il ciclo arriva a
+ * quell'elemento il dato e' gia' in arrivo o in cache, e decine di letture
+ * dalla memoria sono in corso insieme invece di una alla volta.
+ * Con AVX2 la lettura di 8 elementi si fa con un'istruzione gather.
+ *
+ * La distanza giusta dipende dalla latenza della memoria e dal lavoro per
+ * elemento: bench_accesso_indiretto la misura. Con tabelle che stanno nella
+ * cache il prefetch non serve (distanza 0).
+ */
+#ifndef ACCESSO_INDIRETTO_H
+#define ACCESSO_INDIRETTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Distanza del prefetch, in elementi, che va bene per tabelle piu' grandi della cache */
+#define INDIRETTO_DISTANZA_PREDEFINITA 32
+
+/**
+ * Come leggere la tabella.
+ */
+typedef enum {
+    INDIRETTO_AUTOMATICO,   // gather AVX2 dove gli indici restano sotto 2^20 (tabella in cache), altrimenti scalare
+    INDIRETTO_SCALARE,      // un elemento alla volta
+    INDIRETTO_GATHER        // istruzioni gather AVX2 (scalare se non ci sono o se gli indici superano 2^31 - 1)
+} MetodoIndiretto;
+
+/**
+ * uscita[i] = tabella[indici[i]] per i da 0 a n - 1.
+ * Gli indici non vengono controllati: devono essere tutti validi.
+ * Il gather AVX2 tratta gli indici come interi con segno: gli indici vengono
+ * esaminati a blocchi di 1024 e i blocchi con un indice oltre 2^31 - 1 sono
+ * letti un elemento alla volta. INDIRETTO_AUTOMATICO fa lo stesso con i blocchi
+ * che arrivano oltre i primi 2^20 elementi (4 MB), dove il gather non conviene.
+ * @param tabella la tabella
+ * @param indici gli indici
+ * @param uscita dove scrivere i valori letti
+ * @param n il numero di indici
+ * @param metodo come leggere la tabella
+ * @param distanza quanti elementi prima chiedere i dati con il prefetch (0 = nessun prefetch)
+ */
+void raccogliInt32(const int32_t tabella[], const uint32_t indici[], int32_t uscita[], size_t n,
+                   MetodoIndiretto metodo, unsigned distanza);
+void raccogliFloat(const float tabella[], const uint32_t indici[], float uscita[], size_t n, MetodoIndiretto metodo,
+                   unsigned distanza);
+
+/**
+ * tabella[indici[i]] = valori[i] per i da 0 a n - 1, in ordine: con indici
+ * ripetuti resta l'ultimo valore. AVX2 non ha istruzioni scatter, si scrive
+ * un elemento alla volta con il prefetch in scrittura.
+ * @param distanza quanti elementi prima chiedere la riga di cache (0 = nessun prefetch)
+ */
+void distribuisciInt32(int32_t tabella[], const uint32_t indici[], const int32_t valori[], size_t n,
+                       unsigned distanza);
+void distribuisciFloat(float tabella[], const uint32_t indici[], const float valori[], size_t n, unsigned distanza);
+
+#endif // ACCESSO_INDIRETTO_H
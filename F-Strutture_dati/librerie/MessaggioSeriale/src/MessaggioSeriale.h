@@ -0,0 +1,354 @@
+/**
+ * @file MessaggioSeriale.h
+ * @brief Composizione di un messaggio seriale in un buffer e invio con una sola scrittura
+ *
+ * Una catena di Serial.print() fa una chiamata (e una conversione) per ogni
+ * pezzo del messaggio. Qui il messaggio viene composto in un buffer fornito
+ * dal chiamante (di solito un vettore locale, sullo stack) e inviato con
+ * una sola Serial.write(buffer, lunghezza).
+ *
+ * I numeri con la virgola vengono convertiti con un solo arrotondamento a
+ * intero (valore * 10^cifre) e poi cifra per cifra con divisioni intere,
+ * invece della moltiplicazione in virgola mobile per ogni cifra di
+ * Print::printFloat. Il formato e' quello di Serial.print(valore, cifre),
+ * compresi "nan", "inf" e "ovf", ma l'ultima cifra e' uguale solo se il
+ * valore non e' entro un passo del float (la distanza tra due float vicini)
+ * dalla meta' tra due arrotondamenti: printFloat somma 0.5 / 10^cifre e
+ * moltiplica per 10 a ogni cifra in float (su AVR double e' un float), e quei
+ * risultati vengono arrotondati. Esempi:
+ *  - 21.125 con 2 cifre: qui 21.13, printFloat 21.12;
+ *  - 1036545.44 con 1 cifra (il float vale 1036545.4375, passo 0.0625):
+ *    qui 1036545.4, printFloat 1036545.5.
+ * Percentuale di valori con l'ultima cifra diversa (misurata sul PC, con
+ * printFloat rifatto in float): sotto 100 con 1 o 2 cifre meno dello 0.02%;
+ * sotto 10000 con 2 cifre circa l'1%; intorno a 1000000 con 1 cifra circa
+ * il 10%; con 3 o piu' cifre anche meta' dei valori (il passo del float e'
+ * vicino a 10^-cifre). Con 0 cifre il testo e' uguale fino a 8388608 (2^23).
+ *
+ * Modalita' binaria per il gateway: un frame compatto con intestazione,
+ * campi binari (little endian) e CRC-8:
+ *   0xA5 | tipo | lunghezza dati | dati... | CRC-8 di tipo, lunghezza e dati
+ * frameDecodifica() lo rilegge sul PC (il file non dipende da Arduino).
+ *
+ * Uso:
+ *   char buffer[64];
+ *   MessaggioSeriale m;
+ *   messaggioInizia(m, buffer, sizeof(buffer));
+ *   messaggioTesto(m, "Temperatura: ");
+ *   messaggioDecimale(m, temperatura, 2);
+ *   messaggioACapo(m);
+ *   messaggioInvia(m, Serial);
+ *
+ * @author Filippo Bilardo
+ * @version 1.0 18/10/26 - Versione iniziale
+ */
+#ifndef MESSAGGIO_SERIALE_H
+#define MESSAGGIO_SERIALE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define FRAME_INIZIO 0xA5
+#define FRAME_INTESTAZIONE 3   // inizio, tipo, lunghezza
+#define FRAME_MAX_DATI 255
+
+/**
+ * Messaggio in composizione.
+ * Se il testo non sta nel buffer viene troncato e troncato diventa true.
+ */
+struct MessaggioSeriale
+{
+    uint8_t *buffer;
+    size_t dimensione;
+    size_t lunghezza;
+    bool troncato;
+};
+
+/**
+ * Inizia un messaggio vuoto nel buffer indicato
+ * @param m Il messaggio
+ * @param buffer Il buffer (di solito un vettore locale)
+ * @param dimensione La dimensione del buffer in byte
+ */
+inline void messaggioInizia(MessaggioSeriale &m, void *buffer, size_t dimensione)
+{
+    m.buffer = (uint8_t *)buffer;
+    m.dimensione = dimensione;
+    m.lunghezza = 0;
+    m.troncato = false;
+}
+
+/**
+ * Aggiunge n byte al messaggio
+ */
+inline void messaggioByte(MessaggioSeriale &m, const void *dati, size_t n)
+{
+    size_t liberi = m.dimensione - m.lunghezza;
+    if (n > liberi)
+    {
+        n = liberi;
+        m.troncato = true;
+    }
+    memcpy(m.buffer + m.lunghezza, dati, n);
+    m.lunghezza += n;
+}
+
+/**
+ * Aggiunge una stringa terminata da '\0'
+ */
+inline void messaggioTesto(MessaggioSeriale &m, const char *testo)
+{
+    messaggioByte(m, testo, strlen(testo));
+}
+
+/**
+ * Aggiunge un carattere
+ */
+inline void messaggioCarattere(MessaggioSeriale &m, char carattere)
+{
+    messaggioByte(m, &carattere, 1);
+}
+
+/**
+ * Aggiunge il ritorno a capo "\r\n", come Serial.println()
+ */
+inline void messaggioACapo(MessaggioSeriale &m)
+{
+    messaggioByte(m, "\r\n", 2);
+}
+
+/**
+ * Aggiunge un intero senza segno in base 10
+ */
+inline void messaggioNaturale(MessaggioSeriale &m, uint32_t valore)
+{
+    char cifre[10];
+    char *p = cifre + sizeof(cifre);
+    // Con valori a 16 bit la divisione e' molto piu' veloce su AVR
+    while (valore > 0xFFFF)
+    {
+        *--p = '0' + valore % 10;
+        valore /= 10;
+    }
+    uint16_t corto = (uint16_t)valore;
+    do
+    {
+        *--p = '0' + corto % 10;
+        corto /= 10;
+    } while (corto > 0);
+    messaggioByte(m, p, cifre + sizeof(cifre) - p);
+}
+
+/**
+ * Aggiunge un intero con segno in base 10
+ */
+inline void messaggioIntero(MessaggioSeriale &m, long valore)
+{
+    if (valore < 0)
+    {
+        messaggioCarattere(m, '-');
+        messaggioNaturale(m, 0ul - (unsigned long)valore);
+    }
+    else
+    {
+        messaggioNaturale(m, (unsigned long)valore);
+    }
+}
+
+/**
+ * Aggiunge un numero con la virgola, come Serial.print(valore, cifre)
+ * @param m Il messaggio
+ * @param valore Il numero
+ * @param cifre Le cifre dopo la virgola (da 0 a 6)
+ */
+inline void messaggioDecimale(MessaggioSeriale &m, float valore, uint8_t cifre)
+{
+    static const uint32_t POTENZE_10[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+    if (isnan(valore))
+    {
+        messaggioTesto(m, "nan");
+        return;
+    }
+    if (isinf(valore))
+    {
+        messaggioTesto(m, "inf");
+        return;
+    }
+    // Stessi limiti di Print::printFloat
+    if (valore > 4294967040.0f || valore < -4294967040.0f)
+    {
+        messaggioTesto(m, "ovf");
+        return;
+    }
+    if (cifre > 6)
+    {
+        cifre = 6;
+    }
+    if (valore < 0.0f)
+    {
+        messaggioCarattere(m, '-');
+        valore = -valore;
+    }
+
+    // Parte intera separata prima di scalare, per non perdere cifre con numeri grandi
+    uint32_t intera = (uint32_t)valore;
+    uint32_t potenza = POTENZE_10[cifre];
+    uint32_t frazione = (uint32_t)((valore - (float)intera) * potenza + 0.5f);
+    if (frazione >= potenza)
+    {
+        intera++;
+        frazione -= potenza;
+    }
+    messaggioNaturale(m, intera);
+    if (cifre == 0)
+    {
+        return;
+    }
+    messaggioCarattere(m, '.');
+    // Cifre decimali con gli zeri iniziali
+    char testo[6];
+    for (int8_t i = cifre - 1; i >= 0; i--)
+    {
+        testo[i] = '0' + frazione % 10;
+        frazione /= 10;
+    }
+    messaggioByte(m, testo, cifre);
+}
+
+/**
+ * Invia il messaggio con una sola scrittura e lo svuota
+ * @param m Il messaggio
+ * @param porta La porta seriale (Serial o qualsiasi oggetto con write(const uint8_t *, size_t))
+ * @return Il numero di byte inviati
+ */
+template <typename Porta>
+size_t messaggioInvia(MessaggioSeriale &m, Porta &porta)
+{
+    size_t inviati = porta.write(m.buffer, m.lunghezza);
+    m.lunghezza = 0;
+    m.troncato = false;
+    return inviati;
+}
+
+//----------------------------------------------------------------------
+// Frame binari
+//----------------------------------------------------------------------
+
+/**
+ * CRC-8 (polinomio 0x07) di n byte, a partire da crc
+ */
+inline uint8_t frameCrc8(uint8_t crc, const uint8_t *dati, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        crc ^= dati[i];
+        for (uint8_t b = 0; b < 8; b++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * Inizia un frame binario nel messaggio (che deve essere vuoto)
+ * @param m Il messaggio
+ * @param tipo Il tipo di frame, definito dall'applicazione
+ */
+inline void frameInizia(MessaggioSeriale &m, uint8_t tipo)
+{
+    uint8_t intestazione[FRAME_INTESTAZIONE] = {FRAME_INIZIO, tipo, 0};
+    messaggioByte(m, intestazione, sizeof(intestazione));
+}
+
+/**
+ * Aggiunge un campo di n byte al frame, in little endian come in memoria su AVR, ARM e x86
+ */
+inline void frameCampo(MessaggioSeriale &m, const void *valore, size_t n)
+{
+    messaggioByte(m, valore, n);
+}
+
+inline void frameFloat(MessaggioSeriale &m, float valore)
+{
+    frameCampo(m, &valore, sizeof(valore));
+}
+
+inline void frameNaturale32(MessaggioSeriale &m, uint32_t valore)
+{
+    uint8_t byte[4] = {(uint8_t)valore, (uint8_t)(valore >> 8), (uint8_t)(valore >> 16), (uint8_t)(valore >> 24)};
+    frameCampo(m, byte, sizeof(byte));
+}
+
+inline void frameNaturale16(MessaggioSeriale &m, uint16_t valore)
+{
+    uint8_t byte[2] = {(uint8_t)valore, (uint8_t)(valore >> 8)};
+    frameCampo(m, byte, sizeof(byte));
+}
+
+/**
+ * Completa il frame scrivendo la lunghezza dei dati e il CRC
+ * @return false se il frame non sta nel buffer o ha piu' di FRAME_MAX_DATI byte di dati
+ */
+inline bool frameChiudi(MessaggioSeriale &m)
+{
+    if (m.lunghezza < FRAME_INTESTAZIONE || m.lunghezza - FRAME_INTESTAZIONE > FRAME_MAX_DATI)
+    {
+        return false;
+    }
+    m.buffer[2] = (uint8_t)(m.lunghezza - FRAME_INTESTAZIONE);
+    uint8_t crc = frameCrc8(0, m.buffer + 1, m.lunghezza - 1);
+    messaggioByte(m, &crc, 1);
+    return !m.troncato;
+}
+
+/**
+ * Frame decodificato: i dati puntano nel buffer ricevuto
+ */
+struct FrameSeriale
+{
+    uint8_t tipo;
+    uint8_t lunghezza;
+    const uint8_t *dati;
+};
+
+/**
+ * Cerca e decodifica il primo frame valido in un flusso di byte ricevuti
+ * @param dati I byte ricevuti
+ * @param n Il numero di byte
+ * @param frame Il frame trovato
+ * @param consumati Quanti byte sono stati esaminati (da scartare prima della chiamata successiva)
+ * @return true se e' stato trovato un frame completo con CRC corretto
+ */
+inline bool frameDecodifica(const uint8_t *dati, size_t n, FrameSeriale &frame, size_t &consumati)
+{
+    size_t i = 0;
+    while (i < n)
+    {
+        if (dati[i] != FRAME_INIZIO)
+        {
+            i++;
+            continue;
+        }
+        if (n - i < FRAME_INTESTAZIONE + 1 || n - i < (size_t)FRAME_INTESTAZIONE + dati[i + 2] + 1)
+        {
+            break; // frame incompleto: si aspettano altri byte
+        }
+        size_t lunghezza = dati[i + 2];
+        if (frameCrc8(0, dati + i + 1, lunghezza + 2) == dati[i + FRAME_INTESTAZIONE + lunghezza])
+        {
+            frame.tipo = dati[i + 1];
+            frame.lunghezza = (uint8_t)lunghezza;
+            frame.dati = dati + i + FRAME_INTESTAZIONE;
+            consumati = i + FRAME_INTESTAZIONE + lunghezza + 1;
+            return true;
+        }
+        i++; // CRC errato: 0xA5 era un byte qualsiasi, si cerca il prossimo
+    }
+    consumati = i;
+    return false;
+}
+
+#endif // MESSAGGIO_SERIALE_H
@@ -0,0 +1,219 @@
+/**
+ * @file bench_matrice.cpp
+ * @brief Matrice<T, R, C> srotolata contro le funzioni con righe e colonne passate a runtime
+ *
+ * Su un vettore di tante matrici piccole esegue le stesse operazioni con le
+ * funzioni a due o tre cicli che ricevono le dimensioni come parametri (come
+ * modificaMatrice di example4_flattened_array.c) e con Matrice:
+ *  - numero di riga aggiunto a ogni elemento di matrici 3 x 4 di int
+ *    (modificaMatrice di example2_variable_rows.c);
+ *  - massimo di matrici 3 x 4 di int (cercaMassimo di es_matrici.c);
+ *  - prodotto di matrici 3 x 4 per 4 x 3 di int;
+ *  - prodotto di matrici 4 x 4 di float.
+ * Le dimensioni per le funzioni a runtime vengono lette da variabili volatile,
+ * cosi' il compilatore non puo' sostituirle con costanti e srotolare i cicli.
+ * I risultati delle due versioni devono coincidere.
+ *
+ * Compilazione:
+ *   g++ -O2 -std=c++17 bench_matrice.cpp -o bench_matrice
+ * Utilizzo:
+ *   ./bench_matrice [milioni di matrici per prova]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "matrice.h"
+
+static double secondi() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Dimensioni lette a runtime (il compilatore non ne conosce il valore)
+static volatile int righeEsterne = 3;
+static volatile int colonneEsterne = 4;
+static volatile int latoEsterno = 4;
+
+// Matrici per prova: 4096 3 x 4 di int sono 192 KB, stanno nella cache L2
+const size_t MATRICI = 4096;
+
+//----------------------------------------------------------------------
+// Versioni con le dimensioni come parametri, matrici in vettori unici
+//----------------------------------------------------------------------
+
+static void aggiungiRiga(int *matrice, int righe, int colonne) {
+    for (int i = 0; i < righe; i++) {
+        for (int j = 0; j < colonne; j++) {
+            matrice[i * colonne + j] += i;
+        }
+    }
+}
+
+static int cercaMassimo(const int *matrice, int righe, int colonne) {
+    int massimo = matrice[0];
+    for (int i = 0; i < righe; i++) {
+        for (int j = 0; j < colonne; j++) {
+            if (matrice[i * colonne + j] > massimo) {
+                massimo = matrice[i * colonne + j];
+            }
+        }
+    }
+    return massimo;
+}
+
+// c (righe x colonne) = a (righe x comune) * b (comune x colonne)
+template <typename T>
+static void prodotto(const T *a, const T *b, T *c, int righe, int comune, int colonne) {
+    for (int i = 0; i < righe; i++) {
+        for (int j = 0; j < colonne; j++) {
+            T somma = 0;
+            for (int k = 0; k < comune; k++) {
+                somma += a[i * comune + k] * b[k * colonne + j];
+            }
+            c[i * colonne + j] = somma;
+        }
+    }
+}
+
+typedef Matrice<int, 3, 4> M34;
+typedef Matrice<int, 4, 3> M43;
+typedef Matrice<int, 3, 3> M33;
+typedef Matrice<float, 4, 4> M44;
+
+// Matrice con il numero di riga in ogni elemento, calcolata durante la compilazione
+static constexpr M34 numeriRiga() {
+    M34 risultato{};
+    for (size_t i = 0; i < risultato.righe(); i++) {
+        for (size_t j = 0; j < risultato.colonne(); j++) {
+            risultato[i][j] = (int)i;
+        }
+    }
+    return risultato;
+}
+
+// Esegue funzione() "giri" volte e restituisce i nanosecondi per matrice
+template <class Funzione>
+static double misura(size_t giri, Funzione funzione) {
+    funzione();
+    double t0 = secondi();
+    for (size_t g = 0; g < giri; g++) {
+        funzione();
+    }
+    return (secondi() - t0) / (giri * MATRICI) * 1e9;
+}
+
+static void stampa(const char *nome, double runtime, double srotolata, bool uguali) {
+    printf("%-32s %10.2f %10.2f %8.1fx %s\n", nome, runtime, srotolata, runtime / srotolata, uguali ? "" : "DIVERSI");
+}
+
+int main(int argc, char *argv[]) {
+    double milioni = argc > 1 ? atof(argv[1]) : 20;
+    size_t giri = (size_t)(milioni * 1e6 / MATRICI) + 1;
+    int righe = righeEsterne;
+    int colonne = colonneEsterne;
+    int lato = latoEsterno;
+    int errori = 0;
+
+    std::vector<M34> a(MATRICI);
+    std::vector<M43> b(MATRICI);
+    std::vector<M44> f(MATRICI);
+    std::vector<M44> g(MATRICI);
+    unsigned seme = 1;
+    for (size_t n = 0; n < MATRICI; n++) {
+        for (size_t k = 0; k < 12; k++) {
+            a[n].elemento(k) = rand_r(&seme) % 201 - 100;
+            b[n].elemento(k) = rand_r(&seme) % 201 - 100;
+        }
+        for (size_t k = 0; k < 16; k++) {
+            f[n].elemento(k) = (rand_r(&seme) % 2001 - 1000) / 256.0f;
+            g[n].elemento(k) = (rand_r(&seme) % 2001 - 1000) / 256.0f;
+        }
+    }
+
+    printf("%zu matrici per prova, %zu giri (ns per matrice)\n\n", MATRICI, giri);
+    printf("%-32s %10s %10s %9s\n", "operazione", "runtime", "Matrice", "rapporto");
+
+    // Numero di riga aggiunto a ogni elemento: con Matrice si somma una matrice
+    // costante calcolata durante la compilazione
+    {
+        constexpr M34 NUMERI_RIGA = numeriRiga();
+        std::vector<M34> x = a;
+        std::vector<M34> y = a;
+        double runtime = misura(giri, [&] {
+            for (M34 &m : x) {
+                aggiungiRiga(&m.m[0][0], righe, colonne);
+            }
+        });
+        double srotolata = misura(giri, [&] {
+            for (M34 &m : y) {
+                m += NUMERI_RIGA;
+            }
+        });
+        // Stesso numero di giri, quindi stessi valori
+        bool uguali = memcmp(x.data(), y.data(), sizeof(M34) * MATRICI) == 0;
+        errori += !uguali;
+        stampa("numero di riga (3 x 4 int)", runtime, srotolata, uguali);
+    }
+
+    {
+        long long totaleRuntime = 0;
+        long long totaleSrotolata = 0;
+        double runtime = misura(giri, [&] {
+            for (const M34 &m : a) {
+                totaleRuntime += cercaMassimo(&m.m[0][0], righe, colonne);
+            }
+        });
+        double srotolata = misura(giri, [&] {
+            for (const M34 &m : a) {
+                totaleSrotolata += massimo(m);
+            }
+        });
+        bool uguali = totaleRuntime == totaleSrotolata;
+        errori += !uguali;
+        stampa("massimo (3 x 4 int)", runtime, srotolata, uguali);
+    }
+
+    {
+        std::vector<M33> x(MATRICI);
+        std::vector<M33> y(MATRICI);
+        double runtime = misura(giri, [&] {
+            for (size_t n = 0; n < MATRICI; n++) {
+                prodotto(&a[n].m[0][0], &b[n].m[0][0], &x[n].m[0][0], righe, colonne, righe);
+            }
+        });
+        double srotolata = misura(giri, [&] {
+            for (size_t n = 0; n < MATRICI; n++) {
+                y[n] = a[n] * b[n];
+            }
+        });
+        bool uguali = memcmp(x.data(), y.data(), sizeof(M33) * MATRICI) == 0;
+        errori += !uguali;
+        stampa("prodotto (3 x 4) * (4 x 3) int", runtime, srotolata, uguali);
+    }
+
+    {
+        std::vector<M44> x(MATRICI);
+        std::vector<M44> y(MATRICI);
+        double runtime = misura(giri, [&] {
+            for (size_t n = 0; n < MATRICI; n++) {
+                prodotto(&f[n].m[0][0], &g[n].m[0][0], &x[n].m[0][0], lato, lato, lato);
+            }
+        });
+        double srotolata = misura(giri, [&] {
+            for (size_t n = 0; n < MATRICI; n++) {
+                y[n] = f[n] * g[n];
+            }
+        });
+        // Stessi prodotti sommati nello stesso ordine: anche i float devono coincidere
+        // (con -ffast-math o -ffp-contract il compilatore potrebbe riordinarli diversamente)
+        bool uguali = memcmp(x.data(), y.data(), sizeof(M44) * MATRICI) == 0;
+        errori += !uguali;
+        stampa("prodotto 4 x 4 float", runtime, srotolata, uguali);
+    }
+
+    return errori > 0;
+}
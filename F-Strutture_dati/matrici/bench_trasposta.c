@@ -0,0 +1,161 @@
+/**
+ * @file bench_trasposta.c
+ * @brief Trasposta con due cicli, ricorsiva, con piu' thread e sul posto, confrontate con memcpy
+ *
+ * Per matrici quadrate e rettangolari (anche con dimensioni non multiple di 8)
+ * misura i GB/s (byte letti + scritti al secondo) della trasposta con due
+ * cicli come in es_matrici.c, di traspostaInt con un thread e con tutti, e di
+ * memcpy della stessa matrice, che e' il limite da raggiungere. Poi la
+ * trasposta sul posto di matrici quadrate. Tutti i risultati vengono
+ * controllati con la versione a due cicli.
+ *
+ * Compilazione:
+ *   gcc -O2 -std=c11 -pthread bench_trasposta.c trasposta.c -o bench_trasposta
+ * Utilizzo:
+ *   ./bench_trasposta [thread]     (predefinito: tutti i processori)
+ */
+#define _POSIX_C_SOURCE 199309L   // clock_gettime con -std=c11
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "trasposta.h"
+
+static double secondi(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void traspostaDueCicli(const int sorgente[], int destinazione[], size_t righe, size_t colonne) {
+    for (size_t i = 0; i < righe; i++) {
+        for (size_t j = 0; j < colonne; j++) {
+            destinazione[j * righe + i] = sorgente[i * colonne + j];
+        }
+    }
+}
+
+static void traspostaQuadrataDueCicli(int matrice[], size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = i + 1; j < n; j++) {
+            int x = matrice[i * n + j];
+            matrice[i * n + j] = matrice[j * n + i];
+            matrice[j * n + i] = x;
+        }
+    }
+}
+
+// Ripetizioni per circa 1 GB di dati spostati, almeno 3
+static int ripetizioniPer(size_t byte) {
+    size_t r = ((size_t)1 << 30) / byte;
+    return r < 3 ? 3 : (int)r;
+}
+
+// GB/s di byte letti + scritti, con il migliore di "ripetizioni" tentativi
+#define MISURA(risultato, byte, istruzione)                          \
+    do {                                                             \
+        double migliore = 1e30;                                      \
+        int ripetizioni = ripetizioniPer(byte);                      \
+        for (int r_ = 0; r_ < ripetizioni; r_++) {                   \
+            double t0_ = secondi();                                  \
+            istruzione;                                              \
+            double t_ = secondi() - t0_;                             \
+            migliore = t_ < migliore ? t_ : migliore;                \
+        }                                                            \
+        risultato = 2.0 * (byte) / migliore * 1e-9;                  \
+    } while (0)
+
+static int provaRettangolare(size_t righe, size_t colonne, unsigned thread) {
+    size_t n = righe * colonne;
+    size_t byte = n * sizeof(int);
+    int *sorgente = malloc(byte);
+    int *attesa = malloc(byte);
+    int *destinazione = malloc(byte);
+    if (sorgente == NULL || attesa == NULL || destinazione == NULL) {
+        printf("Memoria insufficiente\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < n; i++) {
+        sorgente[i] = (int)(i * 2654435761u);
+    }
+    double copia, dueCicli, uno, tutti;
+    MISURA(copia, byte, memcpy(destinazione, sorgente, byte));
+    MISURA(dueCicli, byte, traspostaDueCicli(sorgente, attesa, righe, colonne));
+    MISURA(uno, byte, traspostaInt(sorgente, destinazione, righe, colonne, 1));
+    int errori = memcmp(destinazione, attesa, byte) != 0;
+    memset(destinazione, 0, byte);
+    MISURA(tutti, byte, traspostaInt(sorgente, destinazione, righe, colonne, thread));
+    errori += memcmp(destinazione, attesa, byte) != 0;
+    // float: stessi bit, devono dare lo stesso risultato
+    memset(destinazione, 0, byte);
+    traspostaFloat((const float *)(const void *)sorgente, (float *)(void *)destinazione, righe, colonne, thread);
+    errori += memcmp(destinazione, attesa, byte) != 0;
+
+    printf("%6zu x %-6zu %10.2f %10.2f %10.2f %10.2f %s\n", righe, colonne, copia, dueCicli, uno, tutti,
+           errori ? "ERRORE" : "");
+    free(sorgente);
+    free(attesa);
+    free(destinazione);
+    return errori;
+}
+
+static int provaQuadrata(size_t lato, unsigned thread) {
+    size_t n = lato * lato;
+    size_t byte = n * sizeof(int);
+    int *matrice = malloc(byte);
+    int *attesa = malloc(byte);
+    if (matrice == NULL || attesa == NULL) {
+        printf("Memoria insufficiente\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < n; i++) {
+        matrice[i] = attesa[i] = (int)(i * 2654435761u);
+    }
+    double dueCicli, uno, tutti;
+    // Ogni misura traspone la matrice: dopo un numero pari di ripetizioni torna com'era
+    MISURA(dueCicli, byte, traspostaQuadrataDueCicli(matrice, lato));
+    MISURA(uno, byte, traspostaQuadrataInt(matrice, lato, 1));
+    MISURA(tutti, byte, traspostaQuadrataInt(matrice, lato, thread));
+    int ripetizioni = ripetizioniPer(byte);
+    if (ripetizioni % 2 == 1) {
+        traspostaQuadrataDueCicli(attesa, lato);
+    }
+    int errori = memcmp(matrice, attesa, byte) != 0;
+    // Controllo di una singola trasposta con il risultato della versione a due cicli
+    traspostaQuadrataInt(matrice, lato, thread);
+    traspostaQuadrataDueCicli(attesa, lato);
+    errori += memcmp(matrice, attesa, byte) != 0;
+
+    printf("%6zu x %-6zu %10s %10.2f %10.2f %10.2f %s\n", lato, lato, "-", dueCicli, uno, tutti,
+           errori ? "ERRORE" : "");
+    free(matrice);
+    free(attesa);
+    return errori;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned thread = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 10) : 0;
+    int errori = 0;
+
+    printf("Trasposta in una nuova matrice (GB/s, letti + scritti)\n");
+    printf("%-15s %10s %10s %10s %10s\n", "dimensioni", "memcpy", "due cicli", "1 thread", "tutti");
+    static const size_t DIMENSIONI[][2] = {{7, 13},     {64, 64},     {100, 37},    {256, 256},  {1000, 1000},
+                                           {1024, 1024}, {2048, 2048}, {4096, 4096}, {3001, 5003}, {100, 100000},
+                                           {100000, 100}};
+    for (size_t i = 0; i < sizeof(DIMENSIONI) / sizeof(DIMENSIONI[0]); i++) {
+        errori += provaRettangolare(DIMENSIONI[i][0], DIMENSIONI[i][1], thread);
+    }
+
+    printf("\nTrasposta sul posto di matrici quadrate (GB/s, letti + scritti)\n");
+    printf("%-15s %10s %10s %10s %10s\n", "dimensioni", "", "due cicli", "1 thread", "tutti");
+    static const size_t LATI[] = {1, 9, 64, 100, 1000, 1024, 2048, 4096, 4099};
+    for (size_t i = 0; i < sizeof(LATI) / sizeof(LATI[0]); i++) {
+        errori += provaQuadrata(LATI[i], thread);
+    }
+
+    if (errori > 0) {
+        printf("\n%d risultati diversi dalla trasposta a due cicli\n", errori);
+    }
+    return errori > 0;
+}
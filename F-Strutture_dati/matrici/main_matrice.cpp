@@ -0,0 +1,91 @@
+/**
+ * @file main_matrice.cpp
+ * @brief Matrice<int, RIGHE, COLONNE> con le funzioni di example1_fixed_dimensions.c e calcoli constexpr
+ *
+ * Le funzioni modificaMatrice e stampaMatrice di example1_fixed_dimensions.c
+ * (parametro int matrice[RIGHE][COLONNE]) ricevono i dati di una Matrice con
+ * a.dati(). I static_assert vengono verificati dal compilatore: se il file
+ * compila, prodotto, trasposta e riduzioni danno i risultati attesi e le
+ * operazioni senza senso (confronto tra dimensioni diverse, somma con un
+ * intero, uso come condizione) non compilano.
+ *
+ * Compilazione:
+ *   g++ -O2 -std=c++17 main_matrice.cpp -o main_matrice
+ */
+#include <stdio.h>
+#include <type_traits>
+
+#include "matrice.h"
+
+#define main main_example1
+#include "../ES03_Battaglia_navale/example1_fixed_dimensions.c"
+#undef main
+
+// Calcoli fatti durante la compilazione
+constexpr Matrice<int, 2, 3> A = {{{1, 2, 3}, {4, 5, 6}}};
+constexpr Matrice<int, 3, 2> B = trasposta(A);
+constexpr Matrice<int, 2, 2> AB = A * B;
+static_assert(B[2][1] == 6, "trasposta");
+static_assert(AB[0][0] == 14 && AB[0][1] == 32 && AB[1][1] == 77, "prodotto righe per colonne");
+static_assert(somma(A) == 21 && minimo(A) == 1 && massimo(A) == 6, "riduzioni");
+static_assert(traccia(AB) == 91, "traccia");
+static_assert(A * Matrice<int, 3, 3>::identita() == A, "identita'");
+static_assert(sommeRighe(A)[1][0] == 15, "somme delle righe");
+static_assert(sizeof(Matrice<int, RIGHE, COLONNE>) == sizeof(int[RIGHE][COLONNE]), "stessa disposizione di int[R][C]");
+
+// Espressioni che non devono compilare: true se a == b, a + b, a - b compilano
+template <class X, class Y, class = void>
+struct confrontabili : std::false_type {};
+template <class X, class Y>
+struct confrontabili<X, Y, std::void_t<decltype(std::declval<X>() == std::declval<Y>())>> : std::true_type {};
+template <class X, class Y, class = void>
+struct sommabili : std::false_type {};
+template <class X, class Y>
+struct sommabili<X, Y, std::void_t<decltype(std::declval<X>() + std::declval<Y>())>> : std::true_type {};
+template <class X, class Y, class = void>
+struct sottraibili : std::false_type {};
+template <class X, class Y>
+struct sottraibili<X, Y, std::void_t<decltype(std::declval<X>() - std::declval<Y>())>> : std::true_type {};
+
+typedef Matrice<int, 3, 4> M34;
+typedef Matrice<int, 2, 4> M24;
+static_assert(confrontabili<M34, M34>::value && sommabili<M34, M34>::value, "stesse dimensioni");
+static_assert(!confrontabili<M34, M24>::value && !sottraibili<M34, M24>::value, "dimensioni diverse");
+static_assert(!sommabili<M34, int>::value && !sottraibili<M34, int>::value && !sommabili<int, M34>::value,
+              "nessuna aritmetica dei puntatori");
+static_assert(!std::is_constructible<bool, M34>::value, "una matrice non e' una condizione");
+
+int main() {
+    Matrice<int, RIGHE, COLONNE> a = {{{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}}};
+
+    printf("Matrice originale:\n");
+    stampaMatrice(a.dati());
+
+    // La funzione di example1 modifica la matrice sul posto (ogni elemento per 2)
+    modificaMatrice(a.dati());
+    printf("\nDopo modificaMatrice (funzione di example1):\n");
+    stampaMatrice(a.dati());
+
+    // La stessa cosa con l'operatore, srotolato
+    Matrice<int, RIGHE, COLONNE> b = {{{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}}};
+    b *= 2;
+    printf("\nb * 2 uguale al risultato di modificaMatrice: %s\n", a == b ? "si" : "no");
+
+    // Da e verso un vettore bidimensionale
+    int vettore[RIGHE][COLONNE];
+    (a - b + a).copiaIn(vettore);
+    Matrice<int, COLONNE, RIGHE> t = trasposta(Matrice<int, RIGHE, COLONNE>::da(vettore));
+    printf("\nTrasposta (%zu x %zu):\n", t.righe(), t.colonne());
+    for (size_t i = 0; i < t.righe(); i++) {
+        for (size_t j = 0; j < t.colonne(); j++) {
+            printf("%3d ", t[i][j]);
+        }
+        printf("\n");
+    }
+
+    // a (3 x 4) per la sua trasposta (4 x 3): matrice 3 x 3
+    Matrice<int, RIGHE, RIGHE> q = a * trasposta(a);
+    printf("\nsomma %d, minimo %d, massimo %d, traccia di a * trasposta(a) %d\n", somma(a), minimo(a), massimo(a),
+           traccia(q));
+    return 0;
+}
@@ -0,0 +1,252 @@
+/**
+ * @file matrice.h
+ * @brief Matrice<T, R, C>: matrici piccole con le dimensioni nel tipo, operazioni srotolate e constexpr
+ *
+ * example1_fixed_dimensions.c e es_matrici.c fissano le dimensioni con
+ * #define RIGHE 3 / COLONNE 4 (o R 3 / C 4); le funzioni che ricevono righe e
+ * colonne come parametri (example4_flattened_array.c) funzionano per ogni
+ * dimensione ma con due cicli di pochi giri: su miliardi di matrici 3 x 4 il
+ * tempo va nei contatori, nei confronti e nei salti dei cicli invece che nei
+ * calcoli.
+ *
+ * In Matrice<T, R, C> le dimensioni sono parametri del template: ogni
+ * operazione e' scritta come espansione di una sequenza di indici
+ * (std::index_sequence), quindi il compilatore genera direttamente le R * C
+ * istruzioni, senza cicli, e le puo' unire in istruzioni SIMD. Tutte le
+ * funzioni sono constexpr: con argomenti costanti il risultato si calcola
+ * durante la compilazione (static_assert, tabelle costanti).
+ *
+ * La matrice e' un aggregato con dentro un vettore T m[R][C], con la stessa
+ * disposizione in memoria di int m[R][C]:
+ *   Matrice<int, RIGHE, COLONNE> a = {{{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}}};
+ *   a[1][2] = 0;               // come un vettore bidimensionale
+ *   modificaMatrice(a.dati()); // void modificaMatrice(int matrice[RIGHE][COLONNE])
+ *   a = Matrice<int, RIGHE, COLONNE>::da(miaMatrice);   // copia da int miaMatrice[RIGHE][COLONNE]
+ *
+ * Pensata per matrici fino a qualche decina di elementi: per matrici grandi
+ * il codice srotolato diventa troppo lungo.
+ * Richiede C++17.
+ */
+#ifndef MATRICE_H
+#define MATRICE_H
+
+#include <stddef.h>
+#include <utility>
+
+namespace matrice_dettaglio {
+
+template <class F, size_t... I>
+constexpr void ripeti(F &&f, std::index_sequence<I...>) {
+    (f(std::integral_constant<size_t, I>{}), ...);
+}
+
+/** Chiama f(k) per k da 0 a N - 1, con k costante: nessun ciclo nel codice generato */
+template <size_t N, class F>
+constexpr void ripeti(F &&f) {
+    ripeti(f, std::make_index_sequence<N>{});
+}
+
+} // namespace matrice_dettaglio
+
+template <typename T, size_t R, size_t C>
+struct Matrice {
+    static_assert(R > 0 && C > 0, "le dimensioni devono essere almeno 1");
+
+    typedef T Elemento;
+    typedef T Riga[C];
+
+    // Funzioni e non costanti RIGHE/COLONNE, che negli esercizi sono gia' delle #define
+    static constexpr size_t righe() { return R; }
+    static constexpr size_t colonne() { return C; }
+
+    T m[R][C];
+
+    /** Riga i: a[i][j] come con un vettore bidimensionale */
+    constexpr Riga &operator[](size_t i) { return m[i]; }
+    constexpr const Riga &operator[](size_t i) const { return m[i]; }
+
+    /**
+     * Puntatore alla prima riga, come int m[R][C] passato a una funzione con
+     * parametro int matrice[R][C] o int matrice[][C]. Non e' una conversione
+     * implicita: con quella a == b tra matrici di dimensioni diverse
+     * confronterebbe gli indirizzi, a + 1 sarebbe un puntatore e if (a)
+     * sarebbe sempre vero, invece di non compilare.
+     */
+    constexpr Riga *dati() { return m; }
+    constexpr const Riga *dati() const { return m; }
+
+    /** Elemento k in ordine di riga (k = i * C + j) */
+    constexpr T &elemento(size_t k) { return m[k / C][k % C]; }
+    constexpr const T &elemento(size_t k) const { return m[k / C][k % C]; }
+
+    /** Copia di un vettore bidimensionale T v[R][C] */
+    static constexpr Matrice da(const T (&v)[R][C]) {
+        Matrice risultato{};
+        matrice_dettaglio::ripeti<R * C>([&](auto k) { risultato.elemento(k) = v[k / C][k % C]; });
+        return risultato;
+    }
+
+    /** Matrice con tutti gli elementi uguali a valore */
+    static constexpr Matrice uguali(T valore) {
+        Matrice risultato{};
+        matrice_dettaglio::ripeti<R * C>([&](auto k) { risultato.elemento(k) = valore; });
+        return risultato;
+    }
+
+    /** Matrice identita' (solo quadrate) */
+    static constexpr Matrice identita() {
+        static_assert(R == C, "l'identita' esiste solo per matrici quadrate");
+        Matrice risultato{};
+        matrice_dettaglio::ripeti<R>([&](auto i) { risultato.m[i][i] = T(1); });
+        return risultato;
+    }
+
+    /** Copia la matrice nel vettore bidimensionale v */
+    constexpr void copiaIn(T (&v)[R][C]) const {
+        matrice_dettaglio::ripeti<R * C>([&](auto k) { v[k / C][k % C] = elemento(k); });
+    }
+
+    constexpr Matrice &operator+=(const Matrice &b) {
+        matrice_dettaglio::ripeti<R * C>([&](auto k) { elemento(k) += b.elemento(k); });
+        return *this;
+    }
+
+    constexpr Matrice &operator-=(const Matrice &b) {
+        matrice_dettaglio::ripeti<R * C>([&](auto k) { elemento(k) -= b.elemento(k); });
+        return *this;
+    }
+
+    constexpr Matrice &operator*=(T scalare) {
+        matrice_dettaglio::ripeti<R * C>([&](auto k) { elemento(k) *= scalare; });
+        return *this;
+    }
+};
+
+//----------------------------------------------------------------------
+// Operazioni elemento per elemento
+//----------------------------------------------------------------------
+
+/** Matrice con f(a[i][j]) per ogni elemento */
+template <typename T, size_t R, size_t C, class F>
+constexpr auto mappa(const Matrice<T, R, C> &a, F f) {
+    Matrice<decltype(f(a.m[0][0])), R, C> risultato{};
+    matrice_dettaglio::ripeti<R * C>([&](auto k) { risultato.elemento(k) = f(a.elemento(k)); });
+    return risultato;
+}
+
+/** Matrice con f(a[i][j], b[i][j]) per ogni elemento */
+template <typename T, size_t R, size_t C, class F>
+constexpr auto combina(const Matrice<T, R, C> &a, const Matrice<T, R, C> &b, F f) {
+    Matrice<decltype(f(a.m[0][0], b.m[0][0])), R, C> risultato{};
+    matrice_dettaglio::ripeti<R * C>([&](auto k) { risultato.elemento(k) = f(a.elemento(k), b.elemento(k)); });
+    return risultato;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Matrice<T, R, C> operator+(Matrice<T, R, C> a, const Matrice<T, R, C> &b) {
+    return a += b;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Matrice<T, R, C> operator-(Matrice<T, R, C> a, const Matrice<T, R, C> &b) {
+    return a -= b;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Matrice<T, R, C> operator*(Matrice<T, R, C> a, typename Matrice<T, R, C>::Elemento scalare) {
+    return a *= scalare;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Matrice<T, R, C> operator*(typename Matrice<T, R, C>::Elemento scalare, Matrice<T, R, C> a) {
+    return a *= scalare;
+}
+
+/** Prodotto elemento per elemento (di Hadamard) */
+template <typename T, size_t R, size_t C>
+constexpr Matrice<T, R, C> prodottoElementi(const Matrice<T, R, C> &a, const Matrice<T, R, C> &b) {
+    return combina(a, b, [](T x, T y) { return x * y; });
+}
+
+template <typename T, size_t R, size_t C>
+constexpr bool operator==(const Matrice<T, R, C> &a, const Matrice<T, R, C> &b) {
+    bool uguali = true;
+    matrice_dettaglio::ripeti<R * C>([&](auto k) { uguali = uguali && a.elemento(k) == b.elemento(k); });
+    return uguali;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr bool operator!=(const Matrice<T, R, C> &a, const Matrice<T, R, C> &b) {
+    return !(a == b);
+}
+
+//----------------------------------------------------------------------
+// Prodotti
+//----------------------------------------------------------------------
+
+/** Prodotto righe per colonne: (R x K) * (K x C) = R x C */
+template <typename T, size_t R, size_t K, size_t C>
+constexpr Matrice<T, R, C> operator*(const Matrice<T, R, K> &a, const Matrice<T, K, C> &b) {
+    Matrice<T, R, C> risultato{};
+    // Per ogni riga i: risultato[i] = somma su k di a[i][k] * b[k] (righe intere, facili da vettorizzare)
+    matrice_dettaglio::ripeti<R>([&](auto i) {
+        matrice_dettaglio::ripeti<K>([&](auto k) {
+            matrice_dettaglio::ripeti<C>([&](auto j) { risultato.m[i][j] += a.m[i][k] * b.m[k][j]; });
+        });
+    });
+    return risultato;
+}
+
+/** Matrice trasposta */
+template <typename T, size_t R, size_t C>
+constexpr Matrice<T, C, R> trasposta(const Matrice<T, R, C> &a) {
+    Matrice<T, C, R> risultato{};
+    matrice_dettaglio::ripeti<R * C>([&](auto k) { risultato.m[k % C][k / C] = a.elemento(k); });
+    return risultato;
+}
+
+//----------------------------------------------------------------------
+// Riduzioni
+//----------------------------------------------------------------------
+
+/** Somma di tutti gli elementi */
+template <typename T, size_t R, size_t C>
+constexpr T somma(const Matrice<T, R, C> &a) {
+    T risultato{};
+    matrice_dettaglio::ripeti<R * C>([&](auto k) { risultato += a.elemento(k); });
+    return risultato;
+}
+
+/** Elemento piu' piccolo (cercaMinimo di es_matrici.c) */
+template <typename T, size_t R, size_t C>
+constexpr T minimo(const Matrice<T, R, C> &a) {
+    T risultato = a.m[0][0];
+    matrice_dettaglio::ripeti<R * C>([&](auto k) { risultato = a.elemento(k) < risultato ? a.elemento(k) : risultato; });
+    return risultato;
+}
+
+/** Elemento piu' grande (cercaMassimo di es_matrici.c) */
+template <typename T, size_t R, size_t C>
+constexpr T massimo(const Matrice<T, R, C> &a) {
+    T risultato = a.m[0][0];
+    matrice_dettaglio::ripeti<R * C>([&](auto k) { risultato = a.elemento(k) > risultato ? a.elemento(k) : risultato; });
+    return risultato;
+}
+
+/** Somma della diagonale (solo quadrate) */
+template <typename T, size_t N>
+constexpr T traccia(const Matrice<T, N, N> &a) {
+    T risultato{};
+    matrice_dettaglio::ripeti<N>([&](auto i) { risultato += a.m[i][i]; });
+    return risultato;
+}
+
+/** Somme delle righe, come vettore colonna R x 1 */
+template <typename T, size_t R, size_t C>
+constexpr Matrice<T, R, 1> sommeRighe(const Matrice<T, R, C> &a) {
+    Matrice<T, R, 1> risultato{};
+    matrice_dettaglio::ripeti<R * C>([&](auto k) { risultato.m[k / C][0] += a.elemento(k); });
+    return risultato;
+}
+
+#endif // MATRICE_H
@@ -0,0 +1,469 @@
+/**
+ * @file trasposta.c
+ * @brief Divisione ricorsiva, quadrati 8 x 8 SIMD (SSE2, AVX2 scelto a runtime) e riquadri tra i thread
+ */
+#define _GNU_SOURCE   // sysconf(_SC_NPROCESSORS_ONLN) con -std=c11
+#include "trasposta.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define TRASPOSTA_X86 1
+#endif
+
+// int e float hanno la stessa dimensione: la trasposta sposta parole di 32 bit
+// senza guardarne il contenuto, e puo' leggerle e scriverle al posto di entrambi
+typedef int32_t __attribute__((may_alias)) Parola32;
+
+// Lato massimo dei blocchi trattati senza dividerli: 64 x 64 parole sono 16 KB,
+// sorgente e destinazione insieme stanno nei 32 KB della cache L1
+#define FOGLIA 64
+// Lato dei riquadri divisi tra i thread
+#define RIQUADRO 512
+#define MASSIMO_THREAD 64
+
+// Meta' di n arrotondata a un multiplo di 8 (n > FOGLIA, quindi resta minore di n)
+static size_t meta8(size_t n) {
+    return (n / 2 + 7) & ~(size_t)7;
+}
+
+//----------------------------------------------------------------------
+// Quadrati 8 x 8: d[j * ld + i] = s[i * ls + j]
+//----------------------------------------------------------------------
+
+typedef void (*Quadrato8)(const Parola32 *s, size_t ls, Parola32 *d, size_t ld);
+
+static inline __attribute__((always_inline)) void quadrato8Scalare(const Parola32 *s, size_t ls, Parola32 *d,
+                                                                    size_t ld) {
+    Parola32 copia[8][8];
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            copia[j][i] = s[i * ls + j];
+        }
+    }
+    for (int j = 0; j < 8; j++) {
+        memcpy(&d[j * ld], copia[j], sizeof(copia[j]));
+    }
+}
+
+#ifdef TRASPOSTA_X86
+
+// Trasposta 4 x 4 di quattro righe di interi a 32 bit
+#define TRASPONI4(r0, r1, r2, r3)                      \
+    do {                                               \
+        __m128i t0 = _mm_unpacklo_epi32(r0, r1);       \
+        __m128i t1 = _mm_unpacklo_epi32(r2, r3);       \
+        __m128i t2 = _mm_unpackhi_epi32(r0, r1);       \
+        __m128i t3 = _mm_unpackhi_epi32(r2, r3);       \
+        r0 = _mm_unpacklo_epi64(t0, t1);               \
+        r1 = _mm_unpackhi_epi64(t0, t1);               \
+        r2 = _mm_unpacklo_epi64(t2, t3);               \
+        r3 = _mm_unpackhi_epi64(t2, t3);               \
+    } while (0)
+
+// Quattro trasposte 4 x 4: il quadrato in alto a destra va in basso a sinistra e viceversa
+static inline __attribute__((always_inline)) void quadrato8Sse2(const Parola32 *s, size_t ls, Parola32 *d,
+                                                                 size_t ld) {
+    for (int blocco = 0; blocco < 4; blocco++) {
+        int r = (blocco >> 1) * 4;
+        int c = (blocco & 1) * 4;
+        __m128i x0 = _mm_loadu_si128((const __m128i *)&s[(r + 0) * ls + c]);
+        __m128i x1 = _mm_loadu_si128((const __m128i *)&s[(r + 1) * ls + c]);
+        __m128i x2 = _mm_loadu_si128((const __m128i *)&s[(r + 2) * ls + c]);
+        __m128i x3 = _mm_loadu_si128((const __m128i *)&s[(r + 3) * ls + c]);
+        TRASPONI4(x0, x1, x2, x3);
+        _mm_storeu_si128((__m128i *)&d[(c + 0) * ld + r], x0);
+        _mm_storeu_si128((__m128i *)&d[(c + 1) * ld + r], x1);
+        _mm_storeu_si128((__m128i *)&d[(c + 2) * ld + r], x2);
+        _mm_storeu_si128((__m128i *)&d[(c + 3) * ld + r], x3);
+    }
+}
+
+// Otto righe da 8 in registri da 256 bit: scambio a coppie di 32 bit, di 64 bit, poi delle meta' da 128 bit
+static inline __attribute__((always_inline, target("avx2"))) void quadrato8Avx2(const Parola32 *s, size_t ls,
+                                                                                Parola32 *d, size_t ld) {
+    __m256 r0 = _mm256_loadu_ps((const float *)&s[0 * ls]);
+    __m256 r1 = _mm256_loadu_ps((const float *)&s[1 * ls]);
+    __m256 r2 = _mm256_loadu_ps((const float *)&s[2 * ls]);
+    __m256 r3 = _mm256_loadu_ps((const float *)&s[3 * ls]);
+    __m256 r4 = _mm256_loadu_ps((const float *)&s[4 * ls]);
+    __m256 r5 = _mm256_loadu_ps((const float *)&s[5 * ls]);
+    __m256 r6 = _mm256_loadu_ps((const float *)&s[6 * ls]);
+    __m256 r7 = _mm256_loadu_ps((const float *)&s[7 * ls]);
+
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+    __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+
+    r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    r4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    r5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    r6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    r7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    _mm256_storeu_ps((float *)&d[0 * ld], _mm256_permute2f128_ps(r0, r4, 0x20));
+    _mm256_storeu_ps((float *)&d[1 * ld], _mm256_permute2f128_ps(r1, r5, 0x20));
+    _mm256_storeu_ps((float *)&d[2 * ld], _mm256_permute2f128_ps(r2, r6, 0x20));
+    _mm256_storeu_ps((float *)&d[3 * ld], _mm256_permute2f128_ps(r3, r7, 0x20));
+    _mm256_storeu_ps((float *)&d[4 * ld], _mm256_permute2f128_ps(r0, r4, 0x31));
+    _mm256_storeu_ps((float *)&d[5 * ld], _mm256_permute2f128_ps(r1, r5, 0x31));
+    _mm256_storeu_ps((float *)&d[6 * ld], _mm256_permute2f128_ps(r2, r6, 0x31));
+    _mm256_storeu_ps((float *)&d[7 * ld], _mm256_permute2f128_ps(r3, r7, 0x31));
+}
+
+#endif // TRASPOSTA_X86
+
+//----------------------------------------------------------------------
+// Foglie: blocchi fino a FOGLIA x FOGLIA, a quadrati 8 x 8 e bordi scalari.
+// Sono scritte una volta e inserite (always_inline) nelle funzioni di ogni
+// set di istruzioni, dove il quadrato diventa una chiamata diretta.
+//----------------------------------------------------------------------
+
+// d (colonne x righe) = s (righe x colonne) trasposta
+static inline __attribute__((always_inline)) void fogliaCopia(const Parola32 *s, size_t ls, Parola32 *d, size_t ld,
+                                                               size_t righe, size_t colonne, Quadrato8 quadrato) {
+    size_t righe8 = righe & ~(size_t)7;
+    size_t colonne8 = colonne & ~(size_t)7;
+    // Otto colonne della sorgente alla volta: le otto righe della destinazione
+    // vengono scritte di seguito, invece che 32 byte per riga ad ogni quadrato
+    for (size_t j = 0; j < colonne8; j += 8) {
+        for (size_t i = 0; i < righe8; i += 8) {
+            quadrato(&s[i * ls + j], ls, &d[j * ld + i], ld);
+        }
+    }
+    for (size_t j = colonne8; j < colonne; j++) {
+        for (size_t i = 0; i < righe8; i++) {
+            d[j * ld + i] = s[i * ls + j];
+        }
+    }
+    for (size_t i = righe8; i < righe; i++) {
+        for (size_t j = 0; j < colonne; j++) {
+            d[j * ld + i] = s[i * ls + j];
+        }
+    }
+}
+
+// Scambia p (righe x colonne) con q (colonne x righe) trasposta; p e q non si sovrappongono
+static inline __attribute__((always_inline)) void fogliaScambia(Parola32 *p, Parola32 *q, size_t l, size_t righe,
+                                                                 size_t colonne, Quadrato8 quadrato) {
+    Parola32 copia[8 * 8];
+    size_t righe8 = righe & ~(size_t)7;
+    size_t colonne8 = colonne & ~(size_t)7;
+    for (size_t i = 0; i < righe8; i += 8) {
+        for (size_t j = 0; j < colonne8; j += 8) {
+            Parola32 *a = &p[i * l + j];
+            Parola32 *b = &q[j * l + i];
+            quadrato(a, l, copia, 8);
+            quadrato(b, l, a, l);
+            for (int k = 0; k < 8; k++) {
+                memcpy(&b[k * l], &copia[k * 8], 8 * sizeof(Parola32));
+            }
+        }
+    }
+    for (size_t i = 0; i < righe; i++) {
+        for (size_t j = i < righe8 ? colonne8 : 0; j < colonne; j++) {
+            Parola32 x = p[i * l + j];
+            p[i * l + j] = q[j * l + i];
+            q[j * l + i] = x;
+        }
+    }
+}
+
+// Traspone sul posto il blocco quadrato n x n che inizia da a
+static inline __attribute__((always_inline)) void fogliaDiagonale(Parola32 *a, size_t l, size_t n,
+                                                                   Quadrato8 quadrato) {
+    Parola32 copia[8 * 8];
+    size_t n8 = n & ~(size_t)7;
+    for (size_t i = 0; i < n8; i += 8) {
+        // Quadrato sulla diagonale: trasposto nella copia e riscritto
+        Parola32 *d = &a[i * l + i];
+        quadrato(d, l, copia, 8);
+        for (int k = 0; k < 8; k++) {
+            memcpy(&d[k * l], &copia[k * 8], 8 * sizeof(Parola32));
+        }
+        for (size_t j = i + 8; j < n8; j += 8) {
+            Parola32 *x = &a[i * l + j];
+            Parola32 *y = &a[j * l + i];
+            quadrato(x, l, copia, 8);
+            quadrato(y, l, x, l);
+            for (int k = 0; k < 8; k++) {
+                memcpy(&y[k * l], &copia[k * 8], 8 * sizeof(Parola32));
+            }
+        }
+    }
+    // Coppie (i, j) con j > i e j nel bordo
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = i + 1 > n8 ? i + 1 : n8; j < n; j++) {
+            Parola32 x = a[i * l + j];
+            a[i * l + j] = a[j * l + i];
+            a[j * l + i] = x;
+        }
+    }
+}
+
+typedef struct {
+    void (*copia)(const Parola32 *s, size_t ls, Parola32 *d, size_t ld, size_t righe, size_t colonne);
+    void (*scambia)(Parola32 *p, Parola32 *q, size_t l, size_t righe, size_t colonne);
+    void (*diagonale)(Parola32 *a, size_t l, size_t n);
+} Foglie;
+
+#ifdef TRASPOSTA_X86
+
+static void copiaSse2(const Parola32 *s, size_t ls, Parola32 *d, size_t ld, size_t righe, size_t colonne) {
+    fogliaCopia(s, ls, d, ld, righe, colonne, quadrato8Sse2);
+}
+
+static void scambiaSse2(Parola32 *p, Parola32 *q, size_t l, size_t righe, size_t colonne) {
+    fogliaScambia(p, q, l, righe, colonne, quadrato8Sse2);
+}
+
+static void diagonaleSse2(Parola32 *a, size_t l, size_t n) {
+    fogliaDiagonale(a, l, n, quadrato8Sse2);
+}
+
+__attribute__((target("avx2"))) static void copiaAvx2(const Parola32 *s, size_t ls, Parola32 *d, size_t ld,
+                                                      size_t righe, size_t colonne) {
+    fogliaCopia(s, ls, d, ld, righe, colonne, quadrato8Avx2);
+}
+
+__attribute__((target("avx2"))) static void scambiaAvx2(Parola32 *p, Parola32 *q, size_t l, size_t righe,
+                                                        size_t colonne) {
+    fogliaScambia(p, q, l, righe, colonne, quadrato8Avx2);
+}
+
+__attribute__((target("avx2"))) static void diagonaleAvx2(Parola32 *a, size_t l, size_t n) {
+    fogliaDiagonale(a, l, n, quadrato8Avx2);
+}
+
+static const Foglie FOGLIE_SSE2 = {copiaSse2, scambiaSse2, diagonaleSse2};
+static const Foglie FOGLIE_AVX2 = {copiaAvx2, scambiaAvx2, diagonaleAvx2};
+
+#else
+
+static void copiaScalare(const Parola32 *s, size_t ls, Parola32 *d, size_t ld, size_t righe, size_t colonne) {
+    fogliaCopia(s, ls, d, ld, righe, colonne, quadrato8Scalare);
+}
+
+static void scambiaScalare(Parola32 *p, Parola32 *q, size_t l, size_t righe, size_t colonne) {
+    fogliaScambia(p, q, l, righe, colonne, quadrato8Scalare);
+}
+
+static void diagonaleScalare(Parola32 *a, size_t l, size_t n) {
+    fogliaDiagonale(a, l, n, quadrato8Scalare);
+}
+
+static const Foglie FOGLIE_SCALARI = {copiaScalare, scambiaScalare, diagonaleScalare};
+
+#endif // TRASPOSTA_X86
+
+static const Foglie *foglieMigliori(void) {
+#ifdef TRASPOSTA_X86
+    return __builtin_cpu_supports("avx2") ? &FOGLIE_AVX2 : &FOGLIE_SSE2;
+#else
+    return &FOGLIE_SCALARI;
+#endif
+}
+
+//----------------------------------------------------------------------
+// Divisione ricorsiva
+//----------------------------------------------------------------------
+
+static void copiaRicorsiva(const Foglie *f, const Parola32 *s, size_t ls, Parola32 *d, size_t ld, size_t righe,
+                           size_t colonne) {
+    if (righe <= FOGLIA && colonne <= FOGLIA) {
+        f->copia(s, ls, d, ld, righe, colonne);
+    } else if (righe >= colonne) {
+        // Righe in alto e in basso della sorgente = colonne a sinistra e a destra della destinazione
+        size_t meta = meta8(righe);
+        copiaRicorsiva(f, s, ls, d, ld, meta, colonne);
+        copiaRicorsiva(f, s + meta * ls, ls, d + meta, ld, righe - meta, colonne);
+    } else {
+        size_t meta = meta8(colonne);
+        copiaRicorsiva(f, s, ls, d, ld, righe, meta);
+        copiaRicorsiva(f, s + meta, ls, d + meta * ld, ld, righe, colonne - meta);
+    }
+}
+
+static void scambiaRicorsiva(const Foglie *f, Parola32 *p, Parola32 *q, size_t l, size_t righe, size_t colonne) {
+    if (righe <= FOGLIA && colonne <= FOGLIA) {
+        f->scambia(p, q, l, righe, colonne);
+    } else if (righe >= colonne) {
+        size_t meta = meta8(righe);
+        scambiaRicorsiva(f, p, q, l, meta, colonne);
+        scambiaRicorsiva(f, p + meta * l, q + meta, l, righe - meta, colonne);
+    } else {
+        size_t meta = meta8(colonne);
+        scambiaRicorsiva(f, p, q, l, righe, meta);
+        scambiaRicorsiva(f, p + meta, q + meta * l, l, righe, colonne - meta);
+    }
+}
+
+static void diagonaleRicorsiva(const Foglie *f, Parola32 *a, size_t l, size_t n) {
+    if (n <= FOGLIA) {
+        f->diagonale(a, l, n);
+        return;
+    }
+    // I due blocchi sulla diagonale si traspongono sul posto, quelli fuori si scambiano
+    size_t meta = meta8(n);
+    diagonaleRicorsiva(f, a, l, meta);
+    diagonaleRicorsiva(f, a + meta * l + meta, l, n - meta);
+    scambiaRicorsiva(f, a + meta, a + meta * l, l, meta, n - meta);
+}
+
+//----------------------------------------------------------------------
+// Riquadri tra i thread
+//----------------------------------------------------------------------
+
+typedef struct {
+    const Foglie *foglie;
+    const Parola32 *sorgente;   // NULL per la trasposta sul posto
+    Parola32 *destinazione;
+    size_t righe;
+    size_t colonne;
+    size_t ls;                  // distanza tra le righe della sorgente
+    size_t ld;                  // distanza tra le righe della destinazione
+    size_t riquadriRiga;        // riquadri in una riga della griglia
+    size_t riquadri;
+    size_t prossimo;            // primo riquadro non ancora preso (atomico)
+} LavoroTrasposta;
+
+// Riquadro k della trasposta sul posto: le coppie (i, j) con i <= j della griglia, per righe
+static void coppiaRiquadro(size_t k, size_t lato, size_t *i, size_t *j) {
+    size_t riga = 0;
+    while (k >= lato - riga) {
+        k -= lato - riga;
+        riga++;
+    }
+    *i = riga;
+    *j = riga + k;
+}
+
+static void eseguiRiquadro(const LavoroTrasposta *lavoro, size_t k) {
+    const Foglie *f = lavoro->foglie;
+    if (lavoro->sorgente != NULL) {
+        size_t r = k / lavoro->riquadriRiga * RIQUADRO;
+        size_t c = k % lavoro->riquadriRiga * RIQUADRO;
+        size_t righe = lavoro->righe - r < RIQUADRO ? lavoro->righe - r : RIQUADRO;
+        size_t colonne = lavoro->colonne - c < RIQUADRO ? lavoro->colonne - c : RIQUADRO;
+        copiaRicorsiva(f, lavoro->sorgente + r * lavoro->ls + c, lavoro->ls, lavoro->destinazione + c * lavoro->ld + r,
+                       lavoro->ld, righe, colonne);
+        return;
+    }
+    size_t n = lavoro->righe;
+    size_t i, j;
+    coppiaRiquadro(k, lavoro->riquadriRiga, &i, &j);
+    size_t r = i * RIQUADRO;
+    size_t c = j * RIQUADRO;
+    size_t righe = n - r < RIQUADRO ? n - r : RIQUADRO;
+    size_t colonne = n - c < RIQUADRO ? n - c : RIQUADRO;
+    if (i == j) {
+        diagonaleRicorsiva(f, lavoro->destinazione + r * n + r, n, righe);
+    } else {
+        scambiaRicorsiva(f, lavoro->destinazione + r * n + c, lavoro->destinazione + c * n + r, n, righe, colonne);
+    }
+}
+
+static void *lavoratore(void *argomento) {
+    LavoroTrasposta *lavoro = argomento;
+    size_t k;
+    while ((k = __atomic_fetch_add(&lavoro->prossimo, 1, __ATOMIC_RELAXED)) < lavoro->riquadri) {
+        eseguiRiquadro(lavoro, k);
+    }
+    return NULL;
+}
+
+static void dividiTraThread(LavoroTrasposta *lavoro, unsigned thread) {
+    if (thread == 0) {
+        long processori = sysconf(_SC_NPROCESSORS_ONLN);
+        thread = processori > 0 ? (unsigned)processori : 1;
+    }
+    if (thread > lavoro->riquadri) {
+        thread = (unsigned)lavoro->riquadri;
+    }
+    if (thread > MASSIMO_THREAD) {
+        thread = MASSIMO_THREAD;
+    }
+    pthread_t id[MASSIMO_THREAD];
+    unsigned avviati = 0;
+    for (unsigned t = 1; t < thread; t++) {
+        if (pthread_create(&id[avviati], NULL, lavoratore, lavoro) == 0) {
+            avviati++;
+        }
+    }
+    // Il thread chiamante lavora come gli altri (e da solo se non se ne sono potuti creare)
+    lavoratore(lavoro);
+    for (unsigned t = 0; t < avviati; t++) {
+        pthread_join(id[t], NULL);
+    }
+}
+
+static void trasposta(const Parola32 *sorgente, Parola32 *destinazione, size_t righe, size_t colonne,
+                      unsigned thread) {
+    const Foglie *f = foglieMigliori();
+    size_t ls = colonne;
+    size_t ld = righe;
+    // I quadrati 8 x 8 scrivono 32 byte per riga della destinazione: se non sono
+    // allineati a 32 byte meta' delle scritture sono a cavallo di due righe di
+    // cache, e fuori dalla cache la trasposta diventa piu' lenta di quella a due
+    // cicli. Le prime righe della sorgente si copiano a parte, cosi' i quadrati
+    // partono da un indirizzo allineato (tutte le righe lo sono se righe e'
+    // multiplo di 8). Nella cache L1 (non piu' elementi di una foglia) non serve.
+    size_t prime = (-(uintptr_t)destinazione / sizeof(Parola32)) & 7;
+    if (prime > righe || righe * colonne <= FOGLIA * FOGLIA) {
+        prime = 0;
+    }
+    if (prime > 0) {
+        copiaRicorsiva(f, sorgente, ls, destinazione, ld, prime, colonne);
+        sorgente += prime * ls;
+        destinazione += prime;
+        righe -= prime;
+    }
+
+    if (thread == 1 || (righe <= RIQUADRO && colonne <= RIQUADRO)) {
+        copiaRicorsiva(f, sorgente, ls, destinazione, ld, righe, colonne);
+        return;
+    }
+    LavoroTrasposta lavoro = {f, sorgente, destinazione, righe, colonne, ls, ld, (colonne + RIQUADRO - 1) / RIQUADRO,
+                              0, 0};
+    lavoro.riquadri = (righe + RIQUADRO - 1) / RIQUADRO * lavoro.riquadriRiga;
+    dividiTraThread(&lavoro, thread);
+}
+
+static void traspostaQuadrata(Parola32 *matrice, size_t n, unsigned thread) {
+    const Foglie *f = foglieMigliori();
+    if (thread == 1 || n <= RIQUADRO) {
+        diagonaleRicorsiva(f, matrice, n, n);
+        return;
+    }
+    size_t lato = (n + RIQUADRO - 1) / RIQUADRO;
+    LavoroTrasposta lavoro = {f, NULL, matrice, n, n, n, n, lato, lato * (lato + 1) / 2, 0};
+    dividiTraThread(&lavoro, thread);
+}
+
+void traspostaInt(const int sorgente[], int destinazione[], size_t righe, size_t colonne, unsigned thread) {
+    trasposta((const Parola32 *)sorgente, (Parola32 *)destinazione, righe, colonne, thread);
+}
+
+void traspostaFloat(const float sorgente[], float destinazione[], size_t righe, size_t colonne, unsigned thread) {
+    trasposta((const Parola32 *)sorgente, (Parola32 *)destinazione, righe, colonne, thread);
+}
+
+void traspostaQuadrataInt(int matrice[], size_t n, unsigned thread) {
+    traspostaQuadrata((Parola32 *)matrice, n, thread);
+}
+
+void traspostaQuadrataFloat(float matrice[], size_t n, unsigned thread) {
+    traspostaQuadrata((Parola32 *)matrice, n, thread);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file trasposta.h
+ * @brief Trasposta di matrici di int e float: copia R x C e sul posto per matrici quadrate
+ *
+ * In es_matrici.c caricaCol, stampaCol e ricercaCol scorrono una colonna: in
+ * memoria gli elementi sono a distanza di C interi l'uno dall'altro, quindi
+ * ogni elemento costa una riga di cache intera. Quando un passaggio lavora
+ * per colonne conviene trasporre prima la matrice e poi scorrere le righe.
+ *
+ * La trasposta scritta con due cicli legge la sorgente per righe ma scrive la
+ * destinazione per colonne: oltre qualche centinaio di colonne ogni scrittura
+ * e' un cache miss e un TLB miss. Qui la matrice viene divisa a meta'
+ * (lungo la dimensione piu' grande) ricorsivamente finche' i due blocchi,
+ * sorgente e destinazione, stanno nella cache L1: non serve conoscere la
+ * dimensione delle cache (algoritmo cache-oblivious). Ogni blocco viene
+ * trasposto a quadrati di 8 x 8 elementi caricati in registri SIMD (AVX2
+ * scelto a runtime, SSE2, o scalare sugli altri processori).
+ *
+ * Le matrici grandi vengono divise in riquadri da 512 x 512 che i thread si
+ * prendono uno alla volta. Sulle matrici piu' grandi della cache il limite e'
+ * la memoria: bench_trasposta confronta i GB/s con quelli di memcpy della
+ * stessa matrice.
+ *
+ * Misure con un thread (Xeon con AVX2, GB/s letti + scritti): con lati potenza
+ * di 2, dove i due cicli hanno conflitti nella cache, da 4 a 10 volte la
+ * trasposta a due cicli (1024 x 1024: da 3 a 7,5 contro 0,7); con lati
+ * qualsiasi il vantaggio e' minore e cambia molto da un'esecuzione all'altra:
+ * 1000 x 1000 da 2,2 a 9 contro 1,3-2,5, 100000 x 100 da 3,4 a 4,2 contro
+ * 2,5-2,8, 3001 x 5003 circa 2 contro 0,9. Le matrici che stanno nella cache
+ * L1 vanno da 2 a 3,5 volte la trasposta a due cicli, tranne quelle con meno
+ * di 8 righe (7 x 13: 7,5 contro 10), dove non ci sono quadrati 8 x 8 e resta
+ * solo il costo della chiamata.
+ *
+ * Le matrici sono memorizzate per righe in un vettore unico, come in
+ * example4_flattened_array.c: elemento (i, j) = matrice[i * colonne + j].
+ * Una matrice int m[R][C] si passa come &m[0][0].
+ */
+#ifndef TRASPOSTA_H
+#define TRASPOSTA_H
+
+#include <stddef.h>
+
+/**
+ * destinazione = sorgente trasposta: destinazione[j * righe + i] = sorgente[i * colonne + j].
+ * Sorgente e destinazione non devono sovrapporsi.
+ * @param sorgente la matrice righe x colonne
+ * @param destinazione la matrice colonne x righe
+ * @param righe le righe della sorgente
+ * @param colonne le colonne della sorgente
+ * @param thread quanti thread usare (0 = tutti i processori)
+ */
+void traspostaInt(const int sorgente[], int destinazione[], size_t righe, size_t colonne, unsigned thread);
+
+/**
+ * Come traspostaInt, per matrici di float.
+ */
+void traspostaFloat(const float sorgente[], float destinazione[], size_t righe, size_t colonne, unsigned thread);
+
+/**
+ * Traspone sul posto una matrice quadrata n x n (scambia (i, j) con (j, i)).
+ * @param matrice la matrice
+ * @param n il numero di righe e di colonne
+ * @param thread quanti thread usare (0 = tutti i processori)
+ */
+void traspostaQuadrataInt(int matrice[], size_t n, unsigned thread);
+
+/**
+ * Come traspostaQuadrataInt, per matrici di float.
+ */
+void traspostaQuadrataFloat(float matrice[], size_t n, unsigned thread);
+
+#endif // TRASPOSTA_H
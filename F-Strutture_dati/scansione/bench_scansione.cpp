@@ -0,0 +1,157 @@
+/**
+ * @file bench_scansione.cpp
+ * @brief Verifica e velocita' della scansione rispetto al ciclo di es_vet_02.c
+ *
+ * Confronta tutti i modi (inclusiva, esclusiva, in avanti, all'indietro) con
+ * un ciclo semplice, per molte lunghezze e numeri di thread, poi misura la
+ * velocita' su un vettore grande in GB/s (byte letti + scritti).
+ *
+ * Compilazione:
+ *   g++ -O2 -std=c++17 -pthread bench_scansione.cpp scansione.cpp -o bench_scansione
+ * Utilizzo:
+ *   ./bench_scansione [milioni di elementi] [thread]
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "scansione.h"
+
+static double secondi() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Il ciclo di es_vet_02.c generalizzato: t[i] = t[i + 1] + i con t[n - 1] = 0
+static void cicloEsVet02(int32_t t[], int n) {
+    t[n - 1] = 0;
+    for (int i = n - 2; i >= 0; i--) {
+        t[i] = t[i + 1] + i;
+    }
+}
+
+// Tipo delle somme di riferimento: senza segno per gli interi (girano senza
+// comportamento indefinito), double per i float
+template <typename T> struct SommaDi { typedef double Tipo; };
+template <> struct SommaDi<int32_t> { typedef uint32_t Tipo; };
+template <> struct SommaDi<int64_t> { typedef uint64_t Tipo; };
+
+// Scansione di riferimento, un elemento alla volta
+template <typename T>
+static void scansioneSemplice(const T in[], T out[], size_t n, int modo) {
+    typedef typename SommaDi<T>::Tipo Somma;
+    Somma s = 0;
+    for (size_t k = 0; k < n; k++) {
+        size_t i = (modo & SCANSIONE_INDIETRO) ? n - 1 - k : k;
+        if (modo & SCANSIONE_ESCLUSIVA) {
+            out[i] = (T)s;
+            s += (Somma)in[i];
+        } else {
+            s += (Somma)in[i];
+            out[i] = (T)s;
+        }
+    }
+}
+
+template <typename T>
+static bool vicini(T a, T b, double scala) {
+    if (std::is_integral<T>::value) {
+        return a == b;
+    }
+    return fabs((double)a - (double)b) <= 1e-5 * scala;
+}
+
+template <typename T>
+static int verifica(const char *nome) {
+    int errori = 0;
+    const size_t LUNGHEZZE[] = {0, 1, 3, 7, 8, 9, 31, 64, 1000, 65535, 200001, 1 << 20};
+    srand(1);
+    for (size_t n : LUNGHEZZE) {
+        std::vector<T> in(n);
+        double scala = 1;
+        for (size_t i = 0; i < n; i++) {
+            in[i] = std::is_integral<T>::value ? (T)(rand() - RAND_MAX / 2) : (T)(rand() % 2001 - 1000) / 8;
+            scala += fabs((double)in[i]);
+        }
+        for (int modo = 0; modo < 4; modo++) {
+            std::vector<T> atteso(n);
+            scansioneSemplice(in.data(), atteso.data(), n, modo);
+            for (unsigned thread : {1u, 2u, 3u, 8u}) {
+                std::vector<T> out(n);
+                scansione(in.data(), out.data(), n, modo, thread);
+                // Anche sul posto
+                std::vector<T> stesso = in;
+                scansione(stesso.data(), stesso.data(), n, modo, thread);
+                for (size_t i = 0; i < n; i++) {
+                    if (!vicini(out[i], atteso[i], scala) || !vicini(stesso[i], atteso[i], scala)) {
+                        printf("ERRORE %s n=%zu modo=%d thread=%u elemento %zu\n", nome, n, modo, thread, i);
+                        errori++;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return errori;
+}
+
+template <typename T>
+static void velocita(const char *nome, size_t n, unsigned thread) {
+    std::vector<T> in(n, (T)1);
+    std::vector<T> out(n, (T)0);
+    double gb = 2.0 * n * sizeof(T) / 1e9;
+    for (int modo : {(int)SCANSIONE_INCLUSIVA, SCANSIONE_ESCLUSIVA | SCANSIONE_INDIETRO}) {
+        double migliore[3] = {1e9, 1e9, 1e9};
+        for (int r = 0; r < 5; r++) {
+            double t0 = secondi();
+            scansioneSemplice(in.data(), out.data(), n, modo);
+            double t1 = secondi();
+            scansione(in.data(), out.data(), n, modo, 1);
+            double t2 = secondi();
+            scansione(in.data(), out.data(), n, modo, thread);
+            double t3 = secondi();
+            migliore[0] = std::min(migliore[0], t1 - t0);
+            migliore[1] = std::min(migliore[1], t2 - t1);
+            migliore[2] = std::min(migliore[2], t3 - t2);
+        }
+        printf("%-8s %-22s %10.2f %10.2f %10.2f\n", nome,
+               modo == SCANSIONE_INCLUSIVA ? "inclusiva avanti" : "esclusiva indietro", gb / migliore[0],
+               gb / migliore[1], gb / migliore[2]);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = (size_t)((argc > 1 ? atof(argv[1]) : 16) * 1e6);
+    unsigned thread = argc > 2 ? atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+
+    // Il ciclo dell'esercizio e' una scansione all'indietro di (0, 1, ..., n - 2, 0) spostata di un elemento
+    int32_t t[5];
+    cicloEsVet02(t, 5);
+    int32_t valori[5] = {0, 1, 2, 3, 0};
+    int32_t s[5];
+    scansione(valori, s, 5, SCANSIONE_INCLUSIVA | SCANSIONE_INDIETRO);
+    int errori = 0;
+    for (int i = 0; i < 5; i++) {
+        printf("t[%d]=%d (scansione %d); ", i, t[i], s[i]);
+        errori += t[i] != s[i];
+    }
+    printf("\n");
+
+    errori += verifica<int32_t>("int32");
+    errori += verifica<int64_t>("int64");
+    errori += verifica<float>("float");
+    printf("verifica: %d errori\n\n", errori);
+
+    printf("%zu elementi, GB/s (letti + scritti)\n", n);
+    printf("%-8s %-22s %10s %10s %10s\n", "tipo", "modo", "semplice", "SIMD", "SIMD+thr");
+    velocita<int32_t>("int32", n, thread);
+    velocita<int64_t>("int64", n, thread);
+    velocita<float>("float", n, thread);
+    return errori != 0;
+}
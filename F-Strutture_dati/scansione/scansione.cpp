@@ -0,0 +1,432 @@
+/**
+ * @file scansione.cpp
+ * @brief Scansione a blocchi SIMD (SSE2, AVX2 scelto a runtime) e divisione tra i thread
+ *
+ * Il ciclo della scansione e' scritto una volta (scansioneBlocco) per una
+ * "descrizione" del registro SIMD: tipo degli elementi, quanti ne contiene e
+ * le poche operazioni che servono (somma, scansione nel registro, spostamento
+ * di un elemento, copia del primo o dell'ultimo elemento in tutti).
+ */
+#include "scansione.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// SSE2 c'e' su tutti i processori x86 a 64 bit; AVX2 viene scelto a runtime
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define SCANSIONE_X86 1
+#endif
+
+// Sotto questa dimensione per thread non conviene dividere il lavoro
+const size_t MINIMO_PER_THREAD = 1 << 16;
+
+//----------------------------------------------------------------------
+// Descrizioni dei registri
+//----------------------------------------------------------------------
+
+// Somma scalare: gli interi girano senza comportamento indefinito
+static inline int32_t sommaScalare(int32_t a, int32_t b) { return (int32_t)((uint32_t)a + (uint32_t)b); }
+static inline int64_t sommaScalare(int64_t a, int64_t b) { return (int64_t)((uint64_t)a + (uint64_t)b); }
+static inline float sommaScalare(float a, float b) { return a + b; }
+
+// Nessun SIMD: un elemento per registro
+template <typename Tipo>
+struct Scalare {
+    typedef Tipo T;
+    typedef Tipo V;
+    static const size_t L = 1;
+    static V carica(const T *p) { return *p; }
+    static void scrivi(T *p, V x) { *p = x; }
+    static V uguali(T v) { return v; }
+    static V somma(V a, V b) { return sommaScalare(a, b); }
+    static V prefisso(V x) { return x; }
+    static V suffisso(V x) { return x; }
+    static V avanti(V) { return 0; }
+    static V indietro(V) { return 0; }
+    static V ultimo(V x) { return x; }
+    static V primo(V x) { return x; }
+    static T elemento0(V x) { return x; }
+};
+
+#ifdef SCANSIONE_X86
+
+struct Int32Sse2 {
+    typedef int32_t T;
+    typedef __m128i V;
+    static const size_t L = 4;
+    static V carica(const T *p) { return _mm_loadu_si128((const __m128i *)p); }
+    static void scrivi(T *p, V x) { _mm_storeu_si128((__m128i *)p, x); }
+    static V uguali(T v) { return _mm_set1_epi32(v); }
+    static V somma(V a, V b) { return _mm_add_epi32(a, b); }
+    static V prefisso(V x) {
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        return _mm_add_epi32(x, _mm_slli_si128(x, 8));
+    }
+    static V suffisso(V x) {
+        x = _mm_add_epi32(x, _mm_srli_si128(x, 4));
+        return _mm_add_epi32(x, _mm_srli_si128(x, 8));
+    }
+    // Sposta gli elementi di una posizione verso la fine (avanti) o verso l'inizio, entra 0
+    static V avanti(V x) { return _mm_slli_si128(x, 4); }
+    static V indietro(V x) { return _mm_srli_si128(x, 4); }
+    static V ultimo(V x) { return _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3)); }
+    static V primo(V x) { return _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 0, 0, 0)); }
+    static T elemento0(V x) { return _mm_cvtsi128_si32(x); }
+};
+
+struct Int64Sse2 {
+    typedef int64_t T;
+    typedef __m128i V;
+    static const size_t L = 2;
+    static V carica(const T *p) { return _mm_loadu_si128((const __m128i *)p); }
+    static void scrivi(T *p, V x) { _mm_storeu_si128((__m128i *)p, x); }
+    static V uguali(T v) { return _mm_set1_epi64x(v); }
+    static V somma(V a, V b) { return _mm_add_epi64(a, b); }
+    static V prefisso(V x) { return _mm_add_epi64(x, _mm_slli_si128(x, 8)); }
+    static V suffisso(V x) { return _mm_add_epi64(x, _mm_srli_si128(x, 8)); }
+    static V avanti(V x) { return _mm_slli_si128(x, 8); }
+    static V indietro(V x) { return _mm_srli_si128(x, 8); }
+    static V ultimo(V x) { return _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 2, 3, 2)); }
+    static V primo(V x) { return _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 1, 0)); }
+    static T elemento0(V x) { return _mm_cvtsi128_si64(x); }
+};
+
+struct FloatSse2 {
+    typedef float T;
+    typedef __m128 V;
+    static const size_t L = 4;
+    static V carica(const T *p) { return _mm_loadu_ps(p); }
+    static void scrivi(T *p, V x) { _mm_storeu_ps(p, x); }
+    static V uguali(T v) { return _mm_set1_ps(v); }
+    static V somma(V a, V b) { return _mm_add_ps(a, b); }
+    static V prefisso(V x) {
+        x = _mm_add_ps(x, avanti(x));
+        return _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)));
+    }
+    static V suffisso(V x) {
+        x = _mm_add_ps(x, indietro(x));
+        return _mm_add_ps(x, _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(x), 8)));
+    }
+    static V avanti(V x) { return _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)); }
+    static V indietro(V x) { return _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(x), 4)); }
+    static V ultimo(V x) { return _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3)); }
+    static V primo(V x) { return _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 0, 0, 0)); }
+    static T elemento0(V x) { return _mm_cvtss_f32(x); }
+};
+
+// AVX2: le istruzioni di spostamento lavorano su ognuna delle due meta' da 128 bit,
+// il passaggio dalla meta' bassa a quella alta si fa a parte
+
+#define AVX2 __attribute__((target("avx2")))
+
+// I registri a 256 bit passano solo tra funzioni compilate per AVX2 (inserite con flatten):
+// l'avviso sul cambio di convenzione di chiamata non riguarda questo file
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+struct Int32Avx2 {
+    typedef int32_t T;
+    typedef __m256i V;
+    static const size_t L = 8;
+    AVX2 static V carica(const T *p) { return _mm256_loadu_si256((const __m256i *)p); }
+    AVX2 static void scrivi(T *p, V x) { _mm256_storeu_si256((__m256i *)p, x); }
+    AVX2 static V uguali(T v) { return _mm256_set1_epi32(v); }
+    AVX2 static V somma(V a, V b) { return _mm256_add_epi32(a, b); }
+    AVX2 static V prefisso(V x) {
+        x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+        x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+        // Ultimo elemento della meta' bassa sommato a tutta la meta' alta
+        __m256i basso = _mm256_permute2x128_si256(x, x, 0x08);   // [0, meta' bassa]
+        return _mm256_add_epi32(x, _mm256_shuffle_epi32(basso, _MM_SHUFFLE(3, 3, 3, 3)));
+    }
+    AVX2 static V suffisso(V x) {
+        x = _mm256_add_epi32(x, _mm256_srli_si256(x, 4));
+        x = _mm256_add_epi32(x, _mm256_srli_si256(x, 8));
+        __m256i alto = _mm256_permute2x128_si256(x, x, 0x81);    // [meta' alta, 0]
+        return _mm256_add_epi32(x, _mm256_shuffle_epi32(alto, _MM_SHUFFLE(0, 0, 0, 0)));
+    }
+    AVX2 static V avanti(V x) {
+        __m256i p = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6));
+        return _mm256_blend_epi32(p, _mm256_setzero_si256(), 0x01);
+    }
+    AVX2 static V indietro(V x) {
+        __m256i p = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 7));
+        return _mm256_blend_epi32(p, _mm256_setzero_si256(), 0x80);
+    }
+    AVX2 static V ultimo(V x) { return _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7)); }
+    AVX2 static V primo(V x) { return _mm256_broadcastd_epi32(_mm256_castsi256_si128(x)); }
+    AVX2 static T elemento0(V x) { return _mm_cvtsi128_si32(_mm256_castsi256_si128(x)); }
+};
+
+struct Int64Avx2 {
+    typedef int64_t T;
+    typedef __m256i V;
+    static const size_t L = 4;
+    AVX2 static V carica(const T *p) { return _mm256_loadu_si256((const __m256i *)p); }
+    AVX2 static void scrivi(T *p, V x) { _mm256_storeu_si256((__m256i *)p, x); }
+    AVX2 static V uguali(T v) { return _mm256_set1_epi64x(v); }
+    AVX2 static V somma(V a, V b) { return _mm256_add_epi64(a, b); }
+    AVX2 static V prefisso(V x) {
+        x = _mm256_add_epi64(x, _mm256_slli_si256(x, 8));
+        __m256i basso = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 1, 1, 1));
+        return _mm256_add_epi64(x, _mm256_blend_epi32(basso, _mm256_setzero_si256(), 0x0F));
+    }
+    AVX2 static V suffisso(V x) {
+        x = _mm256_add_epi64(x, _mm256_srli_si256(x, 8));
+        __m256i alto = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 2, 2, 2));
+        return _mm256_add_epi64(x, _mm256_blend_epi32(alto, _mm256_setzero_si256(), 0xF0));
+    }
+    AVX2 static V avanti(V x) {
+        __m256i p = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0));
+        return _mm256_blend_epi32(p, _mm256_setzero_si256(), 0x03);
+    }
+    AVX2 static V indietro(V x) {
+        __m256i p = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 2, 1));
+        return _mm256_blend_epi32(p, _mm256_setzero_si256(), 0xC0);
+    }
+    AVX2 static V ultimo(V x) { return _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3)); }
+    AVX2 static V primo(V x) { return _mm256_permute4x64_epi64(x, _MM_SHUFFLE(0, 0, 0, 0)); }
+    AVX2 static T elemento0(V x) { return _mm_cvtsi128_si64(_mm256_castsi256_si128(x)); }
+};
+
+struct FloatAvx2 {
+    typedef float T;
+    typedef __m256 V;
+    static const size_t L = 8;
+    AVX2 static V carica(const T *p) { return _mm256_loadu_ps(p); }
+    AVX2 static void scrivi(T *p, V x) { _mm256_storeu_ps(p, x); }
+    AVX2 static V uguali(T v) { return _mm256_set1_ps(v); }
+    AVX2 static V somma(V a, V b) { return _mm256_add_ps(a, b); }
+    AVX2 static V prefisso(V x) {
+        x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+        x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+        __m256 basso = _mm256_permute2f128_ps(x, x, 0x08);
+        return _mm256_add_ps(x, _mm256_shuffle_ps(basso, basso, _MM_SHUFFLE(3, 3, 3, 3)));
+    }
+    AVX2 static V suffisso(V x) {
+        x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_srli_si256(_mm256_castps_si256(x), 4)));
+        x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_srli_si256(_mm256_castps_si256(x), 8)));
+        __m256 alto = _mm256_permute2f128_ps(x, x, 0x81);
+        return _mm256_add_ps(x, _mm256_shuffle_ps(alto, alto, _MM_SHUFFLE(0, 0, 0, 0)));
+    }
+    AVX2 static V avanti(V x) { return _mm256_castsi256_ps(Int32Avx2::avanti(_mm256_castps_si256(x))); }
+    AVX2 static V indietro(V x) { return _mm256_castsi256_ps(Int32Avx2::indietro(_mm256_castps_si256(x))); }
+    AVX2 static V ultimo(V x) { return _mm256_permutevar8x32_ps(x, _mm256_set1_epi32(7)); }
+    AVX2 static V primo(V x) { return _mm256_broadcastss_ps(_mm256_castps256_ps128(x)); }
+    AVX2 static T elemento0(V x) { return _mm256_cvtss_f32(x); }
+};
+
+#endif // SCANSIONE_X86
+
+//----------------------------------------------------------------------
+// Scansione e somma di una parte del vettore
+//----------------------------------------------------------------------
+
+/**
+ * Scansione di n elementi partendo dal riporto delle parti precedenti.
+ * @return il riporto per la parte successiva (riporto + somma degli elementi)
+ */
+template <class S>
+static typename S::T scansioneBlocco(const typename S::T *ingresso, typename S::T *uscita, size_t n, int modo,
+                                     typename S::T riporto) {
+    typedef typename S::T T;
+    typedef typename S::V V;
+    bool esclusiva = (modo & SCANSIONE_ESCLUSIVA) != 0;
+    V c = S::uguali(riporto);
+    if (!(modo & SCANSIONE_INDIETRO)) {
+        size_t i = 0;
+        for (; i + S::L <= n; i += S::L) {
+            V p = S::prefisso(S::carica(ingresso + i));
+            S::scrivi(uscita + i, S::somma(c, esclusiva ? S::avanti(p) : p));
+            c = S::somma(c, S::ultimo(p));
+        }
+        T r = S::elemento0(c);
+        for (; i < n; i++) {
+            T x = ingresso[i];
+            T s = sommaScalare(r, x);
+            uscita[i] = esclusiva ? r : s;
+            r = s;
+        }
+        return r;
+    }
+    size_t i = n;
+    for (; i >= S::L; i -= S::L) {
+        V s = S::suffisso(S::carica(ingresso + i - S::L));
+        S::scrivi(uscita + i - S::L, S::somma(c, esclusiva ? S::indietro(s) : s));
+        c = S::somma(c, S::primo(s));
+    }
+    T r = S::elemento0(c);
+    while (i > 0) {
+        i--;
+        T x = ingresso[i];
+        T s = sommaScalare(r, x);
+        uscita[i] = esclusiva ? r : s;
+        r = s;
+    }
+    return r;
+}
+
+/**
+ * @return la somma di n elementi
+ */
+template <class S>
+static typename S::T sommaBlocco(const typename S::T *ingresso, size_t n) {
+    typedef typename S::T T;
+    typedef typename S::V V;
+    V a = S::uguali(0);
+    size_t i = 0;
+    for (; i + S::L <= n; i += S::L) {
+        a = S::somma(a, S::carica(ingresso + i));
+    }
+    // Somma degli elementi del registro: l'ultimo della scansione
+    T r = S::elemento0(S::ultimo(S::prefisso(a)));
+    for (; i < n; i++) {
+        r = sommaScalare(r, ingresso[i]);
+    }
+    return r;
+}
+
+template <typename T>
+struct FunzioniScansione {
+    T (*scansione)(const T *, T *, size_t, int, T);
+    T (*somma)(const T *, size_t);
+};
+
+#ifdef SCANSIONE_X86
+
+// Con flatten le funzioni delle descrizioni AVX2 vengono inserite nel ciclo,
+// compilato per AVX2
+#define ISTANZE_AVX2(S)                                                                                  \
+    __attribute__((target("avx2"), flatten)) static S::T scansione##S(const S::T *ingresso, S::T *uscita, \
+                                                                        size_t n, int modo, S::T riporto) { \
+        return scansioneBlocco<S>(ingresso, uscita, n, modo, riporto);                                   \
+    }                                                                                                    \
+    __attribute__((target("avx2"), flatten)) static S::T somma##S(const S::T *ingresso, size_t n) {       \
+        return sommaBlocco<S>(ingresso, n);                                                              \
+    }
+
+ISTANZE_AVX2(Int32Avx2)
+ISTANZE_AVX2(Int64Avx2)
+ISTANZE_AVX2(FloatAvx2)
+
+template <class Sse2, class Avx2>
+static FunzioniScansione<typename Sse2::T> scegli(FunzioniScansione<typename Sse2::T> avx2) {
+    if (__builtin_cpu_supports("avx2")) {
+        return avx2;
+    }
+    return FunzioniScansione<typename Sse2::T>{scansioneBlocco<Sse2>, sommaBlocco<Sse2>};
+}
+
+static FunzioniScansione<int32_t> funzioni(int32_t) {
+    static const FunzioniScansione<int32_t> f =
+        scegli<Int32Sse2, Int32Avx2>({scansioneInt32Avx2, sommaInt32Avx2});
+    return f;
+}
+
+static FunzioniScansione<int64_t> funzioni(int64_t) {
+    static const FunzioniScansione<int64_t> f =
+        scegli<Int64Sse2, Int64Avx2>({scansioneInt64Avx2, sommaInt64Avx2});
+    return f;
+}
+
+static FunzioniScansione<float> funzioni(float) {
+    static const FunzioniScansione<float> f = scegli<FloatSse2, FloatAvx2>({scansioneFloatAvx2, sommaFloatAvx2});
+    return f;
+}
+
+#else
+
+template <typename T>
+static FunzioniScansione<T> funzioni(T) {
+    return FunzioniScansione<T>{scansioneBlocco<Scalare<T>>, sommaBlocco<Scalare<T>>};
+}
+
+#endif // SCANSIONE_X86
+
+//----------------------------------------------------------------------
+// Divisione tra i thread
+//----------------------------------------------------------------------
+
+template <typename T>
+static T scansioneParallela(const T *ingresso, T *uscita, size_t n, int modo, unsigned thread) {
+    FunzioniScansione<T> f = funzioni(T());
+    if (thread == 0) {
+        thread = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t parti = std::min<size_t>(thread, n / MINIMO_PER_THREAD);
+    if (parti <= 1) {
+        return f.scansione(ingresso, uscita, n, modo, 0);
+    }
+
+    // Parti di uguale dimensione, multiple di 16 elementi (64 byte)
+    size_t passo = ((n + parti - 1) / parti + 15) & ~(size_t)15;
+    std::vector<size_t> inizio(parti + 1);
+    for (size_t p = 0; p <= parti; p++) {
+        inizio[p] = std::min(p * passo, n);
+    }
+
+    // Prima passata: somma delle parti intermedie (1 ... parti - 2 in entrambe le
+    // direzioni). L'ultima non serve e la prima la scansiona intanto il chiamante:
+    // con uscita == ingresso un lavoratore la leggerebbe mentre viene riscritta.
+    bool indietro = (modo & SCANSIONE_INDIETRO) != 0;
+    std::vector<T> somme(parti, 0);
+    std::vector<std::thread> lavoratori;
+    for (size_t parte = 1; parte + 1 < parti; parte++) {
+        lavoratori.emplace_back([&, parte] {
+            somme[parte] = f.somma(ingresso + inizio[parte], inizio[parte + 1] - inizio[parte]);
+        });
+    }
+    // Il thread chiamante scansiona subito la prima parte, che non ha riporto
+    size_t primaParte = indietro ? parti - 1 : 0;
+    T totalePrima = f.scansione(ingresso + inizio[primaParte], uscita + inizio[primaParte],
+                                inizio[primaParte + 1] - inizio[primaParte], modo, 0);
+    for (std::thread &t : lavoratori) {
+        t.join();
+    }
+    lavoratori.clear();
+
+    // Riporti: somme delle parti precedenti nella direzione della scansione
+    std::vector<T> riporti(parti, 0);
+    T corrente = totalePrima;
+    for (size_t k = 1; k < parti; k++) {
+        size_t parte = indietro ? parti - 1 - k : k;
+        riporti[parte] = corrente;
+        corrente = sommaScalare(corrente, somme[parte]);
+    }
+
+    // Seconda passata: scansione di ogni parte con il suo riporto
+    T totale = 0;
+    for (size_t k = 1; k < parti; k++) {
+        size_t parte = indietro ? parti - 1 - k : k;
+        bool ultima = k == parti - 1;
+        auto lavoro = [&, parte, ultima] {
+            T r = f.scansione(ingresso + inizio[parte], uscita + inizio[parte], inizio[parte + 1] - inizio[parte],
+                              modo, riporti[parte]);
+            if (ultima) {
+                totale = r;
+            }
+        };
+        if (ultima) {
+            lavoro();   // l'ultima parte la fa il thread chiamante
+        } else {
+            lavoratori.emplace_back(lavoro);
+        }
+    }
+    for (std::thread &t : lavoratori) {
+        t.join();
+    }
+    return totale;
+}
+
+int32_t scansione(const int32_t ingresso[], int32_t uscita[], size_t n, int modo, unsigned thread) {
+    return scansioneParallela(ingresso, uscita, n, modo, thread);
+}
+
+int64_t scansione(const int64_t ingresso[], int64_t uscita[], size_t n, int modo, unsigned thread) {
+    return scansioneParallela(ingresso, uscita, n, modo, thread);
+}
+
+float scansione(const float ingresso[], float uscita[], size_t n, int modo, unsigned thread) {
+    return scansioneParallela(ingresso, uscita, n, modo, thread);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file scansione.h
+ * @brief Somme prefisse (scan) di vettori int32, int64 e float con SIMD e piu' thread
+ *
+ * es_vet_02.c e prep0403_vet.c calcolano t[i] = t[i + 1] + i: ogni elemento
+ * e' la somma di quelli che lo seguono, cioe' una scansione all'indietro.
+ * La stessa operazione in avanti serve per gli istogrammi (dove inizia ogni
+ * gruppo) e per la compattazione (dove va scritto ogni elemento tenuto).
+ *
+ * Modi (combinabili con |):
+ *   SCANSIONE_INCLUSIVA   uscita[i] = ingresso[0] + ... + ingresso[i]
+ *   SCANSIONE_ESCLUSIVA   uscita[i] = ingresso[0] + ... + ingresso[i - 1], uscita[0] = 0
+ *   SCANSIONE_INDIETRO    le somme vanno dalla fine: uscita[i] = ingresso[i] + ... + ingresso[n - 1]
+ *                         (esclusiva: da ingresso[i + 1])
+ *
+ * Dentro un registro SIMD la scansione si fa con log2(elementi) somme con
+ * spostamento (4 elementi: x += x << 1 elemento; x += x << 2 elementi), poi
+ * si aggiunge il riporto dei blocchi precedenti. Con piu' thread il vettore
+ * viene diviso in parti: prima ogni thread somma la sua parte, poi le somme
+ * delle parti diventano i riporti iniziali e ogni thread scansiona la sua parte.
+ *
+ * Le somme di interi girano come in complemento a 2 (nessun comportamento
+ * indefinito in caso di overflow). Con i float l'ordine delle somme cambia
+ * rispetto al ciclo semplice e i risultati possono differire negli ultimi bit.
+ * Ingresso e uscita possono essere lo stesso vettore.
+ *
+ * Compilazione: g++ -O2 -std=c++17 -pthread programma.cpp scansione.cpp
+ */
+#ifndef SCANSIONE_H
+#define SCANSIONE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum ModoScansione {
+    SCANSIONE_INCLUSIVA = 0,
+    SCANSIONE_ESCLUSIVA = 1,
+    SCANSIONE_INDIETRO = 2
+};
+
+/**
+ * Scansione di un vettore.
+ * @param ingresso i valori
+ * @param uscita dove scrivere le somme (puo' essere ingresso)
+ * @param n il numero di elementi
+ * @param modo SCANSIONE_INCLUSIVA o SCANSIONE_ESCLUSIVA, eventualmente | SCANSIONE_INDIETRO
+ * @param thread quanti thread usare al massimo (0 = tutti i processori)
+ * @return la somma di tutti gli elementi
+ */
+int32_t scansione(const int32_t ingresso[], int32_t uscita[], size_t n, int modo = SCANSIONE_INCLUSIVA,
+                  unsigned thread = 1);
+int64_t scansione(const int64_t ingresso[], int64_t uscita[], size_t n, int modo = SCANSIONE_INCLUSIVA,
+                  unsigned thread = 1);
+float scansione(const float ingresso[], float uscita[], size_t n, int modo = SCANSIONE_INCLUSIVA,
+                unsigned thread = 1);
+
+#endif // SCANSIONE_H
@@ -0,0 +1,191 @@
+/**
+ * @file bench_stringhe_ascii.c
+ * @brief Verifica e velocita' di stringhe_ascii contro i cicli un carattere alla volta
+ *
+ * 1. Verifica: su testi casuali (tutti i 256 byte, molte lunghezze e
+ *    posizioni di partenza) ogni funzione deve dare lo stesso risultato di
+ *    toupper/tolower/isdigit/isalpha/isspace di <ctype.h> e di strnlen/strchr.
+ * 2. Misura in GB/s, su un testo di N MB, le funzioni contro i cicli con <ctype.h>.
+ *
+ * Compilazione:
+ *   gcc -O2 -std=c11 bench_stringhe_ascii.c stringhe_ascii.c -o bench_stringhe_ascii
+ * Utilizzo:
+ *   ./bench_stringhe_ascii [MB]
+ */
+#define _POSIX_C_SOURCE 200809L   // clock_gettime e strnlen con -std=c11
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "stringhe_ascii.h"
+
+static double secondi(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int errori = 0;
+
+static void controlla(int condizione, const char *cosa, size_t n, size_t inizio) {
+    if (!condizione && errori++ < 10) {
+        printf("ERRORE: %s (n=%zu, inizio=%zu)\n", cosa, n, inizio);
+    }
+}
+
+// Classe attesa, con <ctype.h> nella localizzazione "C"
+static uint8_t classeCtype(unsigned char c) {
+    return (uint8_t)((isdigit(c) ? ASCII_CIFRA : 0) | (isupper(c) ? ASCII_MAIUSCOLA : 0) |
+                     (islower(c) ? ASCII_MINUSCOLA : 0) | (isspace(c) ? ASCII_SPAZIO : 0));
+}
+
+static void verifica(void) {
+    enum { MASSIMO = 600 };
+    char testo[MASSIMO + 64];
+    char risultato[MASSIMO + 64];
+    uint8_t classi[MASSIMO + 64];
+    for (int prova = 0; prova < 20000; prova++) {
+        size_t inizio = (size_t)(rand() % 32);
+        size_t n = (size_t)(rand() % MASSIMO);
+        for (size_t i = 0; i < sizeof(testo); i++) {
+            testo[i] = (char)(rand() % 256);
+        }
+        const char *t = testo + inizio;
+
+        asciiMaiuscolo(risultato, t, n);
+        int uguali = 1;
+        for (size_t i = 0; i < n; i++) {
+            uguali &= risultato[i] == (char)toupper((unsigned char)t[i]);
+        }
+        controlla(uguali, "asciiMaiuscolo", n, inizio);
+
+        asciiMinuscolo(risultato, t, n);
+        uguali = 1;
+        for (size_t i = 0; i < n; i++) {
+            uguali &= risultato[i] == (char)tolower((unsigned char)t[i]);
+        }
+        controlla(uguali, "asciiMinuscolo", n, inizio);
+
+        asciiClassifica(t, n, classi);
+        size_t cifre = 0, lettere = 0, byte = 0;
+        char cercato = t[0];
+        uguali = 1;
+        for (size_t i = 0; i < n; i++) {
+            unsigned char c = (unsigned char)t[i];
+            uguali &= classi[i] == classeCtype(c);
+            cifre += isdigit(c) != 0;
+            lettere += isalpha(c) != 0;
+            byte += t[i] == cercato;
+        }
+        controlla(uguali, "asciiClassifica", n, inizio);
+        controlla(asciiContaCifre(t, n) == cifre, "asciiContaCifre", n, inizio);
+        controlla(asciiContaLettere(t, n) == lettere, "asciiContaLettere", n, inizio);
+        controlla(asciiContaByte(t, n, cercato) == byte, "asciiContaByte", n, inizio);
+
+        // Stringhe con '\0' rari, per avere anche stringhe lunghe
+        for (size_t i = 0; i < sizeof(testo); i++) {
+            if (testo[i] == '\0' || rand() % 200 != 0) {
+                testo[i] = (char)(1 + rand() % 255);
+            } else {
+                testo[i] = '\0';
+            }
+        }
+        controlla(asciiLunghezza(t, n) == strnlen(t, n), "asciiLunghezza", n, inizio);
+        char c = (char)(rand() % 256);
+        const char *atteso = NULL;
+        for (size_t i = 0; i < n; i++) {
+            if (t[i] == c) {
+                atteso = t + i;
+                break;
+            }
+            if (t[i] == '\0') {
+                break;
+            }
+        }
+        controlla(asciiCerca(t, c, n) == atteso, "asciiCerca", n, inizio);
+    }
+    printf("verifica: %s\n\n", errori ? "ERRORI" : "ok");
+}
+
+int main(int argc, char *argv[]) {
+    verifica();
+
+    size_t mb = argc > 1 ? strtoul(argv[1], NULL, 10) : 64;
+    size_t n = mb << 20;
+    char *testo = malloc(n + 1);
+    char *risultato = malloc(n);
+    uint8_t *classi = malloc(n);
+    // Testo italiano con numeri: lettere, spazi, cifre, punteggiatura
+    const char *frase = "Il sensore 3 ha letto 21.5 gradi alle 14:05; MEDIA di 10 letture = 21.37\n";
+    size_t lunghezzaFrase = strlen(frase);
+    for (size_t i = 0; i < n; i++) {
+        testo[i] = frase[i % lunghezzaFrase];
+    }
+    testo[n] = '\0';
+    memset(risultato, 0, n);
+    memset(classi, 0, n);
+
+    printf("%zu MB di testo (GB/s)    un carattere alla volta    stringhe_ascii\n", mb);
+    double t0, tScalare, tSimd;
+    size_t a = 0, b = 0;
+
+    t0 = secondi();
+    for (size_t i = 0; i < n; i++) {
+        risultato[i] = (char)toupper((unsigned char)testo[i]);
+    }
+    tScalare = secondi() - t0;
+    t0 = secondi();
+    asciiMaiuscolo(risultato, testo, n);
+    tSimd = secondi() - t0;
+    printf("maiuscolo                %10.2f %24.2f\n", n / tScalare / 1e9, n / tSimd / 1e9);
+
+    t0 = secondi();
+    for (size_t i = 0; i < n; i++) {
+        classi[i] = classeCtype((unsigned char)testo[i]);
+    }
+    tScalare = secondi() - t0;
+    t0 = secondi();
+    asciiClassifica(testo, n, classi);
+    tSimd = secondi() - t0;
+    printf("classificazione          %10.2f %24.2f\n", n / tScalare / 1e9, n / tSimd / 1e9);
+
+    t0 = secondi();
+    for (size_t i = 0; i < n; i++) {
+        a += isdigit((unsigned char)testo[i]) != 0;
+    }
+    tScalare = secondi() - t0;
+    t0 = secondi();
+    b = asciiContaCifre(testo, n);
+    tSimd = secondi() - t0;
+    printf("conteggio cifre          %10.2f %24.2f\n", n / tScalare / 1e9, n / tSimd / 1e9);
+    controlla(a == b, "conteggio cifre", n, 0);
+
+    a = 0;
+    t0 = secondi();
+    for (volatile size_t i = 0; i < n; i++) {   // volatile: il compilatore non vettorizza
+        a += testo[i] == '\n';
+    }
+    tScalare = secondi() - t0;
+    t0 = secondi();
+    b = asciiContaByte(testo, n, '\n');
+    tSimd = secondi() - t0;
+    printf("conteggio di '\\n'        %10.2f %24.2f\n", n / tScalare / 1e9, n / tSimd / 1e9);
+    controlla(a == b, "conteggio di '\\n'", n, 0);
+
+    t0 = secondi();
+    for (a = 0; a < n && testo[a] != '\0'; a++) {
+    }
+    tScalare = secondi() - t0;
+    t0 = secondi();
+    b = asciiLunghezza(testo, n + 1);
+    tSimd = secondi() - t0;
+    printf("lunghezza                %10.2f %24.2f\n", n / tScalare / 1e9, n / tSimd / 1e9);
+    controlla(a == b, "lunghezza", n, 0);
+
+    free(testo);
+    free(risultato);
+    free(classi);
+    return errori != 0;
+}
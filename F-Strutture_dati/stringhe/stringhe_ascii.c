@@ -0,0 +1,284 @@
+/**
+ * @file stringhe_ascii.c
+ * @brief Versioni SSE2, AVX2 e un carattere alla volta delle operazioni sui caratteri
+ *
+ * Tutte le classi di caratteri sono intervalli ('0'...'9', 'a'...'z'): un
+ * carattere e' nell'intervallo [basso, alto] se c - basso, senza segno, e'
+ * <= alto - basso. SSE2 e AVX2 confrontano solo byte con segno: con lo XOR
+ * 0x80 i byte da 0 a 255 diventano da -128 a 127 nello stesso ordine.
+ */
+#include "stringhe_ascii.h"
+
+// SSE2 c'e' su tutti i processori x86 a 64 bit; AVX2 viene scelto a runtime
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define STRINGHE_X86 1
+#endif
+
+#define DIFFERENZA_MAIUSCOLE 0x20   // 'a' - 'A'
+
+static inline int tra(char c, char basso, char alto) {
+    return (unsigned char)(c - basso) <= (unsigned char)(alto - basso);
+}
+
+static inline uint8_t classe(char c) {
+    return (uint8_t)(tra(c, '0', '9') * ASCII_CIFRA | tra(c, 'A', 'Z') * ASCII_MAIUSCOLA |
+                     tra(c, 'a', 'z') * ASCII_MINUSCOLA | (c == ' ' || tra(c, '\t', '\r')) * ASCII_SPAZIO);
+}
+
+//----------------------------------------------------------------------
+// Un carattere alla volta: code dei vettori e processori non x86
+//----------------------------------------------------------------------
+
+// Inverte maiuscola/minuscola dei caratteri tra basso e alto
+static void convertiScalare(char destinazione[], const char sorgente[], size_t n, char basso, char alto) {
+    for (size_t i = 0; i < n; i++) {
+        char c = sorgente[i];
+        destinazione[i] = tra(c, basso, alto) ? (char)(c ^ DIFFERENZA_MAIUSCOLE) : c;
+    }
+}
+
+// Conta i caratteri che, dopo l'OR con o, sono tra basso e alto
+static size_t contaScalare(const char testo[], size_t n, char o, char basso, char alto) {
+    size_t conteggio = 0;
+    for (size_t i = 0; i < n; i++) {
+        conteggio += tra((char)(testo[i] | o), basso, alto);
+    }
+    return conteggio;
+}
+
+static void classificaScalare(const char testo[], size_t n, uint8_t classi[]) {
+    for (size_t i = 0; i < n; i++) {
+        classi[i] = classe(testo[i]);
+    }
+}
+
+#ifdef STRINGHE_X86
+
+//----------------------------------------------------------------------
+// SSE2: 16 caratteri alla volta
+//----------------------------------------------------------------------
+
+// 0xFF nei byte tra basso e alto, 0 negli altri
+static inline __m128i traSse2(__m128i v, char basso, char alto) {
+    __m128i t = _mm_xor_si128(_mm_sub_epi8(v, _mm_set1_epi8(basso)), _mm_set1_epi8((char)0x80));
+    return _mm_cmpgt_epi8(_mm_set1_epi8((char)(0x80 + alto - basso + 1)), t);
+}
+
+static void convertiSse2(char destinazione[], const char sorgente[], size_t n, char basso, char alto) {
+    __m128i bit = _mm_set1_epi8(DIFFERENZA_MAIUSCOLE);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&sorgente[i]);
+        __m128i m = traSse2(v, basso, alto);
+        _mm_storeu_si128((__m128i *)&destinazione[i], _mm_xor_si128(v, _mm_and_si128(m, bit)));
+    }
+    convertiScalare(destinazione + i, sorgente + i, n - i, basso, alto);
+}
+
+static size_t contaSse2(const char testo[], size_t n, char o, char basso, char alto) {
+    __m128i bitOr = _mm_set1_epi8(o);
+    __m128i totale = _mm_setzero_si128();
+    size_t i = 0;
+    while (i + 16 <= n) {
+        // Contatori a 8 bit (0xFF = -1 per ogni carattere trovato): al massimo 255 giri,
+        // poi _mm_sad_epu8 li somma in due contatori a 64 bit
+        __m128i parziale = _mm_setzero_si128();
+        for (int giri = 0; giri < 255 && i + 16 <= n; giri++, i += 16) {
+            __m128i v = _mm_or_si128(_mm_loadu_si128((const __m128i *)&testo[i]), bitOr);
+            parziale = _mm_sub_epi8(parziale, traSse2(v, basso, alto));
+        }
+        totale = _mm_add_epi64(totale, _mm_sad_epu8(parziale, _mm_setzero_si128()));
+    }
+    size_t conteggio = (size_t)_mm_cvtsi128_si64(totale) + (size_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(totale, totale));
+    return conteggio + contaScalare(testo + i, n - i, o, basso, alto);
+}
+
+static void classificaSse2(const char testo[], size_t n, uint8_t classi[]) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&testo[i]);
+        __m128i spazio = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), traSse2(v, '\t', '\r'));
+        __m128i c = _mm_and_si128(traSse2(v, '0', '9'), _mm_set1_epi8(ASCII_CIFRA));
+        c = _mm_or_si128(c, _mm_and_si128(traSse2(v, 'A', 'Z'), _mm_set1_epi8(ASCII_MAIUSCOLA)));
+        c = _mm_or_si128(c, _mm_and_si128(traSse2(v, 'a', 'z'), _mm_set1_epi8(ASCII_MINUSCOLA)));
+        c = _mm_or_si128(c, _mm_and_si128(spazio, _mm_set1_epi8(ASCII_SPAZIO)));
+        _mm_storeu_si128((__m128i *)&classi[i], c);
+    }
+    classificaScalare(testo + i, n - i, classi + i);
+}
+
+//----------------------------------------------------------------------
+// AVX2: 32 caratteri alla volta
+//----------------------------------------------------------------------
+
+__attribute__((target("avx2"))) static inline __m256i traAvx2(__m256i v, char basso, char alto) {
+    __m256i t = _mm256_xor_si256(_mm256_sub_epi8(v, _mm256_set1_epi8(basso)), _mm256_set1_epi8((char)0x80));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(0x80 + alto - basso + 1)), t);
+}
+
+__attribute__((target("avx2"))) static void convertiAvx2(char destinazione[], const char sorgente[], size_t n,
+                                                         char basso, char alto) {
+    __m256i bit = _mm256_set1_epi8(DIFFERENZA_MAIUSCOLE);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&sorgente[i]);
+        __m256i m = traAvx2(v, basso, alto);
+        _mm256_storeu_si256((__m256i *)&destinazione[i], _mm256_xor_si256(v, _mm256_and_si256(m, bit)));
+    }
+    convertiSse2(destinazione + i, sorgente + i, n - i, basso, alto);
+}
+
+__attribute__((target("avx2"))) static size_t contaAvx2(const char testo[], size_t n, char o, char basso,
+                                                        char alto) {
+    __m256i bitOr = _mm256_set1_epi8(o);
+    __m256i totale = _mm256_setzero_si256();
+    size_t i = 0;
+    while (i + 32 <= n) {
+        __m256i parziale = _mm256_setzero_si256();
+        for (int giri = 0; giri < 255 && i + 32 <= n; giri++, i += 32) {
+            __m256i v = _mm256_or_si256(_mm256_loadu_si256((const __m256i *)&testo[i]), bitOr);
+            parziale = _mm256_sub_epi8(parziale, traAvx2(v, basso, alto));
+        }
+        totale = _mm256_add_epi64(totale, _mm256_sad_epu8(parziale, _mm256_setzero_si256()));
+    }
+    uint64_t parti[4];
+    _mm256_storeu_si256((__m256i *)parti, totale);
+    return (size_t)(parti[0] + parti[1] + parti[2] + parti[3]) + contaSse2(testo + i, n - i, o, basso, alto);
+}
+
+__attribute__((target("avx2"))) static void classificaAvx2(const char testo[], size_t n, uint8_t classi[]) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&testo[i]);
+        __m256i spazio = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), traAvx2(v, '\t', '\r'));
+        __m256i c = _mm256_and_si256(traAvx2(v, '0', '9'), _mm256_set1_epi8(ASCII_CIFRA));
+        c = _mm256_or_si256(c, _mm256_and_si256(traAvx2(v, 'A', 'Z'), _mm256_set1_epi8(ASCII_MAIUSCOLA)));
+        c = _mm256_or_si256(c, _mm256_and_si256(traAvx2(v, 'a', 'z'), _mm256_set1_epi8(ASCII_MINUSCOLA)));
+        c = _mm256_or_si256(c, _mm256_and_si256(spazio, _mm256_set1_epi8(ASCII_SPAZIO)));
+        _mm256_storeu_si256((__m256i *)&classi[i], c);
+    }
+    classificaSse2(testo + i, n - i, classi + i);
+}
+
+#endif // STRINGHE_X86
+
+//----------------------------------------------------------------------
+// Funzioni pubbliche
+//----------------------------------------------------------------------
+
+static void converti(char destinazione[], const char sorgente[], size_t n, char basso, char alto) {
+#ifdef STRINGHE_X86
+    if (__builtin_cpu_supports("avx2")) {
+        convertiAvx2(destinazione, sorgente, n, basso, alto);
+    } else {
+        convertiSse2(destinazione, sorgente, n, basso, alto);
+    }
+#else
+    convertiScalare(destinazione, sorgente, n, basso, alto);
+#endif
+}
+
+static size_t conta(const char testo[], size_t n, char o, char basso, char alto) {
+#ifdef STRINGHE_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return contaAvx2(testo, n, o, basso, alto);
+    }
+    return contaSse2(testo, n, o, basso, alto);
+#else
+    return contaScalare(testo, n, o, basso, alto);
+#endif
+}
+
+void asciiMaiuscolo(char destinazione[], const char sorgente[], size_t n) {
+    converti(destinazione, sorgente, n, 'a', 'z');
+}
+
+void asciiMinuscolo(char destinazione[], const char sorgente[], size_t n) {
+    converti(destinazione, sorgente, n, 'A', 'Z');
+}
+
+void asciiClassifica(const char testo[], size_t n, uint8_t classi[]) {
+#ifdef STRINGHE_X86
+    if (__builtin_cpu_supports("avx2")) {
+        classificaAvx2(testo, n, classi);
+    } else {
+        classificaSse2(testo, n, classi);
+    }
+#else
+    classificaScalare(testo, n, classi);
+#endif
+}
+
+size_t asciiContaCifre(const char testo[], size_t n) {
+    return conta(testo, n, 0, '0', '9');
+}
+
+size_t asciiContaLettere(const char testo[], size_t n) {
+    // Con il bit 0x20 a uno le maiuscole diventano minuscole e nessun altro carattere diventa una lettera
+    return conta(testo, n, DIFFERENZA_MAIUSCOLE, 'a', 'z');
+}
+
+size_t asciiContaByte(const char testo[], size_t n, char c) {
+    return conta(testo, n, 0, c, c);
+}
+
+// Le ricerche del '\0' leggono blocchi allineati a 16 byte interamente entro max:
+// non leggono mai oltre la fine del vettore, nemmeno quando la stringa non e' terminata
+size_t asciiLunghezza(const char stringa[], size_t max) {
+    size_t i = 0;
+#ifdef STRINGHE_X86
+    for (; i < max && ((uintptr_t)(stringa + i) & 15) != 0; i++) {
+        if (stringa[i] == '\0') {
+            return i;
+        }
+    }
+    for (; i + 16 <= max; i += 16) {
+        __m128i v = _mm_load_si128((const __m128i *)&stringa[i]);
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+        if (m != 0) {
+            return i + (size_t)__builtin_ctz(m);
+        }
+    }
+#endif
+    for (; i < max; i++) {
+        if (stringa[i] == '\0') {
+            return i;
+        }
+    }
+    return max;
+}
+
+const char *asciiCerca(const char stringa[], char c, size_t max) {
+    size_t i = 0;
+#ifdef STRINGHE_X86
+    for (; i < max && ((uintptr_t)(stringa + i) & 15) != 0; i++) {
+        if (stringa[i] == c) {
+            return stringa + i;
+        }
+        if (stringa[i] == '\0') {
+            return NULL;
+        }
+    }
+    __m128i cercato = _mm_set1_epi8(c);
+    for (; i + 16 <= max; i += 16) {
+        __m128i v = _mm_load_si128((const __m128i *)&stringa[i]);
+        __m128i trovati = _mm_or_si128(_mm_cmpeq_epi8(v, cercato), _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+        unsigned m = (unsigned)_mm_movemask_epi8(trovati);
+        if (m != 0) {
+            // Il primo byte trovato e' c oppure il '\0' che chiude la stringa
+            const char *p = stringa + i + __builtin_ctz(m);
+            return *p == c ? p : NULL;
+        }
+    }
+#endif
+    for (; i < max; i++) {
+        if (stringa[i] == c) {
+            return stringa + i;
+        }
+        if (stringa[i] == '\0') {
+            return NULL;
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file stringhe_ascii.h
+ * @brief Operazioni su grandi vettori di caratteri ASCII, 16 o 32 caratteri alla volta
+ *
+ * Gli esercizi sui vettori di caratteri (main_arg.c, prep0409_vet.c,
+ * es_vet_str_04.c) lavorano un char alla volta: 'a' - 'A', t[2] - t[0],
+ * msg2[4] = 65. Su buffer di testo grandi le stesse operazioni si fanno con le
+ * istruzioni SIMD: un confronto o una somma tra due registri da 16 byte (SSE2)
+ * o 32 byte (AVX2) elabora 16 o 32 caratteri insieme. Per esempio il
+ * passaggio a maiuscolo di ogni carattere tra 'a' e 'z' e' c - ('a' - 'A'),
+ * cioe' c con il bit 0x20 a zero: per 16 caratteri bastano un confronto, un
+ * AND e uno XOR.
+ *
+ * SSE2 c'e' su tutti i processori x86 a 64 bit; AVX2 viene usato se il
+ * processore lo supporta; sugli altri processori le stesse funzioni lavorano
+ * un carattere alla volta. I byte >= 128 (UTF-8) non sono lettere ne' cifre e
+ * non vengono modificati.
+ */
+#ifndef STRINGHE_ASCII_H
+#define STRINGHE_ASCII_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Bit di asciiClassifica() */
+#define ASCII_CIFRA 0x01       // '0' ... '9'
+#define ASCII_MAIUSCOLA 0x02   // 'A' ... 'Z'
+#define ASCII_MINUSCOLA 0x04   // 'a' ... 'z'
+#define ASCII_SPAZIO 0x08      // ' ', '\t', '\n', '\v', '\f', '\r'
+#define ASCII_LETTERA (ASCII_MAIUSCOLA | ASCII_MINUSCOLA)
+
+/**
+ * Copia n caratteri passando le lettere minuscole a maiuscolo.
+ * @param destinazione dove scrivere (puo' essere sorgente stessa)
+ * @param sorgente il testo
+ * @param n il numero di caratteri
+ */
+void asciiMaiuscolo(char destinazione[], const char sorgente[], size_t n);
+
+/**
+ * Copia n caratteri passando le lettere maiuscole a minuscolo.
+ */
+void asciiMinuscolo(char destinazione[], const char sorgente[], size_t n);
+
+/**
+ * Scrive per ogni carattere i bit ASCII_CIFRA, ASCII_MAIUSCOLA, ASCII_MINUSCOLA, ASCII_SPAZIO.
+ * @param testo il testo
+ * @param n il numero di caratteri
+ * @param classi dove scrivere le classi, n byte
+ */
+void asciiClassifica(const char testo[], size_t n, uint8_t classi[]);
+
+/**
+ * @return quanti caratteri di testo sono cifre
+ */
+size_t asciiContaCifre(const char testo[], size_t n);
+
+/**
+ * @return quanti caratteri di testo sono lettere
+ */
+size_t asciiContaLettere(const char testo[], size_t n);
+
+/**
+ * @return quante volte il byte c compare nei primi n byte di testo
+ */
+size_t asciiContaByte(const char testo[], size_t n, char c);
+
+/**
+ * Lunghezza di una stringa, senza leggere oltre max byte.
+ * @return la posizione del primo '\0', max se non c'e' nei primi max byte
+ */
+size_t asciiLunghezza(const char stringa[], size_t max);
+
+/**
+ * Cerca un carattere in una stringa, senza leggere oltre max byte.
+ * @return il puntatore alla prima c prima del '\0', NULL se non c'e'
+ */
+const char *asciiCerca(const char stringa[], char c, size_t max);
+
+#endif // STRINGHE_ASCII_H
@@ -0,0 +1,138 @@
+/**
+ * @file bench_catena.cpp
+ * @brief Catene pigre contro passate separate con vettori temporanei e contro il ciclo scritto a mano
+ *
+ * Tre elaborazioni su un vettore di n interi (e uno di float):
+ *  - somma dei quadrati pari (mappa, filtra, riduci);
+ *  - prodotto scalare di due vettori (affianca, mappa, somma);
+ *  - i primi 100 elementi multipli di 1000 (filtra, prendi, scriviIn).
+ * Per ognuna: passate separate con std::transform/std::copy_if/std::accumulate
+ * e vettori temporanei, la catena, e il ciclo for scritto a mano.
+ * I risultati delle tre versioni devono coincidere.
+ *
+ * Compilazione:
+ *   g++ -O2 -std=c++17 bench_catena.cpp -o bench_catena
+ * Utilizzo:
+ *   ./bench_catena [milioni di elementi]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+#include "catena.h"
+
+static double secondi() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Esegue f 5 volte e restituisce il tempo migliore in millisecondi
+template <class F>
+static double misura(F f) {
+    double migliore = 1e9;
+    for (int r = 0; r < 5; r++) {
+        double t0 = secondi();
+        f();
+        migliore = std::min(migliore, secondi() - t0);
+    }
+    return migliore * 1e3;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = (size_t)((argc > 1 ? atof(argv[1]) : 16) * 1e6);
+    std::vector<int> v(n);
+    std::vector<float> a(n);
+    std::vector<float> b(n);
+    srand(1);
+    for (size_t i = 0; i < n; i++) {
+        v[i] = rand() % 20001 - 10000;
+        a[i] = (rand() % 200 - 100) / 16.0f;
+        b[i] = (rand() % 200 - 100) / 16.0f;
+    }
+    int errori = 0;
+    printf("%zu elementi, millisecondi\n%-28s %10s %10s %10s\n", n, "elaborazione", "passate", "catena", "a mano");
+
+    // Somma dei quadrati pari
+    long long r1 = 0;
+    long long r2 = 0;
+    long long r3 = 0;
+    double t1 = misura([&] {
+        std::vector<long long> quadrati(v.size());
+        std::transform(v.begin(), v.end(), quadrati.begin(), [](int x) { return (long long)x * x; });
+        std::vector<long long> pari;
+        std::copy_if(quadrati.begin(), quadrati.end(), std::back_inserter(pari),
+                     [](long long x) { return x % 2 == 0; });
+        r1 = std::accumulate(pari.begin(), pari.end(), 0ll);
+    });
+    double t2 = misura([&] {
+        r2 = da(v) | mappa([](int x) { return (long long)x * x; }) | filtra([](long long x) { return x % 2 == 0; }) |
+             somma();
+    });
+    double t3 = misura([&] {
+        long long s = 0;
+        for (int x : v) {
+            long long q = (long long)x * x;
+            if (q % 2 == 0) {
+                s += q;
+            }
+        }
+        r3 = s;
+    });
+    errori += r1 != r2 || r1 != r3;
+    printf("%-28s %10.2f %10.2f %10.2f\n", "quadrati pari", t1, t2, t3);
+
+    // Prodotto scalare (le somme in double, nello stesso ordine nelle tre versioni)
+    double p1 = 0;
+    double p2 = 0;
+    double p3 = 0;
+    t1 = misura([&] {
+        std::vector<double> prodotti(n);
+        std::transform(a.begin(), a.end(), b.begin(), prodotti.begin(),
+                       [](float x, float y) { return (double)x * y; });
+        p1 = std::accumulate(prodotti.begin(), prodotti.end(), 0.0);
+    });
+    t2 = misura([&] {
+        p2 = affianca(a, b) | mappa([](std::pair<float, float> c) { return (double)c.first * c.second; }) | somma();
+    });
+    t3 = misura([&] {
+        double s = 0;
+        for (size_t i = 0; i < n; i++) {
+            s += (double)a[i] * b[i];
+        }
+        p3 = s;
+    });
+    errori += p1 != p2 || p1 != p3;
+    printf("%-28s %10.2f %10.2f %10.2f\n", "prodotto scalare", t1, t2, t3);
+
+    // I primi 100 multipli di 1000: la catena si ferma appena li ha trovati
+    std::vector<int> primi1;
+    int primi2[100];
+    int primi3[100];
+    size_t k2 = 0;
+    size_t k3 = 0;
+    t1 = misura([&] {
+        std::vector<int> multipli;
+        std::copy_if(v.begin(), v.end(), std::back_inserter(multipli), [](int x) { return x % 1000 == 0; });
+        primi1.assign(multipli.begin(), multipli.begin() + std::min<size_t>(100, multipli.size()));
+    });
+    t2 = misura([&] { k2 = da(v) | filtra([](int x) { return x % 1000 == 0; }) | prendi(100) | scriviIn(primi2); });
+    t3 = misura([&] {
+        k3 = 0;
+        for (size_t i = 0; i < n && k3 < 100; i++) {
+            if (v[i] % 1000 == 0) {
+                primi3[k3++] = v[i];
+            }
+        }
+    });
+    errori += k2 != primi1.size() || k3 != k2 || !std::equal(primi1.begin(), primi1.end(), primi2) ||
+              !std::equal(primi2, primi2 + k2, primi3);
+    printf("%-28s %10.3f %10.3f %10.3f\n", "primi 100 multipli di 1000", t1, t2, t3);
+
+    printf("\nverifica: %s\n", errori ? "ERRORE, risultati diversi" : "risultati uguali");
+    return errori != 0;
+}
@@ -0,0 +1,303 @@
+/**
+ * @file catena.h
+ * @brief Catene pigre di operazioni sui vettori (mappa, filtra, affianca, prendi, riduci) in un solo ciclo
+ *
+ * Scrivere le elaborazioni come passate separate
+ *   std::vector<int> quadrati(n);  std::transform(...);      // passata 1
+ *   std::vector<int> pari;         std::copy_if(...);        // passata 2
+ *   int somma = std::accumulate(...);                        // passata 3
+ * alloca un vettore temporaneo per ogni passaggio e rilegge tutti i dati
+ * dalla memoria ogni volta. Con una catena
+ *   int somma = da(vettore)
+ *             | mappa([](int x) { return x * x; })
+ *             | filtra([](int x) { return x % 2 == 0; })
+ *             | riduci(0, [](int a, int b) { return a + b; });
+ * non viene calcolato niente finche' non si arriva all'operazione finale
+ * (riduci, somma, conta, perOgni, scriviIn, raccogli): a quel punto ogni
+ * elemento attraversa tutti i passaggi uno dopo l'altro. Le funzioni sono
+ * lambda passate per valore, quindi il compilatore le inserisce tutte nel
+ * ciclo della sorgente: il risultato e' lo stesso ciclo for (int x : vettore)
+ * di foreach.cpp scritto a mano, senza allocazioni.
+ *
+ * Come funziona: una catena contiene una funzione che "spinge" ogni elemento
+ * verso una destinazione (un'altra lambda) finche' questa non risponde false.
+ * mappa e filtra avvolgono la destinazione; prendi risponde false dopo n
+ * elementi e ferma il ciclo.
+ *
+ * Le sorgenti (vettori C, std::array, std::vector, std::span) non vengono
+ * copiate: devono esistere finche' si usa la catena.
+ * Richiede C++17 (std::span con C++20).
+ */
+#ifndef CATENA_H
+#define CATENA_H
+
+#include <stddef.h>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Catena di operazioni con elementi di tipo Elemento: spingi(destinazione)
+ * chiama destinazione(elemento) per ogni elemento, finche' la destinazione
+ * restituisce true.
+ */
+template <typename Elemento, class Spingi>
+class Catena {
+public:
+    typedef Elemento TipoElemento;
+
+    explicit Catena(Spingi spingi) : spingi(std::move(spingi)) {}
+
+    template <class Destinazione>
+    void esegui(Destinazione &&destinazione) const {
+        spingi(destinazione);
+    }
+
+private:
+    Spingi spingi;
+};
+
+template <typename Elemento, class Spingi>
+Catena<Elemento, Spingi> creaCatena(Spingi spingi) {
+    return Catena<Elemento, Spingi>(std::move(spingi));
+}
+
+//----------------------------------------------------------------------
+// Sorgenti
+//----------------------------------------------------------------------
+
+/**
+ * Catena sugli n elementi che iniziano da dati.
+ */
+template <typename T>
+auto da(T *dati, size_t n) {
+    return creaCatena<std::remove_cv_t<T>>([dati, n](auto &destinazione) {
+        for (size_t i = 0; i < n; i++) {
+            if (!destinazione(dati[i])) {
+                return;
+            }
+        }
+    });
+}
+
+/**
+ * Catena su un vettore C, std::array, std::vector o std::span.
+ */
+template <class Contenitore>
+auto da(Contenitore &&contenitore) {
+    return da(std::data(contenitore), std::size(contenitore));
+}
+
+/**
+ * Catena sulle coppie (a[i], b[i]) di due vettori, lunga quanto il piu' corto.
+ * Gli elementi sono std::pair di copie: per tipi semplici (numeri, puntatori).
+ */
+template <class A, class B>
+auto affianca(A &&a, B &&b) {
+    auto *pa = std::data(a);
+    auto *pb = std::data(b);
+    size_t n = std::size(a) < std::size(b) ? std::size(a) : std::size(b);
+    typedef std::pair<std::remove_cv_t<std::remove_reference_t<decltype(*pa)>>,
+                      std::remove_cv_t<std::remove_reference_t<decltype(*pb)>>>
+        Coppia;
+    return creaCatena<Coppia>([pa, pb, n](auto &destinazione) {
+        for (size_t i = 0; i < n; i++) {
+            if (!destinazione(Coppia(pa[i], pb[i]))) {
+                return;
+            }
+        }
+    });
+}
+
+/**
+ * Catena sui numeri interi da inizio (compreso) a fine (escluso).
+ */
+template <typename T>
+auto intervallo(T inizio, T fine) {
+    return creaCatena<T>([inizio, fine](auto &destinazione) {
+        for (T i = inizio; i < fine; i++) {
+            if (!destinazione(i)) {
+                return;
+            }
+        }
+    });
+}
+
+//----------------------------------------------------------------------
+// Passaggi intermedi
+//----------------------------------------------------------------------
+
+template <class F>
+struct Mappa {
+    F f;
+};
+
+template <class F>
+struct Filtra {
+    F f;
+};
+
+struct Prendi {
+    size_t n;
+};
+
+/** Sostituisce ogni elemento x con f(x) */
+template <class F>
+Mappa<F> mappa(F f) {
+    return Mappa<F>{std::move(f)};
+}
+
+/** Tiene solo gli elementi per cui f(x) e' vero */
+template <class F>
+Filtra<F> filtra(F f) {
+    return Filtra<F>{std::move(f)};
+}
+
+/** Tiene solo i primi n elementi e poi ferma la sorgente */
+inline Prendi prendi(size_t n) {
+    return Prendi{n};
+}
+
+template <typename E, class Spingi, class F>
+auto operator|(const Catena<E, Spingi> &catena, Mappa<F> m) {
+    typedef std::decay_t<decltype(m.f(std::declval<E>()))> Risultato;
+    return creaCatena<Risultato>([catena, f = std::move(m.f)](auto &destinazione) {
+        catena.esegui([&](auto &&x) { return destinazione(f(std::forward<decltype(x)>(x))); });
+    });
+}
+
+template <typename E, class Spingi, class F>
+auto operator|(const Catena<E, Spingi> &catena, Filtra<F> filtro) {
+    return creaCatena<E>([catena, f = std::move(filtro.f)](auto &destinazione) {
+        catena.esegui([&](auto &&x) { return f(x) ? destinazione(std::forward<decltype(x)>(x)) : true; });
+    });
+}
+
+template <typename E, class Spingi>
+auto operator|(const Catena<E, Spingi> &catena, Prendi p) {
+    return creaCatena<E>([catena, n = p.n](auto &destinazione) {
+        if (n == 0) {
+            return;
+        }
+        size_t presi = 0;
+        catena.esegui([&](auto &&x) { return destinazione(std::forward<decltype(x)>(x)) && ++presi < n; });
+    });
+}
+
+//----------------------------------------------------------------------
+// Operazioni finali: eseguono la catena
+//----------------------------------------------------------------------
+
+template <class T, class F>
+struct Riduci {
+    T iniziale;
+    F f;
+};
+
+template <class F>
+struct PerOgni {
+    F f;
+};
+
+template <typename T>
+struct ScriviIn {
+    T *uscita;
+};
+
+struct Somma {};
+struct Conta {};
+struct Raccogli {};
+
+/** Combina gli elementi: risultato = f(...f(f(iniziale, x0), x1)..., xn) */
+template <class T, class F>
+Riduci<T, F> riduci(T iniziale, F f) {
+    return Riduci<T, F>{std::move(iniziale), std::move(f)};
+}
+
+/** Chiama f(x) per ogni elemento */
+template <class F>
+PerOgni<F> perOgni(F f) {
+    return PerOgni<F>{std::move(f)};
+}
+
+/** Scrive gli elementi nel vettore indicato (abbastanza grande) e restituisce quanti sono */
+template <typename T>
+ScriviIn<T> scriviIn(T *uscita) {
+    return ScriviIn<T>{uscita};
+}
+
+/** Somma degli elementi, nel loro tipo (partendo da 0) */
+inline Somma somma() {
+    return Somma{};
+}
+
+/** Numero degli elementi */
+inline Conta conta() {
+    return Conta{};
+}
+
+/** Elementi in un std::vector (l'unica operazione che alloca memoria) */
+inline Raccogli raccogli() {
+    return Raccogli{};
+}
+
+template <typename E, class Spingi, class T, class F>
+T operator|(const Catena<E, Spingi> &catena, Riduci<T, F> r) {
+    T risultato = std::move(r.iniziale);
+    catena.esegui([&](auto &&x) {
+        risultato = r.f(std::move(risultato), std::forward<decltype(x)>(x));
+        return true;
+    });
+    return risultato;
+}
+
+template <typename E, class Spingi, class F>
+void operator|(const Catena<E, Spingi> &catena, PerOgni<F> p) {
+    catena.esegui([&](auto &&x) {
+        p.f(std::forward<decltype(x)>(x));
+        return true;
+    });
+}
+
+template <typename E, class Spingi, typename T>
+size_t operator|(const Catena<E, Spingi> &catena, ScriviIn<T> s) {
+    size_t n = 0;
+    catena.esegui([&](auto &&x) {
+        s.uscita[n++] = std::forward<decltype(x)>(x);
+        return true;
+    });
+    return n;
+}
+
+template <typename E, class Spingi>
+E operator|(const Catena<E, Spingi> &catena, Somma) {
+    E risultato{};
+    catena.esegui([&](auto &&x) {
+        risultato += x;
+        return true;
+    });
+    return risultato;
+}
+
+template <typename E, class Spingi>
+size_t operator|(const Catena<E, Spingi> &catena, Conta) {
+    size_t n = 0;
+    catena.esegui([&](auto &&) {
+        n++;
+        return true;
+    });
+    return n;
+}
+
+template <typename E, class Spingi>
+std::vector<E> operator|(const Catena<E, Spingi> &catena, Raccogli) {
+    std::vector<E> risultato;
+    catena.esegui([&](auto &&x) {
+        risultato.push_back(std::forward<decltype(x)>(x));
+        return true;
+    });
+    return risultato;
+}
+
+#endif // CATENA_H
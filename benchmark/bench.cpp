@@ -0,0 +1,159 @@
+/**
+ * @file bench.cpp
+ * @brief Esecuzione dei benchmark registrati e stampa dei risultati (tabella, CSV, JSON)
+ *
+ * Utilizzo:
+ *   ./bench [--filtro testo] [--formato tabella|csv|json] [--cpu N]
+ *           [--tempo secondi] [--ripetizioni R] [--elenco]
+ *
+ *   --filtro       solo i benchmark il cui nome contiene testo
+ *   --formato      tabella (predefinito), csv o json per gli script di confronto
+ *   --cpu          esegue il processo solo sulla CPU N (misure piu' stabili)
+ *   --tempo        durata minima di una ripetizione (predefinito 0.05 s)
+ *   --ripetizioni  ripetizioni per dimensione (predefinito 5): si riporta la mediana
+ *   --elenco       stampa i nomi dei benchmark ed esce
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // sched_setaffinity
+#endif
+#include "bench.h"
+
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+struct VoceBench {
+    const char *nome;
+    std::vector<long> dimensioni;
+    FunzioneBench funzione;
+};
+
+// Funzione con variabile statica: i benchmark si registrano durante l'inizializzazione
+// dei file che li contengono, in un ordine che non si puo' prevedere
+static std::vector<VoceBench> &registro() {
+    static std::vector<VoceBench> voci;
+    return voci;
+}
+
+void registraBench(const char *nome, std::vector<long> dimensioni, FunzioneBench funzione) {
+    registro().push_back(VoceBench{nome, dimensioni, funzione});
+}
+
+SenzaStdout::SenzaStdout() {
+    fflush(stdout);
+    salvato = dup(STDOUT_FILENO);
+    int nulla = open("/dev/null", O_WRONLY);
+    if (nulla >= 0) {
+        dup2(nulla, STDOUT_FILENO);
+        close(nulla);
+    }
+}
+
+SenzaStdout::~SenzaStdout() {
+    fflush(stdout);
+    if (salvato >= 0) {
+        dup2(salvato, STDOUT_FILENO);
+        close(salvato);
+    }
+}
+
+static void stampaTabella(const std::vector<RisultatoBench> &risultati) {
+    printf("%-28s %10s %12s %14s %14s %12s\n", "benchmark", "n", "iterazioni", "ns/op mediana", "ns/op minimo",
+           "ns/elemento");
+    for (const RisultatoBench &r : risultati) {
+        printf("%-28s %10ld %12llu %14.1f %14.1f %12.3f\n", r.nome.c_str(), r.n, (unsigned long long)r.iterazioni,
+               r.nsMediana, r.nsMinimo, r.nsMediana / r.elementi);
+    }
+}
+
+static void stampaCsv(const std::vector<RisultatoBench> &risultati) {
+    printf("benchmark,n,iterazioni,ripetizioni,ns_mediana,ns_minimo,ns_massimo,elementi,ns_elemento\n");
+    for (const RisultatoBench &r : risultati) {
+        printf("%s,%ld,%llu,%d,%.3f,%.3f,%.3f,%.0f,%.6f\n", r.nome.c_str(), r.n, (unsigned long long)r.iterazioni,
+               r.ripetizioni, r.nsMediana, r.nsMinimo, r.nsMassimo, r.elementi, r.nsMediana / r.elementi);
+    }
+}
+
+static void stampaJson(const std::vector<RisultatoBench> &risultati, int cpu) {
+    printf("{\n  \"compilatore\": \"%s\",\n  \"cpu\": %d,\n  \"risultati\": [\n", __VERSION__, cpu);
+    for (size_t i = 0; i < risultati.size(); i++) {
+        const RisultatoBench &r = risultati[i];
+        printf("    {\"benchmark\": \"%s\", \"n\": %ld, \"iterazioni\": %llu, \"ripetizioni\": %d, "
+               "\"ns_mediana\": %.3f, \"ns_minimo\": %.3f, \"ns_massimo\": %.3f, \"elementi\": %.0f}%s\n",
+               r.nome.c_str(), r.n, (unsigned long long)r.iterazioni, r.ripetizioni, r.nsMediana, r.nsMinimo,
+               r.nsMassimo, r.elementi, i + 1 < risultati.size() ? "," : "");
+    }
+    printf("  ]\n}\n");
+}
+
+int main(int argc, char *argv[]) {
+    OpzioniBench opzioni;
+    const char *filtro = "";
+    const char *formato = "tabella";
+    int cpu = -1;
+    for (int i = 1; i < argc; i++) {
+        const char *valore = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(argv[i], "--elenco") == 0) {
+            for (const VoceBench &v : registro()) {
+                printf("%s\n", v.nome);
+            }
+            return 0;
+        } else if (strcmp(argv[i], "--filtro") == 0 && valore) {
+            filtro = argv[++i];
+        } else if (strcmp(argv[i], "--formato") == 0 && valore) {
+            formato = argv[++i];
+        } else if (strcmp(argv[i], "--cpu") == 0 && valore) {
+            cpu = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tempo") == 0 && valore) {
+            opzioni.tempoMinimo = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--ripetizioni") == 0 && valore) {
+            opzioni.ripetizioni = std::max(1, atoi(argv[++i]));
+        } else {
+            fprintf(stderr, "Utilizzo: %s [--filtro testo] [--formato tabella|csv|json] [--cpu N] "
+                            "[--tempo secondi] [--ripetizioni R] [--elenco]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (strcmp(formato, "tabella") != 0 && strcmp(formato, "csv") != 0 && strcmp(formato, "json") != 0) {
+        fprintf(stderr, "Formato sconosciuto: %s (tabella, csv o json)\n", formato);
+        return 2;
+    }
+
+    if (cpu >= 0) {
+        cpu_set_t insieme;
+        CPU_ZERO(&insieme);
+        CPU_SET(cpu, &insieme);
+        if (sched_setaffinity(0, sizeof(insieme), &insieme) != 0) {
+            perror("sched_setaffinity");
+            return 1;
+        }
+    }
+
+    std::vector<RisultatoBench> risultati;
+    for (const VoceBench &v : registro()) {
+        if (strstr(v.nome, filtro) == nullptr) {
+            continue;
+        }
+        for (long n : v.dimensioni) {
+            StatoBench stato(v.nome, n, opzioni, risultati);
+            v.funzione(stato);
+            if (strcmp(formato, "tabella") == 0) {
+                // I risultati della tabella si vedono mentre i benchmark procedono
+                fprintf(stderr, "\r%-28s n=%-10ld", v.nome, n);
+            }
+        }
+    }
+    if (strcmp(formato, "tabella") == 0) {
+        fprintf(stderr, "\r%50s\r", "");
+        stampaTabella(risultati);
+    } else if (strcmp(formato, "csv") == 0) {
+        stampaCsv(risultati);
+    } else {
+        stampaJson(risultati, cpu);
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file bench.h
+ * @brief Piccolo framework di micro-benchmark per le funzioni degli esercizi
+ *
+ * Ogni benchmark e' una funzione che prepara i dati per una dimensione n
+ * (non misurata) e poi chiama s.misura() con l'operazione da misurare:
+ *
+ *   static void benchVetRand(StatoBench &s) {
+ *       std::vector<int> v(s.n);
+ *       s.misura([&] { vet_rand(v.data(), (int)s.n); usaValore(v[0]); }, s.n);
+ *   }
+ *   ...
+ *   registraBench("vet_rand", {16, 1024, 65536}, benchVetRand);
+ *
+ * misura() ripete l'operazione abbastanza volte da durare almeno
+ * tempoMinimo secondi (calibrazione), poi misura ripetizioni volte lo stesso
+ * numero di iterazioni e registra il tempo per operazione (mediana, minimo,
+ * massimo) e, se indicati gli elementi elaborati da ogni operazione, il tempo
+ * per elemento.
+ *
+ * Compilazione: vedi README.md (C++17).
+ */
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/**
+ * Opzioni della riga di comando che interessano la misura.
+ */
+struct OpzioniBench {
+    double tempoMinimo = 0.05;   // secondi per ripetizione
+    int ripetizioni = 5;
+};
+
+/**
+ * Risultato di un benchmark per una dimensione.
+ */
+struct RisultatoBench {
+    std::string nome;
+    long n;
+    uint64_t iterazioni;         // operazioni per ripetizione
+    int ripetizioni;
+    double nsMediana;            // nanosecondi per operazione
+    double nsMinimo;
+    double nsMassimo;
+    double elementi;             // elementi elaborati da ogni operazione
+};
+
+/**
+ * Impedisce al compilatore di eliminare il calcolo di un valore che non viene usato.
+ */
+template <typename T>
+inline void usaValore(const T &valore) {
+    asm volatile("" : : "r,m"(valore) : "memory");
+}
+
+class StatoBench {
+public:
+    StatoBench(const std::string &nome, long n, const OpzioniBench &opzioni, std::vector<RisultatoBench> &risultati)
+        : n(n), nome(nome), opzioni(opzioni), risultati(risultati) {}
+
+    /** La dimensione del problema (elementi del vettore, lato della matrice, ...) */
+    const long n;
+
+    /**
+     * Misura un'operazione.
+     * @param operazione la funzione (di solito una lambda) da misurare
+     * @param elementi quanti elementi elabora ogni operazione (per il tempo per elemento)
+     */
+    template <typename F>
+    void misura(F &&operazione, double elementi = 1.0) {
+        uint64_t iterazioni = 1;
+        for (;;) {
+            double t = cronometra(operazione, iterazioni);
+            if (t >= opzioni.tempoMinimo || iterazioni >= ((uint64_t)1 << 40)) {
+                break;
+            }
+            // Stima delle iterazioni necessarie, con margine; almeno il doppio, al massimo 100 volte tante
+            double stima = t > 0 ? opzioni.tempoMinimo / t * 1.2 * iterazioni : iterazioni * 100.0;
+            iterazioni = std::min(std::max((uint64_t)stima, iterazioni * 2), iterazioni * 100);
+        }
+        std::vector<double> tempi;
+        for (int r = 0; r < opzioni.ripetizioni; r++) {
+            tempi.push_back(cronometra(operazione, iterazioni) / iterazioni * 1e9);
+        }
+        std::sort(tempi.begin(), tempi.end());
+        risultati.push_back(RisultatoBench{nome, n, iterazioni, opzioni.ripetizioni, tempi[tempi.size() / 2],
+                                           tempi.front(), tempi.back(), elementi});
+    }
+
+private:
+    template <typename F>
+    static double cronometra(F &operazione, uint64_t iterazioni) {
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (uint64_t i = 0; i < iterazioni; i++) {
+            operazione();
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        return (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    }
+
+    std::string nome;
+    const OpzioniBench &opzioni;
+    std::vector<RisultatoBench> &risultati;
+};
+
+typedef void (*FunzioneBench)(StatoBench &s);
+
+/**
+ * Registra un benchmark, da eseguire per ognuna delle dimensioni.
+ */
+void registraBench(const char *nome, std::vector<long> dimensioni, FunzioneBench funzione);
+
+/**
+ * Finche' esiste, lo standard output va in /dev/null: per misurare le
+ * funzioni che stampano (vet_stampa, stampaMatrice) senza riempire il terminale.
+ */
+class SenzaStdout {
+public:
+    SenzaStdout();
+    ~SenzaStdout();
+    SenzaStdout(const SenzaStdout &) = delete;
+    SenzaStdout &operator=(const SenzaStdout &) = delete;
+
+private:
+    int salvato;
+};
+
+#endif // BENCH_H
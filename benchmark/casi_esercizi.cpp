@@ -0,0 +1,253 @@
+/**
+ * @file casi_esercizi.cpp
+ * @brief Benchmark delle funzioni degli esercizi, cosi' come sono nei file originali
+ *
+ * I file degli esercizi vengono inclusi direttamente, con il loro main()
+ * rinominato, in modo che si misuri proprio il codice degli studenti: ogni
+ * ottimizzazione successiva si puo' confrontare con questi valori di
+ * riferimento. Le funzioni che nei file originali non esistono come funzioni
+ * (il bubble sort e i due cicli del MCD sono scritti dentro il main, spara()
+ * e' solo da implementare) sono riportate in esercizi_estratti.h, con lo
+ * stesso codice e il file da cui vengono.
+ *
+ * Le funzioni che stampano (vet_stampa, singleNumber, stampaMatrice) vengono
+ * misurate con lo standard output rediretto su /dev/null.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "bench.h"
+#include "esercizi_estratti.h"
+
+// Funzioni dei vettori: vet_rand.cpp e' un file C++ (vet_rand_3 ha un prototipo diverso dalla definizione)
+// Rinominato, main() non ha piu' il return 0 implicito: il main originale non ha return
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreturn-type"
+#define main main_vet_rand
+#include "../F-Strutture_dati/vet/vet_rand.cpp"
+#undef main
+#pragma GCC diagnostic pop
+
+#define main main_trova_elemento_unico
+#include "../F-Strutture_dati/vet/trova_elemento_unico.c"
+#undef main
+
+#define main main_potenza
+#include "../E-Funzioni, concetti di base/ES01/potenza.c"
+#undef main
+
+#define main main_fatt
+#include "../E-Funzioni, concetti di base/ES01/fatt.c"
+#undef main
+
+#include "../E-Funzioni, concetti di base/ES01/fattoriale_veloce.h"
+#include "../E-Funzioni, concetti di base/ES01/potenza_veloce.h"
+
+// Le due versioni di modificaMatrice/stampaMatrice hanno lo stesso nome: ognuna nel suo namespace
+namespace appiattita {
+#define main main_example4
+#include "../F-Strutture_dati/ES03_Battaglia_navale/example4_flattened_array.c"
+#undef main
+#undef RIGHE
+#undef COLONNE
+}
+
+namespace puntatori {
+#define main main_example3
+#include "../F-Strutture_dati/ES03_Battaglia_navale/example3_pointer_to_pointer.c"
+#undef main
+}
+
+//----------------------------------------------------------------------
+// Benchmark
+//----------------------------------------------------------------------
+
+static const std::vector<long> DIMENSIONI_VETTORI = {16, 256, 4096, 65536, 1048576};
+
+static std::vector<int> vettoreCasuale(long n, int massimo) {
+    std::vector<int> v(n);
+    srand(1);
+    for (long i = 0; i < n; i++) {
+        v[i] = rand() % massimo;
+    }
+    return v;
+}
+
+static void benchVetRand(StatoBench &s) {
+    std::vector<int> v(s.n);
+    s.misura([&] { vet_rand(v.data(), (int)s.n); usaValore(v[0]); }, s.n);
+}
+
+static void benchVetRand2(StatoBench &s) {
+    std::vector<int> v(s.n);
+    s.misura([&] { vet_rand_2(v.data(), (int)s.n); usaValore(v[0]); }, s.n);
+}
+
+static void benchVetRand3(StatoBench &s) {
+    std::vector<int> v(s.n);
+    s.misura([&] { vet_rand_3(v.data(), (int)s.n, 33, 55); usaValore(v[0]); }, s.n);
+}
+
+static void benchVetStampa(StatoBench &s) {
+    std::vector<int> v = vettoreCasuale(s.n, 100);
+    SenzaStdout silenzio;
+    s.misura([&] { vet_stampa(v.data(), (int)s.n); }, s.n);
+}
+
+static void benchOrdinaBolle(StatoBench &s) {
+    std::vector<int> originale = vettoreCasuale(s.n, 1000000);
+    std::vector<int> v(s.n);
+    // La copia fa parte dell'operazione, ma costa O(n) contro O(n^2) dell'ordinamento
+    s.misura([&] {
+        memcpy(v.data(), originale.data(), s.n * sizeof(int));
+        ordinaBolle(v.data(), (int)s.n);
+        usaValore(v[0]);
+    }, s.n);
+}
+
+static void benchSingleNumber(StatoBench &s) {
+    std::vector<int> v = vettoreCasuale(s.n, 1000);
+    SenzaStdout silenzio;
+    s.misura([&] { usaValore(singleNumber(v.data(), (int)s.n)); }, s.n);
+}
+
+// Coppie di numeri tra 1 e n: il numero di passi del MCD dipende dalla grandezza dei numeri
+const int COPPIE_MCD = 1024;
+
+static std::vector<int> coppieMcd(long n) {
+    std::vector<int> v(2 * COPPIE_MCD);
+    srand(1);
+    for (int &x : v) {
+        x = (int)(((long long)rand() * RAND_MAX + rand()) % n) + 1;
+    }
+    return v;
+}
+
+static void benchMcdEuclide(StatoBench &s) {
+    std::vector<int> v = coppieMcd(s.n);
+    s.misura([&] {
+        int somma = 0;
+        for (int i = 0; i < COPPIE_MCD; i++) {
+            somma += mcdEuclide(v[2 * i], v[2 * i + 1]);
+        }
+        usaValore(somma);
+    }, COPPIE_MCD);
+}
+
+static void benchMcdSottrazioni(StatoBench &s) {
+    std::vector<int> v = coppieMcd(s.n);
+    s.misura([&] {
+        int somma = 0;
+        for (int i = 0; i < COPPIE_MCD; i++) {
+            somma += mcdSottrazioni(v[2 * i], v[2 * i + 1]);
+        }
+        usaValore(somma);
+    }, COPPIE_MCD);
+}
+
+// Per la potenza n e' l'esponente; la base e' 1 o -1 per non andare in overflow (comportamento indefinito)
+static void benchPotenza(StatoBench &s) {
+    int base = -1;
+    s.misura([&] {
+        usaValore(base);
+        usaValore(potenza(base, (int)s.n));
+    });
+}
+
+static void benchPotenzaVeloce(StatoBench &s) {
+    int64_t base = -1;
+    s.misura([&] {
+        usaValore(base);
+        usaValore(potenzaVeloce(base, (unsigned)s.n));
+    });
+}
+
+static void benchFattoriale(StatoBench &s) {
+    int n = (int)s.n;
+    s.misura([&] {
+        usaValore(n);
+        usaValore(fattoriale(n));
+    });
+}
+
+static void benchFattoriale64(StatoBench &s) {
+    unsigned n = (unsigned)s.n;
+    s.misura([&] {
+        usaValore(n);
+        usaValore(fattoriale64(n));
+    });
+}
+
+// Per le matrici n e' il lato: n x n elementi
+static void benchModificaMatriceAppiattita(StatoBench &s) {
+    std::vector<int> m(s.n * s.n, 1);
+    s.misura([&] {
+        appiattita::modificaMatrice(m.data(), (int)s.n, (int)s.n);
+        usaValore(m[0]);
+    }, (double)s.n * s.n);
+}
+
+static void benchModificaMatricePuntatori(StatoBench &s) {
+    std::vector<int> dati(s.n * s.n, 1);
+    std::vector<int *> righe(s.n);
+    for (long i = 0; i < s.n; i++) {
+        righe[i] = &dati[i * s.n];
+    }
+    s.misura([&] {
+        puntatori::modificaMatrice(righe.data(), (int)s.n, (int)s.n);
+        usaValore(dati[0]);
+    }, (double)s.n * s.n);
+}
+
+static void benchStampaMatrice(StatoBench &s) {
+    std::vector<int> m = vettoreCasuale(s.n * s.n, 1000);
+    SenzaStdout silenzio;
+    s.misura([&] { appiattita::stampaMatrice(m.data(), (int)s.n, (int)s.n); }, (double)s.n * s.n);
+}
+
+// Per spara n e' il numero di colpi su un campo 5x5 con una nave, coordinate anche fuori dal campo
+static void benchSpara(StatoBench &s) {
+    char iniziale[DIMENSIONE][DIMENSIONE];
+    memset(iniziale, '~', sizeof(iniziale));
+    for (int k = 0; k < LUNGHEZZA_NAVE; k++) {
+        iniziale[2][1 + k] = '#';
+    }
+    std::vector<int> colpi(2 * s.n);
+    srand(1);
+    for (int &c : colpi) {
+        c = rand() % (DIMENSIONE + 2) - 1;
+    }
+    char campo[DIMENSIONE][DIMENSIONE];
+    s.misura([&] {
+        memcpy(campo, iniziale, sizeof(campo));
+        int colpiti = 0;
+        for (long i = 0; i < s.n; i++) {
+            colpiti += spara(campo, colpi[2 * i], colpi[2 * i + 1]);
+        }
+        usaValore(colpiti);
+    }, s.n);
+}
+
+// Registrazione all'avvio del programma
+static const bool REGISTRATI = [] {
+    registraBench("vet_rand", DIMENSIONI_VETTORI, benchVetRand);
+    registraBench("vet_rand_2", DIMENSIONI_VETTORI, benchVetRand2);
+    registraBench("vet_rand_3", DIMENSIONI_VETTORI, benchVetRand3);
+    registraBench("vet_stampa", {16, 256, 4096, 65536}, benchVetStampa);
+    registraBench("bubble_sort", {16, 64, 256, 1024, 4096}, benchOrdinaBolle);
+    registraBench("singleNumber", {16, 256, 4096, 65536}, benchSingleNumber);
+    registraBench("mcd_euclide", {100, 10000, 1000000, 1000000000}, benchMcdEuclide);
+    registraBench("mcd_sottrazioni", {100, 1000, 10000, 100000}, benchMcdSottrazioni);
+    registraBench("potenza", {4, 16, 256, 4096, 65536}, benchPotenza);
+    registraBench("potenzaVeloce", {4, 16, 256, 4096, 65536}, benchPotenzaVeloce);
+    registraBench("fattoriale", {5, 20, 100, 170}, benchFattoriale);
+    registraBench("fattoriale64", {5, 20}, benchFattoriale64);
+    registraBench("modificaMatrice_appiattita", {4, 64, 512, 2048}, benchModificaMatriceAppiattita);
+    registraBench("modificaMatrice_puntatori", {4, 64, 512, 2048}, benchModificaMatricePuntatori);
+    registraBench("stampaMatrice", {4, 64, 256}, benchStampaMatrice);
+    registraBench("spara", {25, 1000, 100000}, benchSpara);
+    return true;
+}();
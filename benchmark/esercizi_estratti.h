@@ -0,0 +1,79 @@
+/**
+ * @file esercizi_estratti.h
+ * @brief Funzioni che negli esercizi sono scritte dentro il main o solo dichiarate
+ *
+ * Il bubble sort e i due cicli del MCD sono copiati dai main degli esercizi
+ * senza modifiche; spara() e' un'implementazione di riferimento. Usate dai
+ * benchmark (casi_esercizi.cpp) e dall'esempio di strumentazione.
+ */
+#ifndef ESERCIZI_ESTRATTI_H
+#define ESERCIZI_ESTRATTI_H
+
+/**
+ * Il bubble sort di F-Strutture_dati/vet/source_040314_bsort_c.c, per n elementi invece di 5.
+ */
+inline void ordinaBolle(int numbers[], int n) {
+    int i, aux;
+    int swapped;
+    do {
+        swapped = 0;
+        for (i = 0; i < n - 1; i++)
+            if (numbers[i] > numbers[i + 1]) {
+                swapped = 1;
+                aux = numbers[i];
+                numbers[i] = numbers[i + 1];
+                numbers[i + 1] = aux;
+            }
+    } while (swapped);
+}
+
+/**
+ * Il ciclo di D-Istruzioni_decisionali_e_iterative/ES02-Cicli_e_iterazioni/MCD.c (algoritmo di Euclide).
+ */
+inline int mcdEuclide(int num1, int num2) {
+    int resto;
+    while (num2 != 0) {
+        resto = num1 % num2;
+        num1 = num2;
+        num2 = resto;
+    }
+    return num1;
+}
+
+/**
+ * Il ciclo di D-Istruzioni_decisionali_e_iterative/ES02-Cicli_e_iterazioni/MCD2.c (sottrazioni successive).
+ */
+inline int mcdSottrazioni(int a, int b) {
+    while (a != b) {
+        if (a > b) {
+            a = a - b;
+        } else {
+            b = b - a;
+        }
+    }
+    return a;
+}
+
+// Battaglia navale: in es_battaglia_navale_step3-5.c spara() e' solo dichiarata, questa e'
+// un'implementazione di riferimento che rispetta il contratto della documentazione
+#define DIMENSIONE 5
+#define LUNGHEZZA_NAVE 3
+
+/**
+ * @return 1 se il colpo e' andato a segno, 0 se e' acqua, -1 se le coordinate non sono valide
+ */
+inline int spara(char campo[DIMENSIONE][DIMENSIONE], int riga, int colonna) {
+    if (riga < 0 || riga >= DIMENSIONE || colonna < 0 || colonna >= DIMENSIONE) {
+        return -1;
+    }
+    if (campo[riga][colonna] == '#') {
+        campo[riga][colonna] = 'X';
+        return 1;
+    }
+    if (campo[riga][colonna] == '~') {
+        campo[riga][colonna] = 'O';
+    }
+    return 0;
+}
+
+#endif // ESERCIZI_ESTRATTI_H
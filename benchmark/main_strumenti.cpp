@@ -0,0 +1,122 @@
+/**
+ * @file main_strumenti.cpp
+ * @brief Esempio di strumentazione: regioni attorno alle funzioni degli esercizi
+ *
+ * Le funzioni degli esercizi (modificaMatrice, l'ordinamento di una riga,
+ * la media della finestra di temperature nella versione per PC, spara)
+ * vengono chiamate attraverso funzioni con STRUMENTI_REGIONE, da due thread.
+ * Alla fine stampa il riepilogo delle regioni e scrive la traccia.
+ *
+ * Compilazione con la strumentazione:
+ *   g++ -O2 -std=c++17 -pthread -DSTRUMENTI_ATTIVI -I ../F-Strutture_dati/ES99_Temperature_sensor \
+ *       main_strumenti.cpp strumenti.cpp ../F-Strutture_dati/ES99_Temperature_sensor/statistiche_finestra.cpp \
+ *       -o main_strumenti
+ * Senza -DSTRUMENTI_ATTIVI le regioni non generano codice.
+ * Utilizzo:
+ *   ./main_strumenti [-c] [traccia.json]     (-c: contatori hardware, se il sistema li permette)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "esercizi_estratti.h"
+#include "statistiche_finestra.h"
+#include "strumenti.h"
+
+#define main main_example4
+#include "../F-Strutture_dati/ES03_Battaglia_navale/example4_flattened_array.c"
+#undef main
+
+const int LATO = 256;
+const int FINESTRA = 100;
+const int RIPETIZIONI = 200;
+
+// Ordina una riga della matrice (la funzione ordina di F-Strutture_dati/matrici/es_matrici.c)
+static void ordina(int *matrice, int colonne, int riga) {
+    STRUMENTI_REGIONE("ordina");
+    ordinaBolle(&matrice[riga * colonne], colonne);
+}
+
+static void modificaMatriceMisurata(int *matrice, int righe, int colonne) {
+    STRUMENTI_REGIONE("modificaMatrice");
+    modificaMatrice(matrice, righe, colonne);
+}
+
+// Come calcolaTemperaturaMedia() di temperature_sensor_v2.ino, con l'aggiunta della lettura
+static float calcolaTemperaturaMedia(StatisticheFinestra *statistiche, float temperatura) {
+    STRUMENTI_REGIONE("calcolaTemperaturaMedia");
+    statisticheAggiungi(statistiche, temperatura);
+    return statisticheMedia(statistiche);
+}
+
+static int partita(unsigned seme) {
+    STRUMENTI_REGIONE("partita");
+    char campo[DIMENSIONE][DIMENSIONE];
+    memset(campo, '~', sizeof(campo));
+    for (int k = 0; k < LUNGHEZZA_NAVE; k++) {
+        campo[1][k + 1] = '#';
+    }
+    int colpiti = 0;
+    int colpi = 0;
+    while (colpiti < LUNGHEZZA_NAVE) {
+        STRUMENTI_REGIONE("spara");
+        colpiti += spara(campo, rand_r(&seme) % DIMENSIONE, rand_r(&seme) % DIMENSIONE) == 1;
+        colpi++;
+    }
+    return colpi;
+}
+
+static void lavoro(int numero) {
+    unsigned seme = numero + 1;
+    std::vector<int> matrice(LATO * LATO);
+    for (int &x : matrice) {
+        x = rand_r(&seme) % 1000;
+    }
+    float valori[FINESTRA];
+    uint16_t codaMin[FINESTRA];
+    uint16_t codaMax[FINESTRA];
+    StatisticheFinestra statistiche;
+    statisticheInizializza(&statistiche, valori, codaMin, codaMax, FINESTRA);
+
+    float media = 0;
+    long colpi = 0;
+    for (int r = 0; r < RIPETIZIONI; r++) {
+        modificaMatriceMisurata(matrice.data(), LATO, LATO);
+        ordina(matrice.data(), LATO, r % LATO);
+        for (int i = 0; i < 50; i++) {
+            media = calcolaTemperaturaMedia(&statistiche, 20.0f + (rand_r(&seme) % 100) / 16.0f);
+        }
+        colpi += partita(seme++);
+    }
+    printf("thread %d: media %.3f, %.1f colpi per partita\n", numero, media, (double)colpi / RIPETIZIONI);
+}
+
+int main(int argc, char *argv[]) {
+    int opzioni = STRUMENTI_TEMPI;
+    const char *traccia = "traccia.json";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0) {
+            opzioni = STRUMENTI_CONTATORI;
+        } else {
+            traccia = argv[i];
+        }
+    }
+    strumentiInizia(opzioni, 1 << 20);
+
+    std::thread altro(lavoro, 1);
+    lavoro(0);
+    altro.join();
+
+    strumentiStampaRiepilogo(stdout);
+    if (!strumentiScriviTraccia(traccia)) {
+        perror(traccia);
+        return 1;
+    }
+#ifdef STRUMENTI_ATTIVI
+    printf("traccia scritta in %s (chrome://tracing o ui.perfetto.dev)\n", traccia);
+#endif
+    strumentiTermina();
+    return 0;
+}
@@ -0,0 +1,299 @@
+/**
+ * @file strumenti.cpp
+ * @brief Statistiche delle regioni, contatori perf_event_open e scrittura della traccia
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // syscall
+#endif
+#include "strumenti.h"
+
+#ifdef STRUMENTI_ATTIVI
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+// Una chiamata registrata per la traccia
+struct EventoStrumenti {
+    const RegioneStrumenti *regione;
+    uint64_t inizio;
+    uint64_t durata;
+    uint32_t thread;
+};
+
+static std::atomic<RegioneStrumenti *> primaRegione{nullptr};
+static int opzioniAttive = STRUMENTI_TEMPI;
+static EventoStrumenti *eventi = nullptr;
+static size_t eventiMassimi = 0;
+static std::atomic<size_t> eventiScritti{0};
+// Riferimento per convertire i tick in nanosecondi
+static uint64_t tickInizio = 0;
+static uint64_t nsInizio = 0;
+
+static uint64_t nanosecondi() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+RegioneStrumenti::RegioneStrumenti(const char *nome) : nome(nome) {
+    // Inserimento in testa all'elenco senza lock: le regioni statiche vengono costruite
+    // alla prima chiamata, anche da thread diversi
+    successiva = primaRegione.load(std::memory_order_relaxed);
+    while (!primaRegione.compare_exchange_weak(successiva, this, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+    }
+}
+
+static uint32_t threadCorrente() {
+#ifdef __linux__
+    static thread_local uint32_t id = (uint32_t)syscall(SYS_gettid);
+#else
+    static std::atomic<uint32_t> prossimo{1};
+    static thread_local uint32_t id = prossimo.fetch_add(1);
+#endif
+    return id;
+}
+
+//----------------------------------------------------------------------
+// Contatori hardware
+//----------------------------------------------------------------------
+
+#ifdef __linux__
+
+// Gruppo di contatori di un thread: il primo e' il capogruppo, letti tutti con una read()
+struct ContatoriThread {
+    int fd[CONTATORI_STRUMENTI] = {-1, -1, -1, -1};
+    bool provato = false;
+    bool disponibili = false;
+
+    ~ContatoriThread() { chiudi(); }
+
+    void chiudi() {
+        for (int &f : fd) {
+            if (f >= 0) {
+                close(f);
+            }
+            f = -1;
+        }
+        provato = false;
+        disponibili = false;
+    }
+};
+
+static thread_local ContatoriThread contatoriThread;
+
+static int apriContatore(uint64_t configurazione, int capogruppo) {
+    struct perf_event_attr attributi;
+    memset(&attributi, 0, sizeof(attributi));
+    attributi.size = sizeof(attributi);
+    attributi.type = PERF_TYPE_HARDWARE;
+    attributi.config = configurazione;
+    attributi.disabled = capogruppo < 0 ? 1 : 0;
+    attributi.exclude_kernel = 1;
+    attributi.exclude_hv = 1;
+    attributi.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(SYS_perf_event_open, &attributi, 0, -1, capogruppo, 0);
+}
+
+static bool apriContatori(ContatoriThread &c) {
+    static const uint64_t CONFIGURAZIONI[CONTATORI_STRUMENTI] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < CONTATORI_STRUMENTI; i++) {
+        c.fd[i] = apriContatore(CONFIGURAZIONI[i], i == 0 ? -1 : c.fd[0]);
+        if (c.fd[i] < 0) {
+            return false;
+        }
+    }
+    ioctl(c.fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(c.fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+}
+
+bool strumentiLeggiContatori(uint64_t valori[CONTATORI_STRUMENTI]) {
+    if (!(opzioniAttive & STRUMENTI_CONTATORI)) {
+        return false;
+    }
+    ContatoriThread &c = contatoriThread;
+    if (!c.provato) {
+        c.provato = true;
+        c.disponibili = apriContatori(c);
+    }
+    if (!c.disponibili) {
+        return false;
+    }
+    // Formato di PERF_FORMAT_GROUP: numero di contatori, poi i valori
+    uint64_t letti[1 + CONTATORI_STRUMENTI];
+    if (read(c.fd[0], letti, sizeof(letti)) != (ssize_t)sizeof(letti)) {
+        return false;
+    }
+    memcpy(valori, letti + 1, sizeof(uint64_t) * CONTATORI_STRUMENTI);
+    return true;
+}
+
+#else
+
+bool strumentiLeggiContatori(uint64_t valori[CONTATORI_STRUMENTI]) {
+    (void)valori;
+    return false;
+}
+
+#endif // __linux__
+
+//----------------------------------------------------------------------
+// Registrazione delle chiamate
+//----------------------------------------------------------------------
+
+void strumentiRegistra(RegioneStrumenti &regione, uint64_t inizio, uint64_t fine, const uint64_t *contatoriInizio) {
+    // Contatori letti per primi, per non contare il lavoro di questa funzione
+    uint64_t contatoriFine[CONTATORI_STRUMENTI];
+    bool contati = contatoriInizio != nullptr && strumentiLeggiContatori(contatoriFine);
+    uint64_t durata = fine - inizio;
+    regione.chiamate.fetch_add(1, std::memory_order_relaxed);
+    regione.tick.fetch_add(durata, std::memory_order_relaxed);
+    uint64_t minimo = regione.tickMinimo.load(std::memory_order_relaxed);
+    while (durata < minimo &&
+           !regione.tickMinimo.compare_exchange_weak(minimo, durata, std::memory_order_relaxed)) {
+    }
+    uint64_t massimo = regione.tickMassimo.load(std::memory_order_relaxed);
+    while (durata > massimo &&
+           !regione.tickMassimo.compare_exchange_weak(massimo, durata, std::memory_order_relaxed)) {
+    }
+
+    if (contati) {
+        regione.chiamateContate.fetch_add(1, std::memory_order_relaxed);
+        for (int i = 0; i < CONTATORI_STRUMENTI; i++) {
+            regione.contatori[i].fetch_add(contatoriFine[i] - contatoriInizio[i], std::memory_order_relaxed);
+        }
+    }
+
+    if (eventiMassimi > 0) {
+        size_t posizione = eventiScritti.fetch_add(1, std::memory_order_relaxed);
+        if (posizione < eventiMassimi) {
+            eventi[posizione] = EventoStrumenti{&regione, inizio, durata, threadCorrente()};
+        }
+    }
+}
+
+void strumentiInizia(int opzioni, size_t massimi) {
+    opzioniAttive = opzioni;
+    delete[] eventi;
+    eventi = massimi > 0 ? new EventoStrumenti[massimi] : nullptr;
+    eventiMassimi = massimi;
+    eventiScritti.store(0);
+    nsInizio = nanosecondi();
+    tickInizio = strumentiTick();
+}
+
+void strumentiTermina() {
+    delete[] eventi;
+    eventi = nullptr;
+    eventiMassimi = 0;
+#ifdef __linux__
+    contatoriThread.chiudi();
+#endif
+}
+
+//----------------------------------------------------------------------
+// Risultati
+//----------------------------------------------------------------------
+
+// Nanosecondi per tick, misurati tra strumentiInizia() e adesso
+static double nsPerTick() {
+#ifdef STRUMENTI_TSC
+    uint64_t ns = nanosecondi();
+    uint64_t tick = strumentiTick();
+    if (tick <= tickInizio || ns - nsInizio < 1000000) {
+        // Meno di un millisecondo dall'inizio: si aspetta per avere una stima decente
+        struct timespec attesa = {0, 10000000};
+        nanosleep(&attesa, nullptr);
+        ns = nanosecondi();
+        tick = strumentiTick();
+    }
+    return (double)(ns - nsInizio) / (double)(tick - tickInizio);
+#else
+    return 1.0;
+#endif
+}
+
+void strumentiStampaRiepilogo(FILE *uscita) {
+    std::vector<RegioneStrumenti *> regioni;
+    for (RegioneStrumenti *r = primaRegione.load(std::memory_order_acquire); r != nullptr; r = r->successiva) {
+        if (r->chiamate.load() > 0) {
+            regioni.push_back(r);
+        }
+    }
+    std::sort(regioni.begin(), regioni.end(),
+              [](const RegioneStrumenti *a, const RegioneStrumenti *b) { return a->tick.load() > b->tick.load(); });
+
+    double scala = nsPerTick();
+    fprintf(uscita, "%-24s %10s %12s %11s %11s %11s %8s %9s %9s\n", "regione", "chiamate", "totale ms", "media ns",
+            "minimo ns", "massimo ns", "IPC", "miss/op", "salti/op");
+    for (const RegioneStrumenti *r : regioni) {
+        uint64_t chiamate = r->chiamate.load();
+        fprintf(uscita, "%-24s %10llu %12.3f %11.1f %11.1f %11.1f", r->nome, (unsigned long long)chiamate,
+                r->tick.load() * scala * 1e-6, (double)r->tick.load() / chiamate * scala,
+                r->tickMinimo.load() * scala, r->tickMassimo.load() * scala);
+        uint64_t contate = r->chiamateContate.load();
+        if (contate > 0 && r->contatori[CONTATORE_CICLI].load() > 0) {
+            fprintf(uscita, " %8.2f %9.1f %9.1f\n",
+                    (double)r->contatori[CONTATORE_ISTRUZIONI].load() / r->contatori[CONTATORE_CICLI].load(),
+                    (double)r->contatori[CONTATORE_CACHE_MISS].load() / contate,
+                    (double)r->contatori[CONTATORE_SALTI_SBAGLIATI].load() / contate);
+        } else {
+            fprintf(uscita, " %8s %9s %9s\n", "-", "-", "-");
+        }
+    }
+    size_t scritti = eventiScritti.load();
+    if (scritti > eventiMassimi && eventiMassimi > 0) {
+        fprintf(uscita, "traccia: %zu eventi su %zu non registrati (aumentare eventiMassimi)\n",
+                scritti - eventiMassimi, scritti);
+    }
+}
+
+// Scrive il nome di una regione come stringa JSON
+static void scriviNomeJson(FILE *f, const char *nome) {
+    fputc('"', f);
+    for (const char *p = nome; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            fputc('\\', f);
+        }
+        if ((unsigned char)*p >= 0x20) {
+            fputc(*p, f);
+        }
+    }
+    fputc('"', f);
+}
+
+bool strumentiScriviTraccia(const char *percorso) {
+    FILE *f = fopen(percorso, "w");
+    if (f == nullptr) {
+        return false;
+    }
+    double scala = nsPerTick();
+    size_t n = std::min(eventiScritti.load(), eventiMassimi);
+    uint32_t processo = (uint32_t)getpid();
+    // Eventi completi ("ph": "X"), tempi in microsecondi dall'inizio
+    fprintf(f, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    for (size_t i = 0; i < n; i++) {
+        const EventoStrumenti &e = eventi[i];
+        fprintf(f, "{\"name\": ");
+        scriviNomeJson(f, e.regione->nome);
+        fprintf(f, ", \"ph\": \"X\", \"pid\": %u, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}%s\n", processo, e.thread,
+                (double)(int64_t)(e.inizio - tickInizio) * scala * 1e-3, e.durata * scala * 1e-3,
+                i + 1 < n ? "," : "");
+    }
+    fprintf(f, "]}\n");
+    return fclose(f) == 0;
+}
+
+#endif // STRUMENTI_ATTIVI